@@ -0,0 +1,586 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    rrlib/time/batch_conversion.cpp
+ *
+ * \author  agent
+ *
+ * \date    2026-10-18
+ *
+ */
+//----------------------------------------------------------------------
+#include "rrlib/time/batch_conversion.h"
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <limits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define RRLIB_TIME_X86_SIMD
+#include <immintrin.h>
+#endif
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/time/calendar.h"
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+#include <cassert>
+
+//----------------------------------------------------------------------
+// Namespace usage
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace time
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+/*! Instruction set used for batch conversion */
+enum class tSimdLevel
+{
+  NONE,
+  SSE41,
+  AVX2
+};
+
+//----------------------------------------------------------------------
+// Const values
+//----------------------------------------------------------------------
+
+/*! Two-digit strings "00" to "99" */
+static const char cDIGIT_PAIRS[201] =
+  "00010203040506070809101112131415161718192021222324252627282930313233343536373839404142434445464748495051525354555657585960616263646566676869"
+  "707172737475767778798081828384858687888990919293949596979899";
+
+/*! Powers of ten for scaling fractional seconds */
+static const int64_t cPOWERS_OF_TEN[10] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000 };
+
+//----------------------------------------------------------------------
+// Implementation
+//----------------------------------------------------------------------
+
+namespace
+{
+
+/*! Record access for arrays of std::string */
+struct tStringArrayRecords
+{
+  const std::string* strings;
+
+  const char* Data(size_t index) const
+  {
+    return strings[index].data();
+  }
+  size_t Length(size_t index) const
+  {
+    return strings[index].length();
+  }
+};
+
+/*!
+ * Local time zone information for formatting timestamps.
+ * Offset is valid for all seconds in [valid_from, valid_to].
+ */
+struct tLocalTimeZoneCache
+{
+  int64_t valid_from, valid_to;
+  int64_t offset;
+  char suffix[6];   // "+HH:MM"
+
+  /*! Current day (days since 1970-01-01 in local time) and its rendered "YYYY-MM-DDT" */
+  int64_t day;
+  char date[11];
+
+  tLocalTimeZoneCache() : valid_from(1), valid_to(0), offset(0), day(std::numeric_limits<int64_t>::min())
+  {
+    memset(suffix, 0, sizeof(suffix));
+    memset(date, 0, sizeof(date));
+  }
+};
+
+/*! Record access for buffers with fixed stride */
+struct tStrideRecords
+{
+  const char* buffer;
+  size_t stride;
+
+  const char* Data(size_t index) const
+  {
+    return buffer + index * stride;
+  }
+  size_t Length(size_t index) const
+  {
+    const char* data = Data(index);
+    size_t length = stride;
+    while (length > 0)
+    {
+      char c = data[length - 1];
+      if (c != ' ' && c != '\n' && c != '\r' && c != '\t' && c != ',' && c != ';' && c != 0)
+      {
+        break;
+      }
+      length--;
+    }
+    return length;
+  }
+};
+
+}
+
+/*! \return SIMD instruction set to use on this CPU */
+static tSimdLevel GetSimdLevel()
+{
+#ifdef RRLIB_TIME_X86_SIMD
+  static const tSimdLevel level = __builtin_cpu_supports("avx2") ? tSimdLevel::AVX2 : (__builtin_cpu_supports("sse4.1") ? tSimdLevel::SSE41 : tSimdLevel::NONE);
+  return level;
+#else
+  return tSimdLevel::NONE;
+#endif
+}
+
+/*! Parses string with scalar parser - sets result to cNO_TIME on failure */
+static inline bool ParseScalar(const char* string, size_t length, tTimestamp& result)
+{
+  if (TryParseIsoTimestamp(string, length, result))
+  {
+    return true;
+  }
+  result = cNO_TIME;
+  return false;
+}
+
+/*!
+ * Parses remainder of string with fixed layout - following "YYYY-MM-DDTHH:MM" that has already been converted.
+ * Remainder must be ":SS[.fraction](Z|+HH:MM)" - with up to nine digits in fraction.
+ *
+ * \param fields Values of year, year (lower two digits), month, day, hour and minute
+ * \return True if remainder has fixed layout and all values are in range (otherwise, string should be parsed by scalar parser)
+ */
+static inline bool ParseFixedLayoutTail(const char* string, size_t length, const uint16_t* fields, tTimestamp& result)
+{
+  if (length < 20 || string[16] != ':')
+  {
+    return false;
+  }
+  unsigned int second_high = static_cast<unsigned char>(string[17]) - '0';
+  unsigned int second_low = static_cast<unsigned char>(string[18]) - '0';
+  if (second_high > 9 || second_low > 9)
+  {
+    return false;
+  }
+
+  size_t position = 19;
+  int64_t nanoseconds = 0;
+  if (string[position] == '.')
+  {
+    position++;
+    size_t fraction_start = position;
+    int64_t fraction = 0;
+    for (; position < length && position < fraction_start + 10; position++)
+    {
+      unsigned int digit = static_cast<unsigned char>(string[position]) - '0';
+      if (digit > 9)
+      {
+        break;
+      }
+      fraction = fraction * 10 + digit;
+    }
+    size_t digits = position - fraction_start;
+    if (digits == 0 || digits > 9)
+    {
+      return false;
+    }
+    nanoseconds = fraction * cPOWERS_OF_TEN[9 - digits];
+  }
+
+  int offset_seconds = 0;
+  size_t zone_length = length - position;
+  if (zone_length == 6 && (string[position] == '+' || string[position] == '-') && string[position + 3] == ':')
+  {
+    unsigned int digits[4] = { static_cast<unsigned int>(static_cast<unsigned char>(string[position + 1]) - '0'), static_cast<unsigned int>(static_cast<unsigned char>(string[position + 2]) - '0'),
+                               static_cast<unsigned int>(static_cast<unsigned char>(string[position + 4]) - '0'), static_cast<unsigned int>(static_cast<unsigned char>(string[position + 5]) - '0')
+                             };
+    if (digits[0] > 9 || digits[1] > 9 || digits[2] > 9 || digits[3] > 9)
+    {
+      return false;
+    }
+    unsigned int offset_hours = digits[0] * 10 + digits[1];
+    unsigned int offset_minutes = digits[2] * 10 + digits[3];
+    if (offset_hours > 23 || offset_minutes > 59)
+    {
+      return false;
+    }
+    offset_seconds = (string[position] == '-' ? -1 : 1) * static_cast<int>(offset_hours * 3600 + offset_minutes * 60);
+  }
+  else if (!(zone_length == 1 && string[position] == 'Z'))
+  {
+    return false;
+  }
+
+  // Range checks (years close to the limits of tTimestamp are left to scalar parser)
+  unsigned int year = fields[0] * 100u + fields[1];
+  unsigned int month = fields[2], day = fields[3], hour = fields[4], minute = fields[5], second = second_high * 10 + second_low;
+  if (year < 1700 || year > 2200 || month < 1 || month > 12 || day < 1 || day > DaysInMonth(year, month) || hour > 23 || minute > 59 || second > 60)
+  {
+    return false;
+  }
+
+  int64_t seconds = DaysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second - offset_seconds;
+  result = tTimestamp(std::chrono::duration_cast<tDuration>(std::chrono::nanoseconds(seconds * 1000000000 + nanoseconds)));
+  return true;
+}
+
+#ifdef RRLIB_TIME_X86_SIMD
+
+/*!
+ * Validates and converts "YYYY-MM-DDTHH:MM" at the start of a string (SSE4.1)
+ *
+ * \param string String (at least 16 bytes must be readable)
+ * \param fields Array that values of year (upper two digits), year (lower two digits), month, day, hour and minute are written to
+ * \return True if string starts with expected layout
+ */
+__attribute__((target("sse4.1")))
+static inline bool ConvertFixedLayoutPrefix(const char* string, uint16_t* fields)
+{
+  const __m128i cTEMPLATE = _mm_setr_epi8('0', '0', '0', '0', '-', '0', '0', '-', '0', '0', 'T', '0', '0', ':', '0', '0');
+  const __m128i cSEPARATOR_MASK = _mm_setr_epi8(0, 0, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0);
+  const __m128i cDIGIT_SHUFFLE = _mm_setr_epi8(0, 1, 2, 3, 5, 6, 8, 9, 11, 12, 14, 15, -1, -1, -1, -1);
+  const __m128i cWEIGHTS = _mm_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 0, 0, 0, 0);
+
+  __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(string));
+  __m128i digits = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+  __m128i digit_ok = _mm_cmpeq_epi8(_mm_max_epu8(digits, _mm_set1_epi8(9)), _mm_set1_epi8(9));
+  __m128i separator_ok = _mm_cmpeq_epi8(chars, cTEMPLATE);
+  if (_mm_movemask_epi8(_mm_blendv_epi8(digit_ok, separator_ok, cSEPARATOR_MASK)) != 0xFFFF)
+  {
+    return false;
+  }
+  __m128i pairs = _mm_maddubs_epi16(_mm_shuffle_epi8(digits, cDIGIT_SHUFFLE), cWEIGHTS);
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(fields), pairs);
+  return true;
+}
+
+/*!
+ * Validates and converts "YYYY-MM-DDTHH:MM" at the start of two strings (AVX2)
+ *
+ * \param string1 First string (at least 16 bytes must be readable)
+ * \param string2 Second string (at least 16 bytes must be readable)
+ * \param fields Array that values are written to (fields of first string at index 0, fields of second string at index 8)
+ * \return Bit 0 is set if first string has expected layout - bit 1 is set if second string has expected layout
+ */
+__attribute__((target("avx2")))
+static inline int ConvertFixedLayoutPrefixes(const char* string1, const char* string2, uint16_t* fields)
+{
+  const __m256i cTEMPLATE = _mm256_setr_epi8('0', '0', '0', '0', '-', '0', '0', '-', '0', '0', 'T', '0', '0', ':', '0', '0', '0', '0', '0', '0', '-', '0', '0', '-', '0', '0', 'T', '0', '0', ':', '0', '0');
+  const __m256i cSEPARATOR_MASK = _mm256_setr_epi8(0, 0, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, 0, 0, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0);
+  const __m256i cDIGIT_SHUFFLE = _mm256_setr_epi8(0, 1, 2, 3, 5, 6, 8, 9, 11, 12, 14, 15, -1, -1, -1, -1, 0, 1, 2, 3, 5, 6, 8, 9, 11, 12, 14, 15, -1, -1, -1, -1);
+  const __m256i cWEIGHTS = _mm256_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 0, 0, 0, 0, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 0, 0, 0, 0);
+
+  __m256i chars = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(string1))), _mm_loadu_si128(reinterpret_cast<const __m128i*>(string2)), 1);
+  __m256i digits = _mm256_sub_epi8(chars, _mm256_set1_epi8('0'));
+  __m256i digit_ok = _mm256_cmpeq_epi8(_mm256_max_epu8(digits, _mm256_set1_epi8(9)), _mm256_set1_epi8(9));
+  __m256i separator_ok = _mm256_cmpeq_epi8(chars, cTEMPLATE);
+  unsigned int ok_mask = static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_blendv_epi8(digit_ok, separator_ok, cSEPARATOR_MASK)));
+  __m256i pairs = _mm256_maddubs_epi16(_mm256_shuffle_epi8(digits, cDIGIT_SHUFFLE), cWEIGHTS);
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(fields), pairs);
+  return ((ok_mask & 0xFFFF) == 0xFFFF ? 1 : 0) | ((ok_mask >> 16) == 0xFFFF ? 2 : 0);
+}
+
+/*! Parses single string - using SSE4.1 for strings with fixed layout */
+__attribute__((target("sse4.1")))
+static inline bool ParseSse41(const char* string, size_t length, tTimestamp& result)
+{
+  uint16_t fields[8];
+  if (length >= 20 && ConvertFixedLayoutPrefix(string, fields) && ParseFixedLayoutTail(string, length, fields, result))
+  {
+    return true;
+  }
+  return ParseScalar(string, length, result);
+}
+
+template <typename TRecords>
+__attribute__((target("sse4.1")))
+static size_t ParseIsoTimestampsSse41(const TRecords& records, size_t count, tTimestamp* result)
+{
+  size_t parsed = 0;
+  for (size_t i = 0; i < count; i++)
+  {
+    parsed += ParseSse41(records.Data(i), records.Length(i), result[i]) ? 1 : 0;
+  }
+  return parsed;
+}
+
+template <typename TRecords>
+__attribute__((target("avx2")))
+static size_t ParseIsoTimestampsAvx2(const TRecords& records, size_t count, tTimestamp* result)
+{
+  size_t parsed = 0;
+  uint16_t fields[16];
+  size_t i = 0;
+  for (; i + 1 < count; i += 2)
+  {
+    const char* string1 = records.Data(i);
+    const char* string2 = records.Data(i + 1);
+    size_t length1 = records.Length(i);
+    size_t length2 = records.Length(i + 1);
+    if (length1 < 20 || length2 < 20)
+    {
+      parsed += ParseScalar(string1, length1, result[i]) ? 1 : 0;
+      parsed += ParseScalar(string2, length2, result[i + 1]) ? 1 : 0;
+      continue;
+    }
+    int ok = ConvertFixedLayoutPrefixes(string1, string2, fields);
+    if ((ok & 1) && ParseFixedLayoutTail(string1, length1, &fields[0], result[i]))
+    {
+      parsed++;
+    }
+    else
+    {
+      parsed += ParseScalar(string1, length1, result[i]) ? 1 : 0;
+    }
+    if ((ok & 2) && ParseFixedLayoutTail(string2, length2, &fields[8], result[i + 1]))
+    {
+      parsed++;
+    }
+    else
+    {
+      parsed += ParseScalar(string2, length2, result[i + 1]) ? 1 : 0;
+    }
+  }
+  if (i < count)
+  {
+    parsed += ParseSse41(records.Data(i), records.Length(i), result[i]) ? 1 : 0;
+  }
+  return parsed;
+}
+
+#endif
+
+template <typename TRecords>
+static size_t ParseIsoTimestampsImplementation(const TRecords& records, size_t count, tTimestamp* result)
+{
+  switch (GetSimdLevel())
+  {
+#ifdef RRLIB_TIME_X86_SIMD
+  case tSimdLevel::AVX2:
+    return ParseIsoTimestampsAvx2(records, count, result);
+  case tSimdLevel::SSE41:
+    return ParseIsoTimestampsSse41(records, count, result);
+#endif
+  default:
+    break;
+  }
+
+  size_t parsed = 0;
+  for (size_t i = 0; i < count; i++)
+  {
+    parsed += ParseScalar(records.Data(i), records.Length(i), result[i]) ? 1 : 0;
+  }
+  return parsed;
+}
+
+/*! \return UTC offset of local time zone at specified second */
+static int64_t GetLocalOffset(int64_t second)
+{
+  time_t tt = static_cast<time_t>(second);
+  tm tmp;
+  memset(&tmp, 0, sizeof(tmp));
+  localtime_r(&tt, &tmp);
+  return tmp.tm_gmtoff;
+}
+
+/*! Updates time zone cache so that it is valid for the specified second */
+static void UpdateTimeZoneCache(tLocalTimeZoneCache& cache, int64_t second)
+{
+  cache.offset = GetLocalOffset(second);
+  cache.valid_from = second;
+  cache.valid_to = (GetLocalOffset(second + 3599) == cache.offset) ? second + 3599 : second;
+
+  // same as strftime's "%z" - with colon inserted
+  int64_t offset_minutes = cache.offset / 60;
+  cache.suffix[0] = offset_minutes < 0 ? '-' : '+';
+  if (offset_minutes < 0)
+  {
+    offset_minutes = -offset_minutes;
+  }
+  memcpy(&cache.suffix[1], &cDIGIT_PAIRS[(offset_minutes / 60) * 2], 2);
+  cache.suffix[3] = ':';
+  memcpy(&cache.suffix[4], &cDIGIT_PAIRS[(offset_minutes % 60) * 2], 2);
+}
+
+/*!
+ * Converts value to eight decimal ASCII digits (with leading zeros) using SWAR arithmetic
+ *
+ * \param value Value (< 100000000)
+ * \return Eight ASCII digits (most significant digit in lowest byte)
+ */
+static inline uint64_t ToEightDigits(uint32_t value)
+{
+  // 32 bit lanes: first and last four digits
+  uint64_t x = (value / 10000) | (static_cast<uint64_t>(value % 10000) << 32);
+  // 16 bit lanes: two digits each (x / 100 per lane via multiplication with 10486 / 2^20)
+  uint64_t y = ((x * 10486) >> 20) & 0x0000007F0000007FULL;
+  x = y | ((x - y * 100) << 16);
+  // 8 bit lanes: one digit each (x / 10 per lane via multiplication with 103 / 2^10)
+  y = ((x * 103) >> 10) & 0x000F000F000F000FULL;
+  x = y | ((x - y * 10) << 8);
+  return x + 0x3030303030303030ULL;
+}
+
+/*! Writes digits [first, 8) generated by ToEightDigits() to buffer (endian-independent - compiles to a single store on little endian machines) */
+static inline void StoreDigits(char* buffer, uint64_t digits, int first)
+{
+  for (int i = first; i < 8; i++)
+  {
+    buffer[i - first] = static_cast<char>(digits >> (8 * i));
+  }
+}
+
+/*! Formats single timestamp (see FormatIsoTimestamps) - returns number of characters written */
+static inline size_t FormatIsoTimestamp(const tTimestamp& timestamp, tLocalTimeZoneCache& cache, char* buffer)
+{
+  int64_t ticks = std::chrono::duration_cast<std::chrono::nanoseconds>(timestamp.time_since_epoch()).count();
+  int64_t second = ticks / 1000000000;
+  int64_t ns = ticks % 1000000000;
+  if (ns < 0)
+  {
+    ns += 1000000000;
+    second--;
+  }
+  if (second < cache.valid_from || second > cache.valid_to)
+  {
+    UpdateTimeZoneCache(cache, second);
+  }
+
+  int64_t local_second = second + cache.offset;
+  int64_t day = local_second / 86400;
+  int64_t second_of_day = local_second % 86400;
+  if (second_of_day < 0)
+  {
+    second_of_day += 86400;
+    day--;
+  }
+  if (day != cache.day)
+  {
+    tCivilDate date = CivilFromDays(day);
+    memcpy(&cache.date[0], &cDIGIT_PAIRS[(date.year / 100) * 2], 2);
+    memcpy(&cache.date[2], &cDIGIT_PAIRS[(date.year % 100) * 2], 2);
+    cache.date[4] = '-';
+    memcpy(&cache.date[5], &cDIGIT_PAIRS[date.month * 2], 2);
+    cache.date[7] = '-';
+    memcpy(&cache.date[8], &cDIGIT_PAIRS[date.day * 2], 2);
+    cache.date[10] = 'T';
+    cache.day = day;
+  }
+
+  char* c = buffer;
+  memcpy(c, cache.date, 11);
+  unsigned int seconds = static_cast<unsigned int>(second_of_day);
+  memcpy(&c[11], &cDIGIT_PAIRS[(seconds / 3600) * 2], 2);
+  c[13] = ':';
+  memcpy(&c[14], &cDIGIT_PAIRS[((seconds / 60) % 60) * 2], 2);
+  c[16] = ':';
+  memcpy(&c[17], &cDIGIT_PAIRS[(seconds % 60) * 2], 2);
+  c += 19;
+
+  if (ns != 0)
+  {
+    *c = '.';
+    uint32_t nanoseconds = static_cast<uint32_t>(ns);
+    if (nanoseconds % 1000000 == 0)
+    {
+      uint32_t ms = nanoseconds / 1000000;
+      c[1] = '0' + ms / 100;
+      memcpy(&c[2], &cDIGIT_PAIRS[(ms % 100) * 2], 2);
+      c += 4;
+    }
+    else if (nanoseconds % 1000 == 0)
+    {
+      StoreDigits(&c[1], ToEightDigits(nanoseconds / 1000), 2);
+      c += 7;
+    }
+    else
+    {
+      c[1] = '0' + nanoseconds / 100000000;
+      StoreDigits(&c[2], ToEightDigits(nanoseconds % 100000000), 0);
+      c += 10;
+    }
+  }
+  memcpy(c, cache.suffix, 6);
+  return (c + 6) - buffer;
+}
+
+size_t FormatIsoTimestamps(const tTimestamp* timestamps, size_t count, char* buffer, char separator)
+{
+  tLocalTimeZoneCache cache;
+  char* c = buffer;
+  for (size_t i = 0; i < count; i++)
+  {
+    if (i > 0)
+    {
+      *c = separator;
+      c++;
+    }
+    c += FormatIsoTimestamp(timestamps[i], cache, c);
+  }
+  return c - buffer;
+}
+
+void FormatIsoTimestamps(const tTimestamp* timestamps, size_t count, std::string& output, char separator)
+{
+  size_t offset = output.length();
+  output.resize(offset + count * (tIsoTimestampFormatter::cMAX_LENGTH + 1));
+  size_t length = FormatIsoTimestamps(timestamps, count, &output[offset], separator);
+  output.resize(offset + length);
+}
+
+size_t ParseIsoTimestamps(const std::string* strings, size_t count, tTimestamp* result)
+{
+  tStringArrayRecords records = { strings };
+  return ParseIsoTimestampsImplementation(records, count, result);
+}
+
+size_t ParseIsoTimestamps(const char* buffer, size_t stride, size_t count, tTimestamp* result)
+{
+  tStrideRecords records = { buffer, stride };
+  return ParseIsoTimestampsImplementation(records, count, result);
+}
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
@@ -0,0 +1,122 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    rrlib/time/batch_conversion.h
+ *
+ * \author  agent
+ *
+ * \date    2026-10-18
+ *
+ * \brief   Contains functions for converting many timestamps at once
+ *
+ * Batch variants of ISO 8601 parsing and formatting functions in time.h.
+ * They are meant for importing and exporting large amounts of recorded data.
+ */
+//----------------------------------------------------------------------
+#ifndef __rrlib__time__batch_conversion_h__
+#define __rrlib__time__batch_conversion_h__
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <string>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/time/time.h"
+#include "rrlib/time/tIsoTimestampFormatter.h"
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace time
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+/*!
+ * Parses multiple timestamps in ISO 8601 string representation.
+ *
+ * Strings with the fixed layout generated by ToIsoString() ("YYYY-MM-DDTHH:MM:SS[.fraction](Z|+HH:MM)")
+ * are validated and converted using SIMD instructions (SSE4.1 or AVX2 - selected at runtime depending on CPU).
+ * All other strings are parsed by TryParseIsoTimestamp().
+ *
+ * \param strings Strings to parse
+ * \param count Number of strings
+ * \param result Array that parsed timestamps are written to (must have 'count' elements). Strings that cannot be parsed yield cNO_TIME.
+ * \return Number of strings that were parsed successfully
+ */
+size_t ParseIsoTimestamps(const std::string* strings, size_t count, tTimestamp* result);
+
+/*!
+ * Parses multiple timestamps in ISO 8601 string representation that are stored in a buffer with fixed stride
+ * (e.g. a file with one ToIsoString() result per line).
+ * Padding at the end of each record (whitespace, ',', ';' or zeros) is ignored.
+ * Otherwise equivalent to the variant above.
+ *
+ * \param buffer Buffer containing strings. i-th string starts at buffer + i * stride.
+ * \param stride Offset between strings in buffer
+ * \param count Number of strings
+ * \param result Array that parsed timestamps are written to (must have 'count' elements). Strings that cannot be parsed yield cNO_TIME.
+ * \return Number of strings that were parsed successfully
+ */
+size_t ParseIsoTimestamps(const char* buffer, size_t stride, size_t count, tTimestamp* result);
+
+/*!
+ * Turns multiple timestamps into ISO 8601 string representation (local time zone).
+ * Output is identical to calling ToIsoString() for each timestamp.
+ *
+ * Civil date is computed only once per day and time zone offset is looked up only
+ * once per hour of timestamps (offset changes are assumed to be at least one hour apart).
+ * Digits are generated using SWAR arithmetic (eight digits in one 64 bit register).
+ *
+ * \param timestamps Timestamps to format
+ * \param count Number of timestamps
+ * \param buffer Buffer to write strings to. Must provide space for count * (tIsoTimestampFormatter::cMAX_LENGTH + 1) characters.
+ * \param separator Character that is written between two timestamps (e.g. '\n' or ',')
+ * \return Number of characters written to buffer (buffer is not zero-terminated)
+ */
+size_t FormatIsoTimestamps(const tTimestamp* timestamps, size_t count, char* buffer, char separator = '\n');
+
+/*!
+ * Turns multiple timestamps into ISO 8601 string representation (local time zone).
+ * Variant of the function above that appends strings to 'output'.
+ *
+ * \param timestamps Timestamps to format
+ * \param count Number of timestamps
+ * \param output String to append timestamp strings to
+ * \param separator Character that is written between two timestamps (e.g. '\n' or ',')
+ */
+void FormatIsoTimestamps(const tTimestamp* timestamps, size_t count, std::string& output, char separator = '\n');
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
+
+
+#endif
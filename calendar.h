@@ -0,0 +1,193 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    rrlib/time/calendar.h
+ *
+ * \author  agent
+ *
+ * \date    2026-10-18
+ *
+ * \brief   Contains civil calendar (proleptic Gregorian) arithmetic
+ *
+ * Closed-form conversions between civil dates and days since 1970-01-01.
+ * They replace timegm/gmtime_r in parsing and formatting functions
+ * (no time zone database access, no locks, valid for all dates tTimestamp can represent).
+ * All functions are constexpr - and can therefore be used to compute constants at compile time.
+ */
+//----------------------------------------------------------------------
+#ifndef __rrlib__time__calendar_h__
+#define __rrlib__time__calendar_h__
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <cstdint>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace time
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+/*!
+ * Date in proleptic Gregorian calendar
+ */
+struct tCivilDate
+{
+  int64_t year;
+  unsigned int month;  //!< [1..12]
+  unsigned int day;    //!< [1..31]
+};
+
+/*!
+ * \param year Year
+ * \return True if year is a leap year
+ */
+constexpr bool IsLeapYear(int64_t year)
+{
+  return (year % 4 == 0) && ((year % 100 != 0) || (year % 400 == 0));
+}
+
+/*!
+ * \param year Year
+ * \param month Month [1..12]
+ * \return Number of days in specified month
+ */
+constexpr unsigned int DaysInMonth(int64_t year, unsigned int month)
+{
+  return month == 2 ? (IsLeapYear(year) ? 29 : 28) : ((month == 4 || month == 6 || month == 9 || month == 11) ? 30 : 31);
+}
+
+namespace internal
+{
+// Helpers for constexpr civil date computations (C++11 constexpr functions consist of a single return statement)
+
+constexpr int64_t Era(int64_t march_based_year)
+{
+  return (march_based_year >= 0 ? march_based_year : march_based_year - 399) / 400;
+}
+
+constexpr int64_t DayOfYearMarchBased(unsigned int month, unsigned int day)
+{
+  return (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + static_cast<int64_t>(day) - 1;  // [0, 365]
+}
+
+constexpr int64_t DayOfEra(int64_t year_of_era, int64_t day_of_year)
+{
+  return year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;  // [0, 146096]
+}
+
+constexpr int64_t DaysFromMarchBasedCivil(int64_t march_based_year, unsigned int month, unsigned int day)
+{
+  return Era(march_based_year) * 146097 + DayOfEra(march_based_year - Era(march_based_year) * 400, DayOfYearMarchBased(month, day)) - 719468;
+}
+
+}
+
+/*!
+ * Converts civil date to days since 1970-01-01
+ * (algorithm from Howard Hinnant: "chrono-Compatible Low-Level Date Algorithms")
+ *
+ * \param year Year
+ * \param month Month [1..12]
+ * \param day Day of month [1..31] (values beyond the month's length are counted into the following month)
+ * \return Number of days since 1970-01-01 (negative for earlier dates)
+ */
+constexpr int64_t DaysFromCivil(int64_t year, unsigned int month, unsigned int day)
+{
+  return internal::DaysFromMarchBasedCivil(year - (month <= 2 ? 1 : 0), month, day);
+}
+
+namespace internal
+{
+
+constexpr int64_t EraOfShiftedDays(int64_t shifted_days)
+{
+  return (shifted_days >= 0 ? shifted_days : shifted_days - 146096) / 146097;
+}
+
+constexpr int64_t YearOfEra(int64_t day_of_era)
+{
+  return (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;  // [0, 399]
+}
+
+constexpr int64_t DayOfYearFromDayOfEra(int64_t day_of_era, int64_t year_of_era)
+{
+  return day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);  // [0, 365]
+}
+
+constexpr unsigned int MonthFromMarchBased(int64_t march_based_month)
+{
+  return static_cast<unsigned int>(march_based_month < 10 ? march_based_month + 3 : march_based_month - 9);
+}
+
+constexpr tCivilDate CivilFromMarchBasedMonth(int64_t march_based_year, int64_t day_of_year, int64_t march_based_month)
+{
+  return tCivilDate { march_based_year + (MonthFromMarchBased(march_based_month) <= 2 ? 1 : 0), MonthFromMarchBased(march_based_month), static_cast<unsigned int>(day_of_year - (153 * march_based_month + 2) / 5 + 1) };
+}
+
+constexpr tCivilDate CivilFromDayOfYear(int64_t march_based_year, int64_t day_of_year)
+{
+  return CivilFromMarchBasedMonth(march_based_year, day_of_year, (5 * day_of_year + 2) / 153);
+}
+
+constexpr tCivilDate CivilFromDayOfEra(int64_t era, int64_t day_of_era)
+{
+  return CivilFromDayOfYear(YearOfEra(day_of_era) + era * 400, DayOfYearFromDayOfEra(day_of_era, YearOfEra(day_of_era)));
+}
+
+constexpr tCivilDate CivilFromShiftedDays(int64_t shifted_days)
+{
+  return CivilFromDayOfEra(EraOfShiftedDays(shifted_days), shifted_days - EraOfShiftedDays(shifted_days) * 146097);
+}
+
+}
+
+/*!
+ * Converts days since 1970-01-01 to civil date
+ * (algorithm from Howard Hinnant: "chrono-Compatible Low-Level Date Algorithms")
+ *
+ * \param days Number of days since 1970-01-01
+ * \return Civil date
+ */
+constexpr tCivilDate CivilFromDays(int64_t days)
+{
+  return internal::CivilFromShiftedDays(days + 719468);
+}
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
+
+
+#endif
@@ -0,0 +1,295 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    rrlib/time/formatting.cpp
+ *
+ * \author  agent
+ *
+ * \date    2026-10-18
+ *
+ */
+//----------------------------------------------------------------------
+#include "rrlib/time/formatting.h"
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/time/tIsoTimestampFormatter.h"
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+#include <cassert>
+
+//----------------------------------------------------------------------
+// Namespace usage
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace time
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Const values
+//----------------------------------------------------------------------
+
+static const uint64_t cPOWERS_OF_TEN[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000 };
+
+/*! Units that ToString() and TryParseDuration() support */
+static const struct
+{
+  const char* name;
+  size_t length;
+  uint64_t nanoseconds;
+  int fraction_digits;  // digits required for nanosecond resolution
+} cUNITS[] =
+{
+  { "ns", 2, 1, 0 },
+  { "us", 2, 1000, 3 },
+  { "ms", 2, 1000000, 6 },
+  { "s", 1, 1000000000, 9 },
+  { "minutes", 7, 60000000000ULL, 0 },
+  { "minute", 6, 60000000000ULL, 0 },
+  { "hours", 5, 3600000000000ULL, 0 },
+  { "hour", 4, 3600000000000ULL, 0 }
+};
+
+//----------------------------------------------------------------------
+// Implementation
+//----------------------------------------------------------------------
+
+/*! Writes decimal representation of value to buffer - \return Pointer behind last written character */
+static inline char* WriteUnsigned(char* buffer, uint64_t value)
+{
+  char digits[20];
+  int count = 0;
+  do
+  {
+    digits[count++] = '0' + (value % 10);
+    value /= 10;
+  }
+  while (value);
+  while (count)
+  {
+    *(buffer++) = digits[--count];
+  }
+  return buffer;
+}
+
+size_t ToString(std::chrono::nanoseconds duration, char* buffer, const tDurationFormat& format)
+{
+  const auto& unit = cUNITS[static_cast<int>(format.unit)];
+  char* c = buffer;
+  int64_t count = duration.count();
+  uint64_t magnitude = count < 0 ? (~static_cast<uint64_t>(count)) + 1 : static_cast<uint64_t>(count);
+  if (count < 0)
+  {
+    *(c++) = '-';
+  }
+
+  uint64_t integer = magnitude / unit.nanoseconds;
+  uint64_t fraction = magnitude % unit.nanoseconds;
+  int digits = unit.fraction_digits;
+  if (format.precision == tDurationFormat::cAUTOMATIC_PRECISION)
+  {
+    // Same rules as ToString(): zero without fraction - otherwise at least three digits
+    if (magnitude == 0)
+    {
+      digits = 0;
+    }
+    while (digits > 3 && fraction % 1000 == 0)
+    {
+      fraction /= 1000;
+      digits -= 3;
+    }
+  }
+  else
+  {
+    int precision = std::min(std::max(format.precision, 0), 9);
+    if (precision < digits)
+    {
+      uint64_t scale = cPOWERS_OF_TEN[digits - precision];
+      fraction = (fraction + scale / 2) / scale;
+      if (fraction == cPOWERS_OF_TEN[precision])
+      {
+        integer++;
+        fraction = 0;
+      }
+    }
+    else
+    {
+      fraction *= cPOWERS_OF_TEN[precision - digits];
+    }
+    digits = precision;
+  }
+
+  c = WriteUnsigned(c, integer);
+  if (digits > 0)
+  {
+    *(c++) = '.';
+    for (int i = digits - 1; i >= 0; i--)
+    {
+      c[i] = '0' + (fraction % 10);
+      fraction /= 10;
+    }
+    c += digits;
+  }
+  *(c++) = ' ';
+  memcpy(c, unit.name, unit.length);
+  c += unit.length;
+  *c = 0;
+  return c - buffer;
+}
+
+size_t ToIsoString(const tTimestamp& timestamp, char* buffer)
+{
+  return tIsoTimestampFormatter::ThreadLocalInstance().Format(timestamp, buffer);
+}
+
+static inline bool SetParseError(tParseError* error, const char* description, size_t position)
+{
+  if (error)
+  {
+    error->description = description;
+    error->position = position;
+  }
+  return false;
+}
+
+bool TryParseDuration(const char* string, size_t length, std::chrono::nanoseconds& result, tParseError* error)
+{
+  size_t position = 0;
+  bool negative = position < length && string[position] == '-';
+  if (negative)
+  {
+    position++;
+  }
+
+  // Number
+  uint64_t integer = 0;
+  size_t integer_start = position;
+  for (; position < length && string[position] >= '0' && string[position] <= '9'; position++)
+  {
+    if (integer > (std::numeric_limits<uint64_t>::max() - 9) / 10)
+    {
+      return SetParseError(error, "Number too large", position);
+    }
+    integer = integer * 10 + (string[position] - '0');
+  }
+  if (position == integer_start)
+  {
+    return SetParseError(error, "Expected digit", position);
+  }
+  size_t fraction_start = position, fraction_end = position;
+  if (position < length && string[position] == '.')
+  {
+    position++;
+    fraction_start = position;
+    for (; position < length && string[position] >= '0' && string[position] <= '9'; position++)
+    {}
+    fraction_end = position;
+    if (fraction_end == fraction_start)
+    {
+      return SetParseError(error, "Expected digit", position);
+    }
+  }
+
+  // Unit
+  while (position < length && string[position] == ' ')
+  {
+    position++;
+  }
+  const char* unit_string = string + position;
+  size_t unit_length = length - position;
+  for (auto & unit : cUNITS)
+  {
+    if (unit.length == unit_length && memcmp(unit_string, unit.name, unit_length) == 0)
+    {
+      if (unit.fraction_digits == 0 && fraction_end > fraction_start)
+      {
+        return SetParseError(error, "Fraction not allowed for this unit", fraction_start - 1);
+      }
+      uint64_t fraction = 0;
+      for (size_t i = 0; i < static_cast<size_t>(unit.fraction_digits); i++)
+      {
+        fraction = fraction * 10 + ((fraction_start + i < fraction_end) ? (string[fraction_start + i] - '0') : 0);
+      }
+      uint64_t limit = static_cast<uint64_t>(std::numeric_limits<int64_t>::max()) + (negative ? 1 : 0);
+      if (integer > (limit - fraction) / unit.nanoseconds)
+      {
+        return SetParseError(error, "Duration out of range", integer_start);
+      }
+      uint64_t magnitude = integer * unit.nanoseconds + fraction;
+      result = std::chrono::nanoseconds(negative ? static_cast<int64_t>(~magnitude + 1) : static_cast<int64_t>(magnitude));
+      return true;
+    }
+  }
+  return SetParseError(error, "Invalid unit", position);
+}
+
+std::chrono::nanoseconds ParseDuration(const std::string& s)
+{
+  std::chrono::nanoseconds result;
+  tParseError error;
+  if (!TryParseDuration(s.c_str(), s.length(), result, &error))
+  {
+    throw std::runtime_error("Invalid duration string '" + s + "': " + error.description + " (at position " + std::to_string(error.position) + ")");
+  }
+  return result;
+}
+
+std::ostream& operator << (std::ostream& stream, const tFormattedDuration& duration)
+{
+  char buffer[cMAX_DURATION_STRING_LENGTH + 1];
+  return stream.write(buffer, ToString(duration.duration, buffer, duration.format));
+}
+
+std::ostream& operator << (std::ostream& stream, const tFormattedTimestamp& timestamp)
+{
+  char buffer[tIsoTimestampFormatter::cMAX_LENGTH + 1];
+  if (timestamp.zone)
+  {
+    return stream.write(buffer, tIsoTimestampFormatter(*timestamp.zone).Format(timestamp.timestamp, buffer));
+  }
+  return stream.write(buffer, ToIsoString(timestamp.timestamp, buffer));
+}
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
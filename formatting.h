@@ -0,0 +1,192 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    rrlib/time/formatting.h
+ *
+ * \author  agent
+ *
+ * \date    2026-10-18
+ *
+ * \brief   Contains functions for formatting durations and timestamps into buffers and streams
+ *
+ * Variants of ToString() and ToIsoString() that write to caller-provided buffers or to
+ * std::ostreams directly - without creating temporary std::strings (no heap allocation).
+ *
+ * Example:
+ *   std::cout << "Latency: " << Formatted(latency) << " at " << Formatted(timestamp) << std::endl;
+ */
+//----------------------------------------------------------------------
+#ifndef __rrlib__time__formatting_h__
+#define __rrlib__time__formatting_h__
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <ostream>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/time/time.h"
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace time
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+class tTimeZone;
+
+/*!
+ * Unit and precision for formatting durations as number + unit
+ */
+struct tDurationFormat
+{
+  enum class tUnit
+  {
+    NANOSECONDS,   //!< "ns"
+    MICROSECONDS,  //!< "us"
+    MILLISECONDS,  //!< "ms"
+    SECONDS        //!< "s"
+  };
+
+  /*! Precision value for ToString() rules: fractional digits in groups of three - as many as needed for exact representation (at least three) */
+  enum { cAUTOMATIC_PRECISION = -1 };
+
+  /*! Unit to format duration in */
+  tUnit unit;
+
+  /*! Number of fractional digits [0..9] (value is rounded) - or cAUTOMATIC_PRECISION */
+  int precision;
+
+  /*! Default format is identical to ToString(std::chrono::nanoseconds) */
+  tDurationFormat(tUnit unit = tUnit::MILLISECONDS, int precision = cAUTOMATIC_PRECISION) :
+    unit(unit),
+    precision(precision)
+  {}
+};
+
+/*! Maximum number of characters written by ToString(duration, buffer, format) (without terminating zero) */
+enum { cMAX_DURATION_STRING_LENGTH = 1 + 20 + 1 + 9 + 3 };
+
+/*!
+ * Formats duration into buffer (with default format, output is identical to ToString(duration))
+ *
+ * \param duration Duration to format
+ * \param buffer Buffer to write to. Must provide space for cMAX_DURATION_STRING_LENGTH + 1 characters.
+ * \param format Unit and precision
+ * \return Number of characters written (buffer is zero-terminated)
+ */
+size_t ToString(std::chrono::nanoseconds duration, char* buffer, const tDurationFormat& format = tDurationFormat());
+
+/*!
+ * Formats timestamp into buffer (output is identical to ToIsoString(timestamp))
+ *
+ * \param timestamp Timestamp to format
+ * \param buffer Buffer to write to. Must provide space for tIsoTimestampFormatter::cMAX_LENGTH + 1 characters.
+ * \return Number of characters written (buffer is zero-terminated)
+ */
+size_t ToIsoString(const tTimestamp& timestamp, char* buffer);
+
+/*!
+ * Parses duration in representation created by ToString() - e.g. "-12.500 ms".
+ * Accepts units "ns", "us", "ms", "s", "minute(s)" and "hour(s)". Digits beyond nanosecond resolution are truncated.
+ *
+ * \param string Pointer to string
+ * \param length Length of string
+ * \param result Parsed duration is written to this variable (only modified on success)
+ * \param error If not NULL, a description of the error and its position is written to this struct on failure
+ * \return True if string could be parsed
+ */
+bool TryParseDuration(const char* string, size_t length, std::chrono::nanoseconds& result, tParseError* error = NULL);
+
+/*!
+ * Parses duration in representation created by ToString()
+ *
+ * \param s String to parse
+ * \return Duration
+ * \throws std::runtime_error if string is invalid
+ */
+std::chrono::nanoseconds ParseDuration(const std::string& s);
+
+/*!
+ * Duration with format for writing to std::ostream (see Formatted())
+ */
+struct tFormattedDuration
+{
+  std::chrono::nanoseconds duration;
+  tDurationFormat format;
+};
+
+/*!
+ * Timestamp with time zone for writing to std::ostream (see Formatted())
+ */
+struct tFormattedTimestamp
+{
+  tTimestamp timestamp;
+  const tTimeZone* zone;  //!< nullptr for local time zone
+};
+
+/*!
+ * \param duration Duration to write to stream
+ * \param format Unit and precision
+ * \return Object that can be written to std::ostream
+ */
+inline tFormattedDuration Formatted(std::chrono::nanoseconds duration, const tDurationFormat& format = tDurationFormat())
+{
+  return tFormattedDuration { duration, format };
+}
+
+/*!
+ * \param timestamp Timestamp to write to stream (in ISO 8601 representation - local time zone)
+ * \return Object that can be written to std::ostream
+ */
+inline tFormattedTimestamp Formatted(const tTimestamp& timestamp)
+{
+  return tFormattedTimestamp { timestamp, nullptr };
+}
+
+/*!
+ * \param timestamp Timestamp to write to stream (in ISO 8601 representation)
+ * \param zone Time zone (must exist until object is written to stream)
+ * \return Object that can be written to std::ostream
+ */
+inline tFormattedTimestamp Formatted(const tTimestamp& timestamp, const tTimeZone& zone)
+{
+  return tFormattedTimestamp { timestamp, &zone };
+}
+
+std::ostream& operator << (std::ostream& stream, const tFormattedDuration& duration);
+std::ostream& operator << (std::ostream& stream, const tFormattedTimestamp& timestamp);
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
+
+
+#endif
@@ -0,0 +1,272 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    rrlib/time/literals.h
+ *
+ * \author  agent
+ *
+ * \date    2026-10-18
+ *
+ * \brief   Contains user-defined literals for timestamps and durations in ISO 8601 representation
+ *
+ * Literals are parsed by constexpr functions. When used to initialize constexpr
+ * variables, they are validated and computed at compile time:
+ *
+ *   constexpr rrlib::time::tDuration cCYCLE_TIME = "PT0.04S"_iso_duration;
+ *   constexpr rrlib::time::tTimestamp cGPS_EPOCH = "1980-01-06T00:00:00Z"_iso_timestamp;
+ *
+ * (Invalid literals then result in compiler errors)
+ */
+//----------------------------------------------------------------------
+#ifndef __rrlib__time__literals_h__
+#define __rrlib__time__literals_h__
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <limits>
+#include <stdexcept>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/time/time.h"
+#include "rrlib/time/calendar.h"
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace time
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+namespace internal
+{
+// constexpr parsing functions (C++11 constexpr functions consist of a single return statement - therefore recursion)
+
+constexpr bool IsDigit(char c)
+{
+  return c >= '0' && c <= '9';
+}
+
+/*! \return Position of first non-digit character at or after position i */
+constexpr size_t SkipDigits(const char* string, size_t length, size_t i)
+{
+  return (i < length && IsDigit(string[i])) ? SkipDigits(string, length, i + 1) : i;
+}
+
+/*! \return Value of digits in [begin, end) */
+constexpr int64_t ParseLiteralNumber(const char* string, size_t begin, size_t end, int64_t value)
+{
+  return begin == end ? value : ParseLiteralNumber(string, begin + 1, end, value * 10 + (string[begin] - '0'));
+}
+
+/*! \return Nanoseconds of fraction with digits in [begin, end) (digits beyond nanoseconds are ignored) */
+constexpr int64_t ParseLiteralFraction(const char* string, size_t begin, size_t end, int64_t scale)
+{
+  return (begin == end || scale == 0) ? 0 : (string[begin] - '0') * scale + ParseLiteralFraction(string, begin + 1, end, scale / 10);
+}
+
+/*! \return Rank of duration designator (Y=1, M=2, W=3, D=4, H=5, M=6, S=7) - 0 if designator is invalid */
+constexpr int DurationDesignatorRank(char designator, bool time)
+{
+  return time ? (designator == 'H' ? 5 : (designator == 'M' ? 6 : (designator == 'S' ? 7 : 0))) :
+         (designator == 'Y' ? 1 : (designator == 'M' ? 2 : (designator == 'W' ? 3 : (designator == 'D' ? 4 : 0))));
+}
+
+/*! \return Nanoseconds per unit of designator with specified rank (0 for years and months) */
+constexpr int64_t DurationDesignatorUnit(int rank)
+{
+  return rank == 3 ? 7 * 86400000000000LL : (rank == 4 ? 86400000000000LL : (rank == 5 ? 3600000000000LL : (rank == 6 ? 60000000000LL : (rank == 7 ? 1000000000LL : 0))));
+}
+
+/*! \return Nanoseconds of years and months (counted from 1970-01-01 - as in ParseIsoDuration) */
+constexpr int64_t DurationCalendarNanoseconds(int64_t years, int64_t months)
+{
+  return (years == 0 && months == 0) ? 0 :
+         (years + months / 12 > 290 ? throw std::invalid_argument("Duration literal out of range") :
+          DaysFromCivil(1970 + years + months / 12, static_cast<unsigned int>(months % 12) + 1, 1) * 86400000000000LL);
+}
+
+constexpr int64_t ParseDurationLiteral(const char* string, size_t length, size_t i, bool time, int last_rank, int64_t years, int64_t months, int64_t nanoseconds);
+
+/*! Adds parsed element to result and continues parsing after designator */
+constexpr int64_t ParseDurationLiteralElement(const char* string, size_t length, size_t designator_position, bool time, int rank, int64_t value, int64_t fraction,
+    int64_t years, int64_t months, int64_t nanoseconds)
+{
+  return (rank > 2 && value > (std::numeric_limits<int64_t>::max() - nanoseconds - fraction) / DurationDesignatorUnit(rank)) ? throw std::invalid_argument("Duration literal out of range") :
+         ParseDurationLiteral(string, length, designator_position + 1, time, rank, rank == 1 ? value : years, rank == 2 ? value : months,
+                              rank > 2 ? nanoseconds + value * DurationDesignatorUnit(rank) + fraction : nanoseconds);
+}
+
+/*! Validates designator of element with number in [i, number_end) and optional fraction ending at designator_position */
+constexpr int64_t ParseDurationLiteralDesignator(const char* string, size_t length, size_t i, size_t number_end, size_t designator_position, bool time, int last_rank,
+    int64_t years, int64_t months, int64_t nanoseconds)
+{
+  return designator_position >= length ? throw std::invalid_argument("Duration literal: Expected designator") :
+         (DurationDesignatorRank(string[designator_position], time) == 0 ? throw std::invalid_argument("Duration literal: Invalid designator") :
+          (DurationDesignatorRank(string[designator_position], time) <= last_rank ? throw std::invalid_argument("Duration literal: Designator repeated or in wrong order") :
+           ((designator_position != number_end && DurationDesignatorRank(string[designator_position], time) != 7) ? throw std::invalid_argument("Duration literal: Only seconds may have a fraction") :
+            ParseDurationLiteralElement(string, length, designator_position, time, DurationDesignatorRank(string[designator_position], time), ParseLiteralNumber(string, i, number_end, 0),
+                                        designator_position != number_end ? ParseLiteralFraction(string, number_end + 1, designator_position, 100000000) : 0, years, months, nanoseconds))));
+}
+
+/*! Parses element with number in [i, number_end) */
+constexpr int64_t ParseDurationLiteralNumber(const char* string, size_t length, size_t i, size_t number_end, bool time, int last_rank, int64_t years, int64_t months, int64_t nanoseconds)
+{
+  return number_end == i ? throw std::invalid_argument("Duration literal: Expected number") :
+         (number_end - i > 15 ? throw std::invalid_argument("Duration literal: Number too large") :
+          ((number_end < length && (string[number_end] == '.' || string[number_end] == ',')) ?
+           (SkipDigits(string, length, number_end + 1) == number_end + 1 ? throw std::invalid_argument("Duration literal: Expected digits after decimal sign") :
+            ParseDurationLiteralDesignator(string, length, i, number_end, SkipDigits(string, length, number_end + 1), time, last_rank, years, months, nanoseconds)) :
+           ParseDurationLiteralDesignator(string, length, i, number_end, number_end, time, last_rank, years, months, nanoseconds)));
+}
+
+/*! Parses duration literal starting at position i */
+constexpr int64_t ParseDurationLiteral(const char* string, size_t length, size_t i, bool time, int last_rank, int64_t years, int64_t months, int64_t nanoseconds)
+{
+  return i == length ? nanoseconds + DurationCalendarNanoseconds(years, months) :
+         (string[i] == 'T' ? (time ? throw std::invalid_argument("Duration literal: Duplicate 'T'") : ParseDurationLiteral(string, length, i + 1, true, last_rank, years, months, nanoseconds)) :
+          ParseDurationLiteralNumber(string, length, i, SkipDigits(string, length, i), time, last_rank, years, months, nanoseconds));
+}
+
+/*!
+ * Parses duration in ISO 8601 string representation - constexpr variant of ParseIsoDuration()
+ * (throws std::invalid_argument if string cannot be parsed - which is a compiler error in constant expressions)
+ *
+ * \return Duration in nanoseconds
+ */
+constexpr int64_t ParseDurationLiteral(const char* string, size_t length)
+{
+  return (length == 0 || string[0] != 'P') ? throw std::invalid_argument("Duration literal does not start with 'P'") : ParseDurationLiteral(string, length, 1, false, 0, 0, 0, 0);
+}
+
+/*! \return value if condition is true - otherwise throws std::invalid_argument */
+constexpr int64_t CheckLiteral(bool condition, int64_t value, const char* message)
+{
+  return condition ? value : throw std::invalid_argument(message);
+}
+
+/*! \return Value of 'count' digits starting at 'position' */
+constexpr int64_t LiteralDigits(const char* string, size_t length, size_t position, size_t count)
+{
+  return count == 0 ? 0 :
+         CheckLiteral(position + count <= length && IsDigit(string[position + count - 1]), LiteralDigits(string, length, position, count - 1) * 10 + (string[position + count - 1] - '0'),
+                      "Timestamp literal: Expected digit");
+}
+
+/*! \return value if character at 'position' is 'expected' (or 'alternative1' or 'alternative2') - otherwise throws std::invalid_argument */
+constexpr int64_t LiteralSeparator(const char* string, size_t length, size_t position, char expected, int64_t value, char alternative1 = 0, char alternative2 = 0)
+{
+  return CheckLiteral(position < length && (string[position] == expected || (alternative1 && string[position] == alternative1) || (alternative2 && string[position] == alternative2)), value,
+                      "Timestamp literal: Unexpected character");
+}
+
+/*! \return Value of two-digit field at 'position' (checked against 'max') */
+constexpr int64_t LiteralField(const char* string, size_t length, size_t position, int64_t min, int64_t max)
+{
+  return CheckLiteral(LiteralDigits(string, length, position, 2) >= min && LiteralDigits(string, length, position, 2) <= max, LiteralDigits(string, length, position, 2),
+                      "Timestamp literal: Value out of range");
+}
+
+/*! \return Seconds since epoch of date and time ("YYYY-MM-DDTHH:MM:SS") at start of timestamp literal */
+constexpr int64_t TimestampLiteralSeconds(const char* string, size_t length)
+{
+  return LiteralSeparator(string, length, 4, '-', 0) + LiteralSeparator(string, length, 7, '-', 0) + LiteralSeparator(string, length, 10, 'T', 0, 't', ' ') +
+         LiteralSeparator(string, length, 13, ':', 0) + LiteralSeparator(string, length, 16, ':', 0) +
+         CheckLiteral(LiteralField(string, length, 8, 1, 31) <= DaysInMonth(LiteralDigits(string, length, 0, 4), LiteralField(string, length, 5, 1, 12)),
+                      DaysFromCivil(LiteralDigits(string, length, 0, 4), LiteralField(string, length, 5, 1, 12), LiteralField(string, length, 8, 1, 31)) * 86400, "Timestamp literal: Day out of range") +
+         LiteralField(string, length, 11, 0, 23) * 3600 + LiteralField(string, length, 14, 0, 59) * 60 + LiteralField(string, length, 17, 0, 60);
+}
+
+/*! \return Position of time zone designator in timestamp literal (after optional fraction) */
+constexpr size_t TimestampLiteralZonePosition(const char* string, size_t length)
+{
+  return (length > 19 && string[19] == '.') ?
+         static_cast<size_t>(CheckLiteral(SkipDigits(string, length, 20) > 20, SkipDigits(string, length, 20), "Timestamp literal: Expected digits after '.'")) : 19;
+}
+
+/*! \return UTC offset in seconds of time zone designator at 'position' */
+constexpr int64_t TimestampLiteralOffset(const char* string, size_t length, size_t position)
+{
+  return position == length ? 0 :
+         ((string[position] == 'Z' || string[position] == 'z') ? CheckLiteral(position + 1 == length, 0, "Timestamp literal: Unexpected characters after timestamp") :
+          (LiteralSeparator(string, length, position, '+', 0, '-') +
+           (string[position] == '-' ? -1 : 1) * (LiteralField(string, length, position + 1, 0, 23) * 3600 +
+               (position + 3 == length ? 0 :
+                (string[position + 3] == ':' ? CheckLiteral(position + 6 == length, LiteralField(string, length, position + 4, 0, 59) * 60, "Timestamp literal: Unexpected characters after timestamp") :
+                 CheckLiteral(position + 5 == length, LiteralField(string, length, position + 3, 0, 59) * 60, "Timestamp literal: Unexpected characters after timestamp"))))));
+}
+
+/*! \return Seconds in timestamp literal (checked against range of tTimestamp) */
+constexpr int64_t TimestampLiteralCheckRange(int64_t seconds)
+{
+  return CheckLiteral(seconds < 9223372035 && seconds >= -9223372035, seconds, "Timestamp literal out of range");
+}
+
+/*!
+ * Parses timestamp in ISO 8601 string representation - constexpr variant of ParseIsoTimestamp()
+ * (throws std::invalid_argument if string cannot be parsed - which is a compiler error in constant expressions)
+ *
+ * \return Nanoseconds since epoch
+ */
+constexpr int64_t ParseTimestampLiteral(const char* string, size_t length)
+{
+  return TimestampLiteralCheckRange(TimestampLiteralSeconds(string, length) - TimestampLiteralOffset(string, length, TimestampLiteralZonePosition(string, length))) * 1000000000 +
+         (TimestampLiteralZonePosition(string, length) == 19 ? 0 : ParseLiteralFraction(string, 20, TimestampLiteralZonePosition(string, length), 100000000));
+}
+
+}
+
+inline namespace literals
+{
+
+/*!
+ * Timestamp literal in ISO 8601 representation (e.g. "1980-01-06T00:00:00Z"_iso_timestamp) - supports same format as ParseIsoTimestamp()
+ */
+constexpr tTimestamp operator"" _iso_timestamp(const char* string, size_t length)
+{
+  return tTimestamp(std::chrono::duration_cast<tDuration>(std::chrono::nanoseconds(internal::ParseTimestampLiteral(string, length))));
+}
+
+/*!
+ * Duration literal in ISO 8601 representation (e.g. "PT2.5S"_iso_duration) - supports same format as ParseIsoDuration()
+ */
+constexpr tDuration operator"" _iso_duration(const char* string, size_t length)
+{
+  return std::chrono::duration_cast<tDuration>(std::chrono::nanoseconds(internal::ParseDurationLiteral(string, length)));
+}
+
+}
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
+
+
+#endif
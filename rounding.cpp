@@ -0,0 +1,350 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    rrlib/time/rounding.cpp
+ *
+ * \author  agent
+ *
+ * \date    2026-10-18
+ *
+ */
+//----------------------------------------------------------------------
+#include "rrlib/time/rounding.h"
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <algorithm>
+#include <time.h>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/time/calendar.h"
+#include "rrlib/time/tTimeZone.h"
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+#include <cassert>
+
+//----------------------------------------------------------------------
+// Namespace usage
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace time
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+namespace
+{
+
+enum class tRounding
+{
+  FLOOR,
+  CEIL,
+  ROUND
+};
+
+/*! Bucket [begin, end) - in tDuration ticks since epoch */
+struct tBucket
+{
+  int64_t begin, end;
+
+  tBucket() : begin(1), end(0) {}
+
+  bool Contains(int64_t value) const
+  {
+    return value >= begin && value < end;
+  }
+
+  int64_t Apply(int64_t value, tRounding rounding) const
+  {
+    return (value == begin || rounding == tRounding::FLOOR || (rounding == tRounding::ROUND && value - begin < end - value)) ? begin : end;
+  }
+};
+
+}
+
+//----------------------------------------------------------------------
+// Const values
+//----------------------------------------------------------------------
+
+static const int64_t cTICKS_PER_SECOND = std::chrono::duration_cast<tDuration>(std::chrono::seconds(1)).count();
+static const int64_t cTICKS_PER_DAY = 86400 * cTICKS_PER_SECOND;
+
+//----------------------------------------------------------------------
+// Implementation
+//----------------------------------------------------------------------
+
+static inline int64_t FloorDivide(int64_t value, int64_t divisor)
+{
+  return (value - internal::FloorRemainder(value, divisor)) / divisor;
+}
+
+/*! Offset of tCalendarZone to UTC at specified time (in ticks) */
+struct tCalendarZoneOffset
+{
+  tCalendarZone zone;
+
+  int64_t operator()(int64_t ticks) const
+  {
+    if (zone == tCalendarZone::UTC)
+    {
+      return 0;
+    }
+    time_t seconds = FloorDivide(ticks, cTICKS_PER_SECOND);
+    tm t;
+    localtime_r(&seconds, &t);
+    return t.tm_gmtoff * cTICKS_PER_SECOND;
+  }
+};
+
+/*! Offset of tTimeZone to UTC at specified time (in ticks) */
+struct tTimeZoneOffset
+{
+  const tTimeZone& zone;
+
+  int64_t operator()(int64_t ticks) const
+  {
+    return zone.GetUtcOffsetSeconds(FloorDivide(ticks, cTICKS_PER_SECOND)) * cTICKS_PER_SECOND;
+  }
+};
+
+/*! \return Length of fixed-size calendar unit (in ticks) */
+static int64_t GetUnitLength(tCalendarUnit unit)
+{
+  switch (unit)
+  {
+  case tCalendarUnit::SECOND:
+    return cTICKS_PER_SECOND;
+  case tCalendarUnit::MINUTE:
+    return 60 * cTICKS_PER_SECOND;
+  case tCalendarUnit::HOUR:
+    return 3600 * cTICKS_PER_SECOND;
+  case tCalendarUnit::DAY:
+    return cTICKS_PER_DAY;
+  case tCalendarUnit::WEEK:
+    return 7 * cTICKS_PER_DAY;
+  default:
+    return 0;  // months and years have no fixed length
+  }
+}
+
+/*!
+ * Computes calendar unit that contains specified time (in zone's local time)
+ *
+ * \param local Local time (ticks since 1970-01-01T00:00:00 in local time)
+ * \return Calendar unit (in local time)
+ */
+static tBucket GetLocalCalendarBucket(int64_t local, tCalendarUnit unit)
+{
+  tBucket result;
+  if (unit == tCalendarUnit::MONTH || unit == tCalendarUnit::YEAR)
+  {
+    tCivilDate date = CivilFromDays(FloorDivide(local, cTICKS_PER_DAY));
+    if (unit == tCalendarUnit::MONTH)
+    {
+      result.begin = DaysFromCivil(date.year, date.month, 1) * cTICKS_PER_DAY;
+      result.end = (date.month == 12 ? DaysFromCivil(date.year + 1, 1, 1) : DaysFromCivil(date.year, date.month + 1, 1)) * cTICKS_PER_DAY;
+    }
+    else
+    {
+      result.begin = DaysFromCivil(date.year, 1, 1) * cTICKS_PER_DAY;
+      result.end = DaysFromCivil(date.year + 1, 1, 1) * cTICKS_PER_DAY;
+    }
+    return result;
+  }
+
+  int64_t length = GetUnitLength(unit);
+  int64_t alignment = unit == tCalendarUnit::WEEK ? 3 * cTICKS_PER_DAY : 0;  // 1970-01-01 was a Thursday
+  result.begin = local - internal::FloorRemainder(local + alignment, length);
+  result.end = result.begin + length;
+  return result;
+}
+
+/*!
+ * Converts local time to UTC
+ *
+ * \param local Local time
+ * \param offset_hint Offset that is likely valid at this time
+ * \return UTC time (if local time does not exist due to DST transition, the transition's time is returned)
+ */
+template <typename TGetOffset>
+static int64_t LocalToUtc(int64_t local, int64_t offset_hint, const TGetOffset& get_offset)
+{
+  int64_t offset = get_offset(local - offset_hint);
+  if (offset == offset_hint || get_offset(local - offset) == offset)
+  {
+    return local - offset;
+  }
+  return local - std::min(offset, offset_hint);
+}
+
+/*! \return Calendar unit that contains specified time (in UTC) */
+template <typename TGetOffset>
+static tBucket GetCalendarBucket(int64_t utc, tCalendarUnit unit, const TGetOffset& get_offset)
+{
+  int64_t offset = get_offset(utc);
+  tBucket local = GetLocalCalendarBucket(utc + offset, unit);
+  tBucket result;
+  result.begin = LocalToUtc(local.begin, offset, get_offset);
+  result.end = LocalToUtc(local.end, offset, get_offset);
+  assert(result.Contains(utc));
+  return result;
+}
+
+template <typename TGetOffset>
+static tTimestamp RoundCalendar(const tTimestamp& timestamp, tCalendarUnit unit, const TGetOffset& get_offset, tRounding rounding)
+{
+  int64_t value = timestamp.time_since_epoch().count();
+  return tTimestamp(tDuration(GetCalendarBucket(value, unit, get_offset).Apply(value, rounding)));
+}
+
+tTimestamp Floor(const tTimestamp& timestamp, tCalendarUnit unit, tCalendarZone zone)
+{
+  return RoundCalendar(timestamp, unit, tCalendarZoneOffset { zone }, tRounding::FLOOR);
+}
+
+tTimestamp Ceil(const tTimestamp& timestamp, tCalendarUnit unit, tCalendarZone zone)
+{
+  return RoundCalendar(timestamp, unit, tCalendarZoneOffset { zone }, tRounding::CEIL);
+}
+
+tTimestamp Round(const tTimestamp& timestamp, tCalendarUnit unit, tCalendarZone zone)
+{
+  return RoundCalendar(timestamp, unit, tCalendarZoneOffset { zone }, tRounding::ROUND);
+}
+
+tTimestamp Floor(const tTimestamp& timestamp, tCalendarUnit unit, const tTimeZone& zone)
+{
+  return RoundCalendar(timestamp, unit, tTimeZoneOffset { zone }, tRounding::FLOOR);
+}
+
+tTimestamp Ceil(const tTimestamp& timestamp, tCalendarUnit unit, const tTimeZone& zone)
+{
+  return RoundCalendar(timestamp, unit, tTimeZoneOffset { zone }, tRounding::CEIL);
+}
+
+tTimestamp Round(const tTimestamp& timestamp, tCalendarUnit unit, const tTimeZone& zone)
+{
+  return RoundCalendar(timestamp, unit, tTimeZoneOffset { zone }, tRounding::ROUND);
+}
+
+/*!
+ * Rounds all timestamps - reusing bucket as long as timestamps are inside
+ *
+ * \param get_bucket Function that returns bucket for specified value
+ */
+template <typename TGetBucket>
+static void RoundBatch(const tTimestamp* input, size_t count, tTimestamp* output, tRounding rounding, TGetBucket get_bucket)
+{
+  tBucket bucket;
+  for (size_t i = 0; i < count; i++)
+  {
+    int64_t value = input[i].time_since_epoch().count();
+    if (!bucket.Contains(value))
+    {
+      bucket = get_bucket(value);
+    }
+    output[i] = tTimestamp(tDuration(bucket.Apply(value, rounding)));
+  }
+}
+
+static void RoundBatch(const tTimestamp* input, size_t count, const tDuration& bucket_size, tTimestamp* output, tRounding rounding)
+{
+  int64_t length = bucket_size.count();
+  RoundBatch(input, count, output, rounding, [length](int64_t value)
+  {
+    tBucket bucket;
+    bucket.begin = value - internal::FloorRemainder(value, length);
+    bucket.end = bucket.begin + length;
+    return bucket;
+  });
+}
+
+template <typename TGetOffset>
+static void RoundBatch(const tTimestamp* input, size_t count, tCalendarUnit unit, tTimestamp* output, const TGetOffset& get_offset, tRounding rounding)
+{
+  RoundBatch(input, count, output, rounding, [unit, &get_offset](int64_t value)
+  {
+    return GetCalendarBucket(value, unit, get_offset);
+  });
+}
+
+void Floor(const tTimestamp* input, size_t count, const tDuration& bucket, tTimestamp* output)
+{
+  RoundBatch(input, count, bucket, output, tRounding::FLOOR);
+}
+
+void Ceil(const tTimestamp* input, size_t count, const tDuration& bucket, tTimestamp* output)
+{
+  RoundBatch(input, count, bucket, output, tRounding::CEIL);
+}
+
+void Round(const tTimestamp* input, size_t count, const tDuration& bucket, tTimestamp* output)
+{
+  RoundBatch(input, count, bucket, output, tRounding::ROUND);
+}
+
+void Floor(const tTimestamp* input, size_t count, tCalendarUnit unit, tTimestamp* output, tCalendarZone zone)
+{
+  RoundBatch(input, count, unit, output, tCalendarZoneOffset { zone }, tRounding::FLOOR);
+}
+
+void Floor(const tTimestamp* input, size_t count, tCalendarUnit unit, tTimestamp* output, const tTimeZone& zone)
+{
+  RoundBatch(input, count, unit, output, tTimeZoneOffset { zone }, tRounding::FLOOR);
+}
+
+void Ceil(const tTimestamp* input, size_t count, tCalendarUnit unit, tTimestamp* output, tCalendarZone zone)
+{
+  RoundBatch(input, count, unit, output, tCalendarZoneOffset { zone }, tRounding::CEIL);
+}
+
+void Ceil(const tTimestamp* input, size_t count, tCalendarUnit unit, tTimestamp* output, const tTimeZone& zone)
+{
+  RoundBatch(input, count, unit, output, tTimeZoneOffset { zone }, tRounding::CEIL);
+}
+
+void Round(const tTimestamp* input, size_t count, tCalendarUnit unit, tTimestamp* output, tCalendarZone zone)
+{
+  RoundBatch(input, count, unit, output, tCalendarZoneOffset { zone }, tRounding::ROUND);
+}
+
+void Round(const tTimestamp* input, size_t count, tCalendarUnit unit, tTimestamp* output, const tTimeZone& zone)
+{
+  RoundBatch(input, count, unit, output, tTimeZoneOffset { zone }, tRounding::ROUND);
+}
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
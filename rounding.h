@@ -0,0 +1,185 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    rrlib/time/rounding.h
+ *
+ * \author  agent
+ *
+ * \date    2026-10-18
+ *
+ * \brief   Contains functions for rounding timestamps to calendar units or fixed durations
+ *
+ * Floor, Ceil and Round assign timestamps to buckets - e.g. for aggregating samples per minute or per day.
+ * Buckets are either fixed durations (aligned to 1970-01-01T00:00:00Z) or calendar units (in UTC, local time or a tTimeZone).
+ * Timestamps on a bucket boundary are returned unchanged by all functions.
+ * Round rounds to the later boundary on ties.
+ */
+//----------------------------------------------------------------------
+#ifndef __rrlib__time__rounding_h__
+#define __rrlib__time__rounding_h__
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/time/time.h"
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace time
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+class tTimeZone;
+
+/*!
+ * Calendar units that timestamps can be rounded to
+ */
+enum class tCalendarUnit
+{
+  SECOND,
+  MINUTE,
+  HOUR,
+  DAY,
+  WEEK,   //!< ISO 8601 week (starting on Monday)
+  MONTH,
+  YEAR
+};
+
+/*!
+ * Time zone that calendar units refer to
+ */
+enum class tCalendarZone
+{
+  UTC,
+  LOCAL  //!< Local time zone of process (daylight saving time transitions are taken into account)
+};
+
+namespace internal
+{
+
+/*! \return value modulo divisor - always in [0, divisor) (divisor must be positive) */
+constexpr int64_t FloorRemainder(int64_t value, int64_t divisor)
+{
+  return value % divisor < 0 ? value % divisor + divisor : value % divisor;
+}
+
+}
+
+/*!
+ * \param timestamp Timestamp to round
+ * \param bucket Bucket size (positive)
+ * \return Start of bucket that contains timestamp
+ */
+inline tTimestamp Floor(const tTimestamp& timestamp, const tDuration& bucket)
+{
+  return timestamp - tDuration(internal::FloorRemainder(timestamp.time_since_epoch().count(), bucket.count()));
+}
+
+/*!
+ * \param timestamp Timestamp to round
+ * \param bucket Bucket size (positive)
+ * \return Smallest bucket boundary that is not before timestamp
+ */
+inline tTimestamp Ceil(const tTimestamp& timestamp, const tDuration& bucket)
+{
+  tDuration::rep remainder = internal::FloorRemainder(timestamp.time_since_epoch().count(), bucket.count());
+  return remainder ? timestamp + tDuration(bucket.count() - remainder) : timestamp;
+}
+
+/*!
+ * \param timestamp Timestamp to round
+ * \param bucket Bucket size (positive)
+ * \return Bucket boundary closest to timestamp
+ */
+inline tTimestamp Round(const tTimestamp& timestamp, const tDuration& bucket)
+{
+  tDuration::rep remainder = internal::FloorRemainder(timestamp.time_since_epoch().count(), bucket.count());
+  return remainder >= bucket.count() - remainder ? timestamp + tDuration(bucket.count() - remainder) : timestamp - tDuration(remainder);
+}
+
+/*!
+ * \param timestamp Timestamp to round
+ * \param unit Calendar unit
+ * \param zone Time zone that calendar unit refers to
+ * \return Start of calendar unit that contains timestamp (e.g. midnight of the timestamp's day)
+ */
+tTimestamp Floor(const tTimestamp& timestamp, tCalendarUnit unit, tCalendarZone zone = tCalendarZone::UTC);
+
+/*!
+ * \param timestamp Timestamp to round
+ * \param unit Calendar unit
+ * \param zone Time zone that calendar unit refers to
+ * \return Start of next calendar unit - or timestamp if it is at the start of a calendar unit
+ */
+tTimestamp Ceil(const tTimestamp& timestamp, tCalendarUnit unit, tCalendarZone zone = tCalendarZone::UTC);
+
+/*!
+ * \param timestamp Timestamp to round
+ * \param unit Calendar unit
+ * \param zone Time zone that calendar unit refers to
+ * \return Start of calendar unit closest to timestamp
+ */
+tTimestamp Round(const tTimestamp& timestamp, tCalendarUnit unit, tCalendarZone zone = tCalendarZone::UTC);
+
+/*!
+ * Variants of the functions above for time zones from tTimeZone.h
+ * (e.g. Floor(timestamp, tCalendarUnit::DAY, tTimeZone::Get("America/New_York")))
+ */
+tTimestamp Floor(const tTimestamp& timestamp, tCalendarUnit unit, const tTimeZone& zone);
+tTimestamp Ceil(const tTimestamp& timestamp, tCalendarUnit unit, const tTimeZone& zone);
+tTimestamp Round(const tTimestamp& timestamp, tCalendarUnit unit, const tTimeZone& zone);
+
+/*!
+ * Batch variants of the functions above.
+ * As long as consecutive timestamps are in the same bucket (typical for recorded data), the bucket
+ * of the previous timestamp is reused - so that no division or calendar computation is necessary.
+ *
+ * \param input Timestamps to round
+ * \param count Number of timestamps
+ * \param output Array that results are written to (must have 'count' elements - may be identical to 'input')
+ */
+void Floor(const tTimestamp* input, size_t count, const tDuration& bucket, tTimestamp* output);
+void Ceil(const tTimestamp* input, size_t count, const tDuration& bucket, tTimestamp* output);
+void Round(const tTimestamp* input, size_t count, const tDuration& bucket, tTimestamp* output);
+void Floor(const tTimestamp* input, size_t count, tCalendarUnit unit, tTimestamp* output, tCalendarZone zone = tCalendarZone::UTC);
+void Ceil(const tTimestamp* input, size_t count, tCalendarUnit unit, tTimestamp* output, tCalendarZone zone = tCalendarZone::UTC);
+void Round(const tTimestamp* input, size_t count, tCalendarUnit unit, tTimestamp* output, tCalendarZone zone = tCalendarZone::UTC);
+void Floor(const tTimestamp* input, size_t count, tCalendarUnit unit, tTimestamp* output, const tTimeZone& zone);
+void Ceil(const tTimestamp* input, size_t count, tCalendarUnit unit, tTimestamp* output, const tTimeZone& zone);
+void Round(const tTimestamp* input, size_t count, tCalendarUnit unit, tTimestamp* output, const tTimeZone& zone);
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
+
+
+#endif
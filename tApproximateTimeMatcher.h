@@ -0,0 +1,281 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    rrlib/time/tApproximateTimeMatcher.h
+ *
+ * \author  agent
+ *
+ * \date    2026-10-18
+ *
+ * \brief   Contains tApproximateTimeMatcher
+ *
+ * \b tApproximateTimeMatcher
+ *
+ * Pairs records of different streams with approximately equal timestamps
+ * (similar to the ApproximateTime policy of ROS message_filters).
+ *
+ * One stream is the pivot stream (typically the one with the lowest rate - e.g. camera images).
+ * For each record of the pivot stream, the record closest in time is selected from each of the other
+ * streams (e.g. IMU samples or laser scans). If it is within the tolerance for all streams,
+ * the set of records is passed to the callback.
+ * A record of a non-pivot stream may be part of several sets - records of the pivot stream are part of at most one.
+ *
+ * Records must be pushed in timestamp order across all streams - e.g. from tStreamMerger.
+ * A set is complete as soon as a later record of each stream has been pushed (or the tolerance has passed).
+ * Only records within the tolerance of pending pivot records (or of the latest record) are buffered - so memory is bounded.
+ */
+//----------------------------------------------------------------------
+#ifndef __rrlib__time__tApproximateTimeMatcher_h__
+#define __rrlib__time__tApproximateTimeMatcher_h__
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <utility>
+#include <vector>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/time/tStreamMerger.h"
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+#include <cassert>
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace time
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Class declaration
+//----------------------------------------------------------------------
+//! Pairs records of different streams with approximately equal timestamps
+/*!
+ * Callbacks receive 'const std::vector<const TRecord*>& set' with one record per stream
+ * (index in vector is stream index). Pointers are only valid during callback.
+ * If two records are equally close to the pivot record, the earlier one is selected.
+ *
+ * \tparam TRecord Record type
+ * \tparam TGetTimestamp Functor that returns the timestamp of a record
+ */
+template < typename TRecord, typename TGetTimestamp = tGetRecordTimestamp<TRecord> >
+class tApproximateTimeMatcher
+{
+
+//----------------------------------------------------------------------
+// Public methods and typedefs
+//----------------------------------------------------------------------
+public:
+
+  /*!
+   * \param stream_count Number of streams
+   * \param pivot_stream Index of pivot stream
+   * \param tolerance Maximum time difference between pivot record and records of other streams
+   * \param get_timestamp Functor that returns the timestamp of a record
+   */
+  tApproximateTimeMatcher(size_t stream_count, size_t pivot_stream, const tDuration& tolerance, TGetTimestamp get_timestamp = TGetTimestamp()) :
+    pivot_stream(pivot_stream),
+    tolerance(tolerance.count()),
+    get_timestamp(get_timestamp),
+    streams(stream_count),
+    set(stream_count, nullptr),
+    last_time(std::numeric_limits<int64_t>::min()),
+    later_record_count(0)
+  {
+    assert(pivot_stream < stream_count && tolerance.count() >= 0);
+  }
+
+  /*!
+   * Adds record
+   *
+   * \param stream Index of stream that record belongs to
+   * \param record Record (timestamp must not be before that of the previously pushed record)
+   * \param callback Callback for complete sets (see class description)
+   */
+  template <typename TCallback>
+  void Push(size_t stream, const TRecord& record, TCallback callback)
+  {
+    int64_t time = get_timestamp(record).time_since_epoch().count();
+    assert(time >= last_time && "Records must be pushed in timestamp order");
+    last_time = time;
+
+    // Sets of pending pivot records are complete if the tolerance has passed
+    while (pending.size() && time - tolerance > pending.front().first)
+    {
+      Complete(callback);
+    }
+
+    if (stream == pivot_stream)
+    {
+      pending.emplace_back(time, record);
+      if (pending.size() == 1)
+      {
+        CountLaterRecords();
+      }
+    }
+    else
+    {
+      auto& buffer = streams[stream];
+      if (pending.size() && (buffer.empty() || buffer.back().first < pending.front().first))
+      {
+        later_record_count++;
+      }
+      buffer.emplace_back(time, record);
+
+      // Discard records that cannot be part of any set anymore
+      int64_t oldest_relevant = (pending.empty() ? time : pending.front().first) - tolerance;
+      while (buffer.size() > 1 && buffer[1].first < oldest_relevant)
+      {
+        buffer.pop_front();
+      }
+    }
+
+    // ... or if a later record of each stream has been pushed
+    while (pending.size() && later_record_count + 1 == streams.size())
+    {
+      Complete(callback);
+    }
+  }
+
+  /*!
+   * Completes sets of all pending pivot records (e.g. at end of streams)
+   *
+   * \param callback Callback for complete sets (see class description)
+   */
+  template <typename TCallback>
+  void Flush(TCallback callback)
+  {
+    while (pending.size())
+    {
+      Complete(callback);
+    }
+  }
+
+//----------------------------------------------------------------------
+// Private fields and methods
+//----------------------------------------------------------------------
+private:
+
+  typedef std::pair<int64_t, TRecord> tEntry;  // Record with timestamp (nanoseconds since epoch)
+
+  /*! Index of pivot stream */
+  size_t pivot_stream;
+
+  /*! Maximum time difference between pivot record and records of other streams (nanoseconds) */
+  int64_t tolerance;
+
+  /*! Functor that returns timestamp of record */
+  TGetTimestamp get_timestamp;
+
+  /*! Buffered records of non-pivot streams */
+  std::vector<std::deque<tEntry>> streams;
+
+  /*! Pivot records whose sets are not complete yet */
+  std::deque<tEntry> pending;
+
+  /*! Set passed to callback */
+  std::vector<const TRecord*> set;
+
+  /*! Timestamp of last pushed record */
+  int64_t last_time;
+
+  /*! Number of non-pivot streams with a record at or after the first pending pivot record */
+  size_t later_record_count;
+
+  /*! Updates later_record_count for new first pending pivot record */
+  void CountLaterRecords()
+  {
+    later_record_count = 0;
+    for (size_t i = 0; i < streams.size(); i++)
+    {
+      if (i != pivot_stream && pending.size() && streams[i].size() && streams[i].back().first >= pending.front().first)
+      {
+        later_record_count++;
+      }
+    }
+  }
+
+  /*! Selects records for first pending pivot record and calls callback if set is complete */
+  template <typename TCallback>
+  void Complete(TCallback& callback)
+  {
+    const tEntry& pivot = pending.front();
+    bool complete = true;
+    for (size_t i = 0; i < streams.size() && complete; i++)
+    {
+      if (i == pivot_stream)
+      {
+        set[i] = &pivot.second;
+        continue;
+      }
+      auto& buffer = streams[i];
+      auto after = std::lower_bound(buffer.begin(), buffer.end(), pivot.first, [](const tEntry & entry, int64_t time)
+      {
+        return entry.first < time;
+      });
+      const tEntry* closest = nullptr;
+      if (after != buffer.begin() && pivot.first - (after - 1)->first <= tolerance)
+      {
+        auto before = after - 1;
+        while (before != buffer.begin() && (before - 1)->first == before->first)
+        {
+          before--;
+        }
+        closest = &*before;
+      }
+      if (after != buffer.end() && after->first - pivot.first <= tolerance && ((!closest) || after->first - pivot.first < pivot.first - closest->first))
+      {
+        closest = &*after;
+      }
+      complete = closest != nullptr;
+      set[i] = closest ? &closest->second : nullptr;
+    }
+    if (complete)
+    {
+      callback(static_cast<const std::vector<const TRecord*>&>(set));
+    }
+    pending.pop_front();
+    CountLaterRecords();
+  }
+};
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
+
+
+#endif
@@ -73,10 +73,9 @@ class tAtomicDuration
 //----------------------------------------------------------------------
 public:
 
-  tAtomicDuration(const tDuration& duration = tDuration::zero())
-  {
-    Store(duration);
-  }
+  constexpr tAtomicDuration(const tDuration& duration = tDuration::zero()) :
+    wrapped(duration.count())
+  {}
 
   /*!
    * Obtains value from atomic.
@@ -73,25 +73,28 @@ class tAtomicTimestamp
 //----------------------------------------------------------------------
 public:
 
-  tAtomicTimestamp(const tTimestamp& timestamp = tTimestamp())
-  {
-    Store(timestamp);
-  }
+  constexpr tAtomicTimestamp(const tTimestamp& timestamp = tTimestamp()) :
+    wrapped(timestamp.time_since_epoch().count())
+  {}
 
   /*!
    * Obtains value from atomic.
+   *
+   * \param order Memory order of load operation
    */
-  tTimestamp Load() const
+  tTimestamp Load(std::memory_order order = std::memory_order_seq_cst) const
   {
-    return tTimestamp(tDuration(wrapped.load()));
+    return tTimestamp(tDuration(wrapped.load(order)));
   }
 
   /*!
    * Stores value to atomic
+   *
+   * \param order Memory order of store operation
    */
-  void Store(const tTimestamp& timestamp)
+  void Store(const tTimestamp& timestamp, std::memory_order order = std::memory_order_seq_cst)
   {
-    wrapped.store(timestamp.time_since_epoch().count());
+    wrapped.store(timestamp.time_since_epoch().count(), order);
   }
 
 //----------------------------------------------------------------------
@@ -80,6 +80,18 @@ public:
 
   tCustomClock() {}
 
+  virtual ~tCustomClock() {}
+
+  /*!
+   * Called by SleepUntil() and SleepFor() (in time.h) while this clock is the current time source.
+   * Blocks calling thread until "application time" has reached wake-up time - or for some shorter time
+   * (the caller checks time again after this method returns).
+   * The default implementation sleeps at most 10 ms of system time, so that sleeping threads notice calls to SetApplicationTime().
+   *
+   * \param wake_up_time Wake-up time in "application time"
+   */
+  virtual void BlockUntil(const rrlib::time::tTimestamp& wake_up_time) const;
+
   /*!
    * \return True, if this is the current time source for application time
    */
@@ -0,0 +1,210 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    rrlib/time/tCycleCounter.cpp
+ *
+ * \author  agent
+ *
+ * \date    2026-10-18
+ *
+ */
+//----------------------------------------------------------------------
+#include "rrlib/time/tCycleCounter.h"
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <cmath>
+#include <stdexcept>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define RRLIB_TIME_X86_SIMD
+#include <immintrin.h>
+#endif
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+#include <cassert>
+
+//----------------------------------------------------------------------
+// Namespace usage
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace time
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Const values
+//----------------------------------------------------------------------
+
+/*! Number of attempts for taking a snapshot (the one with the shortest interval between the two counter readings is used) */
+static const int cSNAPSHOT_ATTEMPTS = 5;
+
+/*! Fractional bits of fixed-point scale */
+static const int cSCALE_BITS = 48;
+
+//----------------------------------------------------------------------
+// Implementation
+//----------------------------------------------------------------------
+
+/*! Takes snapshot of counter and system time (nanoseconds since epoch) */
+static void TakeSnapshot(uint64_t& cycles, int64_t& time)
+{
+  uint64_t best_interval = UINT64_MAX;
+  for (int i = 0; i < cSNAPSHOT_ATTEMPTS; i++)
+  {
+    uint64_t before = ReadCycleCounter();
+    int64_t now = tBaseClock::now().time_since_epoch().count();
+    uint64_t after = ReadCycleCounter();
+    if (after - before < best_interval)
+    {
+      best_interval = after - before;
+      cycles = before + (after - before) / 2;
+      time = now;
+    }
+  }
+}
+
+#ifdef RRLIB_TIME_X86_SIMD
+
+__attribute__((target("avx2")))
+static size_t ToTimestampsAvx2(const uint64_t* cycles, size_t count, tTimestamp* result, uint64_t start_cycles, int64_t start_time, uint64_t scale_high, uint64_t scale_low)
+{
+  static_assert(sizeof(tTimestamp) == sizeof(int64_t), "Timestamps are stored as int64 values");
+  const __m256i start_cycles_vector = _mm256_set1_epi64x(static_cast<int64_t>(start_cycles));
+  const __m256i start_time_vector = _mm256_set1_epi64x(start_time);
+  const __m256i scale_high_vector = _mm256_set1_epi64x(static_cast<int64_t>(scale_high));
+  const __m256i scale_low_vector = _mm256_set1_epi64x(static_cast<int64_t>(scale_low));
+  const __m256i zero = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    __m256i difference = _mm256_sub_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(cycles + i)), start_cycles_vector);
+    __m256i negative = _mm256_cmpgt_epi64(zero, difference);
+    __m256i magnitude = _mm256_sub_epi64(_mm256_xor_si256(difference, negative), negative);
+    __m256i high = _mm256_srli_epi64(magnitude, 32);
+
+    // same computation as tCycleCalibration::Scale() (_mm256_mul_epu32 multiplies lower 32 bits of each element)
+    __m256i product = _mm256_slli_epi64(_mm256_mul_epu32(high, scale_high_vector), 16);
+    product = _mm256_add_epi64(product, _mm256_srli_epi64(_mm256_mul_epu32(high, scale_low_vector), 16));
+    product = _mm256_add_epi64(product, _mm256_srli_epi64(_mm256_mul_epu32(magnitude, scale_high_vector), 16));
+    product = _mm256_add_epi64(product, _mm256_srli_epi64(_mm256_mul_epu32(magnitude, scale_low_vector), 48));
+    product = _mm256_sub_epi64(_mm256_xor_si256(product, negative), negative);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(result + i), _mm256_add_epi64(product, start_time_vector));
+  }
+  return i;
+}
+
+#endif
+
+tCycleCalibration::tCycleCalibration() :
+  start_cycles(0),
+  start_time(0),
+  scale_high(0),
+  scale_low(0)
+{
+  TakeSnapshot(start_cycles, start_time);
+}
+
+void tCycleCalibration::Stop()
+{
+  uint64_t end_cycles = 0;
+  int64_t end_time = 0;
+  TakeSnapshot(end_cycles, end_time);
+  if (end_cycles <= start_cycles)
+  {
+    throw std::runtime_error("Cycle counter has not advanced during calibration");
+  }
+  double scale = std::ldexp(static_cast<double>(end_time - start_time) / static_cast<double>(end_cycles - start_cycles), cSCALE_BITS);
+  if (!(scale >= 0 && scale < std::ldexp(1.0, 64)))
+  {
+    throw std::runtime_error("Cycle counter frequency is too low for conversion (or system clock was adjusted during calibration)");
+  }
+  uint64_t fixed_point_scale = static_cast<uint64_t>(scale + 0.5);
+  scale_high = fixed_point_scale >> 32;
+  scale_low = fixed_point_scale & 0xFFFFFFFF;
+}
+
+double tCycleCalibration::GetFrequency() const
+{
+  double nanoseconds_per_cycle = std::ldexp(static_cast<double>((scale_high << 32) | scale_low), -cSCALE_BITS);
+  return nanoseconds_per_cycle > 0 ? 1e9 / nanoseconds_per_cycle : 0;
+}
+
+void tCycleCalibration::ToTimestamps(const uint64_t* cycles, size_t count, tTimestamp* result) const
+{
+  size_t i = 0;
+#ifdef RRLIB_TIME_X86_SIMD
+  static const bool avx2 = __builtin_cpu_supports("avx2");
+  if (avx2)
+  {
+    i = ToTimestampsAvx2(cycles, count, result, start_cycles, start_time, scale_high, scale_low);
+  }
+#endif
+  for (; i < count; i++)
+  {
+    result[i] = ToTimestamp(cycles[i]);
+  }
+}
+
+tCycleCapture::tCycleCapture(size_t capacity) :
+  cycles(capacity),
+  size(0),
+  calibration()
+{}
+
+void tCycleCapture::Start()
+{
+  size = 0;
+  calibration = tCycleCalibration();
+}
+
+void tCycleCapture::Stop()
+{
+  calibration.Stop();
+}
+
+std::vector<tTimestamp> tCycleCapture::GetTimestamps() const
+{
+  std::vector<tTimestamp> result(size);
+  calibration.ToTimestamps(cycles.data(), size, result.data());
+  return result;
+}
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
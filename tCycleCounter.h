@@ -0,0 +1,281 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    rrlib/time/tCycleCounter.h
+ *
+ * \author  agent
+ *
+ * \date    2026-10-18
+ *
+ * \brief   Contains ReadCycleCounter(), tCycleCalibration and tCycleCapture
+ *
+ * Time measurement in very tight loops: Instead of calling tBaseClock::now() for every event,
+ * only the CPU's cycle counter is read (a few nanoseconds - e.g. TSC on x86).
+ * Raw counter values are converted to timestamps afterwards - in batches.
+ *
+ * \b tCycleCalibration
+ *
+ * Relates cycle counter to system time: Snapshots of both are taken at start and end of a capture.
+ * Counter values in between are converted by linear interpolation.
+ *
+ * \b tCycleCapture
+ *
+ * Buffer for raw counter values with calibration.
+ *
+ * Counter values are only comparable on CPUs with a constant-rate counter that is synchronized
+ * across cores (e.g. 'constant_tsc' and 'nonstop_tsc' in /proc/cpuinfo). On platforms without a
+ * supported counter, ReadCycleCounter() reads the steady clock (still without conversion to tTimestamp).
+ *
+ * Example:
+ *   tCycleCapture capture(100000);
+ *   capture.Start();
+ *   while (...)
+ *   {
+ *     capture.Capture();
+ *     ...
+ *   }
+ *   capture.Stop();
+ *   std::vector<tTimestamp> timestamps = capture.GetTimestamps();
+ */
+//----------------------------------------------------------------------
+#ifndef __rrlib__time__tCycleCounter_h__
+#define __rrlib__time__tCycleCounter_h__
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <cstdint>
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#endif
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/time/time.h"
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace time
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+/*!
+ * \return Current value of CPU cycle counter (TSC on x86, virtual counter on ARMv8 - steady clock nanoseconds on other platforms)
+ */
+inline uint64_t ReadCycleCounter()
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  return __rdtsc();
+#elif defined(__GNUC__) && defined(__aarch64__)
+  uint64_t value;
+  asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+  return value;
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+//----------------------------------------------------------------------
+// Class declaration
+//----------------------------------------------------------------------
+//! Conversion of cycle counter values to timestamps
+/*!
+ * Created at start of capture. Stop() needs to be called at its end - before values can be converted.
+ * The longer the interval between start and end, the more accurate the conversion is
+ * (system clock resolution and the time for reading clocks cause an error of about 100 ns at each snapshot).
+ * Counter values outside of this interval are extrapolated.
+ */
+class tCycleCalibration
+{
+
+//----------------------------------------------------------------------
+// Public methods and typedefs
+//----------------------------------------------------------------------
+public:
+
+  /*! Takes snapshot for start of capture */
+  tCycleCalibration();
+
+  /*!
+   * Takes snapshot for end of capture (if called again, end snapshot is replaced)
+   *
+   * \throws std::runtime_error if counter has not advanced or runs at less than 16 kHz
+   */
+  void Stop();
+
+  /*!
+   * \return Frequency of cycle counter in Hz (zero before Stop() was called)
+   */
+  double GetFrequency() const;
+
+  /*!
+   * \param cycles Counter value
+   * \return Timestamp corresponding to counter value
+   */
+  tTimestamp ToTimestamp(uint64_t cycles) const
+  {
+    return tTimestamp(tDuration(start_time + Scale(static_cast<int64_t>(cycles - start_cycles))));
+  }
+
+  /*!
+   * \param cycles Difference of counter values
+   * \return Duration corresponding to difference of counter values
+   */
+  tDuration ToDuration(int64_t cycles) const
+  {
+    return tDuration(Scale(cycles));
+  }
+
+  /*!
+   * Converts many counter values to timestamps (using AVX2 instructions if available).
+   * Results are identical to calling ToTimestamp() for each value.
+   *
+   * \param cycles Counter values
+   * \param count Number of counter values
+   * \param result Array that timestamps are written to (must have 'count' elements)
+   */
+  void ToTimestamps(const uint64_t* cycles, size_t count, tTimestamp* result) const;
+
+//----------------------------------------------------------------------
+// Private fields and methods
+//----------------------------------------------------------------------
+private:
+
+  /*! Counter value and system time (nanoseconds since epoch) at start */
+  uint64_t start_cycles;
+  int64_t start_time;
+
+  /*! Nanoseconds per cycle as fixed-point number with 48 fractional bits (split in upper and lower 32 bits) */
+  uint64_t scale_high, scale_low;
+
+  /*! \return Nanoseconds corresponding to difference of counter values */
+  int64_t Scale(int64_t cycles) const
+  {
+    // 64x64 bit multiplication composed of 32x32 bit multiplications (as in vectorized variant)
+    uint64_t magnitude = cycles < 0 ? 0 - static_cast<uint64_t>(cycles) : static_cast<uint64_t>(cycles);
+    uint64_t high = magnitude >> 32, low = magnitude & 0xFFFFFFFF;
+    uint64_t result = ((high * scale_high) << 16) + ((high * scale_low) >> 16) + ((low * scale_high) >> 16) + ((low * scale_low) >> 48);
+    return cycles < 0 ? -static_cast<int64_t>(result) : static_cast<int64_t>(result);
+  }
+};
+
+//----------------------------------------------------------------------
+// Class declaration
+//----------------------------------------------------------------------
+//! Buffer for cycle counter values
+/*!
+ * Stores counter values in preallocated buffer. Not thread-safe (one capture per thread).
+ */
+class tCycleCapture
+{
+
+//----------------------------------------------------------------------
+// Public methods and typedefs
+//----------------------------------------------------------------------
+public:
+
+  /*!
+   * \param capacity Maximum number of captured counter values
+   */
+  explicit tCycleCapture(size_t capacity);
+
+  /*! Clears buffer and starts capture (takes calibration snapshot) */
+  void Start();
+
+  /*!
+   * Stores current counter value (ignored if buffer is full)
+   */
+  void Capture()
+  {
+    if (size < cycles.size())
+    {
+      cycles[size++] = ReadCycleCounter();
+    }
+  }
+
+  /*!
+   * Ends capture (takes calibration snapshot)
+   *
+   * \throws std::runtime_error if calibration fails (see tCycleCalibration::Stop())
+   */
+  void Stop();
+
+  /*!
+   * \return Calibration of current capture
+   */
+  const tCycleCalibration& GetCalibration() const
+  {
+    return calibration;
+  }
+
+  /*!
+   * \return Captured counter values
+   */
+  const uint64_t* GetCycles() const
+  {
+    return cycles.data();
+  }
+
+  /*!
+   * \return Number of captured counter values
+   */
+  size_t GetSize() const
+  {
+    return size;
+  }
+
+  /*!
+   * \return Captured counter values converted to timestamps (capture must be stopped)
+   */
+  std::vector<tTimestamp> GetTimestamps() const;
+
+//----------------------------------------------------------------------
+// Private fields and methods
+//----------------------------------------------------------------------
+private:
+
+  /*! Buffer for counter values */
+  std::vector<uint64_t> cycles;
+
+  /*! Number of captured values */
+  size_t size;
+
+  /*! Calibration of current capture */
+  tCycleCalibration calibration;
+};
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
+
+
+#endif
@@ -0,0 +1,202 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    rrlib/time/tIsoTimestampFormatter.cpp
+ *
+ * \author  agent
+ *
+ * \date    2026-10-18
+ *
+ */
+//----------------------------------------------------------------------
+#include "rrlib/time/tIsoTimestampFormatter.h"
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <cstring>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/time/calendar.h"
+#include "rrlib/time/tTimeZone.h"
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+#include <cassert>
+
+//----------------------------------------------------------------------
+// Namespace usage
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace time
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Const values
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Implementation
+//----------------------------------------------------------------------
+
+/*! Writes 'digits' decimal digits of value to buffer (with leading zeros) */
+static inline void WriteDigits(char* buffer, unsigned int value, int digits)
+{
+  for (int i = digits - 1; i >= 0; i--)
+  {
+    buffer[i] = '0' + (value % 10);
+    value /= 10;
+  }
+}
+
+tIsoTimestampFormatter::tIsoTimestampFormatter() :
+  zone(nullptr),
+  cached_second(0),
+  cache_valid(false)
+{
+  memset(prefix, 0, sizeof(prefix));
+  memset(time_zone, 0, sizeof(time_zone));
+}
+
+tIsoTimestampFormatter::tIsoTimestampFormatter(const tTimeZone& zone) :
+  tIsoTimestampFormatter()
+{
+  this->zone = &zone;
+}
+
+size_t tIsoTimestampFormatter::Format(const tTimestamp& timestamp, char* buffer)
+{
+  int64_t ticks = std::chrono::duration_cast<std::chrono::nanoseconds>(timestamp.time_since_epoch()).count();
+  int64_t second = ticks / 1000000000;
+  int ns = static_cast<int>(ticks % 1000000000);
+  if (ns < 0)
+  {
+    ns += 1000000000;
+    second--;
+  }
+
+  if ((!cache_valid) || second != cached_second)
+  {
+    UpdateCache(static_cast<time_t>(second));
+  }
+
+  memcpy(buffer, prefix, 19);
+  char* c = buffer + 19;
+  if (ns != 0)
+  {
+    *c = '.';
+    c++;
+    if (ns % 1000000 == 0)
+    {
+      WriteDigits(c, ns / 1000000, 3);
+      c += 3;
+    }
+    else if (ns % 1000 == 0)
+    {
+      WriteDigits(c, ns / 1000, 6);
+      c += 6;
+    }
+    else
+    {
+      WriteDigits(c, ns, 9);
+      c += 9;
+    }
+  }
+  memcpy(c, time_zone, 6);
+  c += 6;
+  *c = 0;
+  return c - buffer;
+}
+
+tIsoTimestampFormatter& tIsoTimestampFormatter::ThreadLocalInstance()
+{
+  static thread_local tIsoTimestampFormatter instance;
+  return instance;
+}
+
+void tIsoTimestampFormatter::UpdateCache(time_t second)
+{
+  long offset_seconds = 0;
+  if (zone)
+  {
+    offset_seconds = zone->GetUtcOffsetSeconds(second);
+    int64_t local = second + offset_seconds;
+    int64_t second_of_day = local % 86400;
+    if (second_of_day < 0)
+    {
+      second_of_day += 86400;
+    }
+    tCivilDate date = CivilFromDays((local - second_of_day) / 86400);
+    WriteDigits(prefix, static_cast<unsigned int>(date.year), 4);
+    prefix[4] = '-';
+    WriteDigits(&prefix[5], date.month, 2);
+    prefix[7] = '-';
+    WriteDigits(&prefix[8], date.day, 2);
+    prefix[10] = 'T';
+    WriteDigits(&prefix[11], second_of_day / 3600, 2);
+    prefix[13] = ':';
+    WriteDigits(&prefix[14], (second_of_day / 60) % 60, 2);
+    prefix[16] = ':';
+    WriteDigits(&prefix[17], second_of_day % 60, 2);
+  }
+  else
+  {
+    tm tmp;
+    memset(&tmp, 0, sizeof(tmp));
+    localtime_r(&second, &tmp);
+    size_t length = strftime(prefix, sizeof(prefix), "%FT%T", &tmp);
+    assert(length == 19);
+    (void)length;
+    offset_seconds = tmp.tm_gmtoff;
+  }
+
+  // same as strftime's "%z" - with colon inserted
+  long offset_minutes = offset_seconds / 60;
+  time_zone[0] = offset_minutes < 0 ? '-' : '+';
+  if (offset_minutes < 0)
+  {
+    offset_minutes = -offset_minutes;
+  }
+  WriteDigits(&time_zone[1], offset_minutes / 60, 2);
+  time_zone[3] = ':';
+  WriteDigits(&time_zone[4], offset_minutes % 60, 2);
+
+  cached_second = second;
+  cache_valid = true;
+}
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
@@ -0,0 +1,157 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    rrlib/time/tIsoTimestampFormatter.h
+ *
+ * \author  agent
+ *
+ * \date    2026-10-18
+ *
+ * \brief   Contains tIsoTimestampFormatter
+ *
+ * \b tIsoTimestampFormatter
+ *
+ * Formats timestamps as ISO 8601 strings (local time zone).
+ * Date, time and time zone of the last formatted second are cached,
+ * so that formatting consecutive timestamps of the same second
+ * merely requires writing the sub-second digits.
+ *
+ */
+//----------------------------------------------------------------------
+#ifndef __rrlib__time__tIsoTimestampFormatter_h__
+#define __rrlib__time__tIsoTimestampFormatter_h__
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <ctime>
+#include <string>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/time/time.h"
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace time
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+class tTimeZone;
+
+//----------------------------------------------------------------------
+// Class declaration
+//----------------------------------------------------------------------
+//! ISO 8601 timestamp formatter
+/*!
+ * Turns timestamps into ISO 8601 strings - with output identical to ToIsoString().
+ *
+ * The rendered "YYYY-MM-DDTHH:MM:SS" prefix and the "+HH:MM" time zone suffix
+ * of the last formatted second are cached. They are only rebuilt when a timestamp
+ * from another second is formatted (the UTC offset can only change with the second).
+ *
+ * Objects are not thread-safe. ThreadLocalInstance() provides a formatter for the calling thread.
+ */
+class tIsoTimestampFormatter
+{
+
+//----------------------------------------------------------------------
+// Public methods and typedefs
+//----------------------------------------------------------------------
+public:
+
+  /*! Maximum number of characters written by Format() (without terminating zero) */
+  enum { cMAX_LENGTH = 19 + 10 + 6 };
+
+  /*!
+   * Creates formatter for process' local time zone
+   */
+  tIsoTimestampFormatter();
+
+  /*!
+   * Creates formatter for specified time zone
+   * (zone must exist as long as formatter is used - e.g. from tTimeZone::Get())
+   */
+  explicit tIsoTimestampFormatter(const tTimeZone& zone);
+
+  /*!
+   * Formats timestamp into buffer
+   *
+   * \param timestamp Timestamp to format
+   * \param buffer Buffer to write to. Must provide space for at least cMAX_LENGTH + 1 characters.
+   * \return Number of characters written (buffer is zero-terminated)
+   */
+  size_t Format(const tTimestamp& timestamp, char* buffer);
+
+  /*!
+   * \param timestamp Timestamp to format
+   * \return ISO 8601 representation of timestamp
+   */
+  std::string Format(const tTimestamp& timestamp)
+  {
+    char buffer[cMAX_LENGTH + 1];
+    size_t length = Format(timestamp, buffer);
+    return std::string(buffer, length);
+  }
+
+  /*!
+   * \return Formatter for the calling thread (used by ToIsoString())
+   */
+  static tIsoTimestampFormatter& ThreadLocalInstance();
+
+//----------------------------------------------------------------------
+// Private fields and methods
+//----------------------------------------------------------------------
+private:
+
+  /*! Time zone for formatting (nullptr for local time zone) */
+  const tTimeZone* zone;
+
+  /*! Second that prefix and time zone are currently cached for */
+  time_t cached_second;
+
+  /*! Is cache valid? */
+  bool cache_valid;
+
+  /*! Cached "YYYY-MM-DDTHH:MM:SS" prefix (tTimestamp's range is limited to years with four digits) */
+  char prefix[20];
+
+  /*! Cached "+HH:MM" time zone suffix */
+  char time_zone[6];
+
+  /*! Renders prefix and time zone for specified second */
+  void UpdateCache(time_t second);
+};
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
+
+
+#endif
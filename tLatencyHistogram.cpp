@@ -0,0 +1,218 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    rrlib/time/tLatencyHistogram.cpp
+ *
+ * \author  agent
+ *
+ * \date    2026-10-18
+ *
+ */
+//----------------------------------------------------------------------
+#include "rrlib/time/tLatencyHistogram.h"
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+#include <cassert>
+
+//----------------------------------------------------------------------
+// Namespace usage
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace time
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Const values
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Implementation
+//----------------------------------------------------------------------
+
+thread_local tLatencyHistogram::tThreadCacheEntry tLatencyHistogram::thread_cache[cTHREAD_CACHE_SIZE];
+
+namespace
+{
+
+/*! Source of unique histogram ids (0 marks unused cache entries) */
+std::atomic<uint64_t> next_histogram_id(1);
+
+/*! \return Largest value that is recorded in bucket with specified index */
+uint64_t BucketMaxValue(size_t index)
+{
+  if (index < 2 * internal::cLATENCY_SUB_BUCKET_COUNT)
+  {
+    return index;
+  }
+  unsigned int shift = (index >> internal::cLATENCY_SUB_BUCKET_BITS) - 1;
+  uint64_t lowest = static_cast<uint64_t>((index & (internal::cLATENCY_SUB_BUCKET_COUNT - 1)) + internal::cLATENCY_SUB_BUCKET_COUNT) << shift;
+  return lowest + ((static_cast<uint64_t>(1) << shift) - 1);
+}
+
+}
+
+tLatencySnapshot::tLatencySnapshot() :
+  buckets(internal::cLATENCY_BUCKET_COUNT, 0),
+  count(0),
+  sum(0),
+  min(std::numeric_limits<uint64_t>::max()),
+  max(0)
+{}
+
+void tLatencySnapshot::Record(const tDuration& duration)
+{
+  uint64_t value = duration.count() < 0 ? 0 : static_cast<uint64_t>(duration.count());
+  buckets[internal::LatencyBucketIndex(value)]++;
+  count++;
+  sum += value;
+  min = std::min(min, value);
+  max = std::max(max, value);
+}
+
+void tLatencySnapshot::Merge(const tLatencySnapshot& other)
+{
+  for (size_t i = 0; i < buckets.size(); i++)
+  {
+    buckets[i] += other.buckets[i];
+  }
+  count += other.count;
+  sum += other.sum;
+  min = std::min(min, other.min);
+  max = std::max(max, other.max);
+}
+
+tDuration tLatencySnapshot::GetPercentile(double percentile) const
+{
+  // Bucket counts are used (count may differ slightly in snapshots taken while recording)
+  uint64_t total = 0;
+  for (uint64_t bucket_count : buckets)
+  {
+    total += bucket_count;
+  }
+  if (total == 0)
+  {
+    return tDuration::zero();
+  }
+  percentile = std::max(0.0, std::min(100.0, percentile));
+  uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(percentile / 100.0 * total)));
+  uint64_t cumulated = 0;
+  for (size_t i = 0; i < buckets.size(); i++)
+  {
+    cumulated += buckets[i];
+    if (cumulated >= rank)
+    {
+      return tDuration(static_cast<int64_t>(std::max(min, std::min(max, BucketMaxValue(i)))));
+    }
+  }
+  return GetMax();
+}
+
+std::string tLatencySnapshot::ToString() const
+{
+  std::ostringstream stream;
+  stream << "count: " << count << "  min: " << time::ToString(GetMin()) << "  mean: " << time::ToString(GetMean());
+  const double cPERCENTILES[] = { 50, 90, 99, 99.9 };
+  for (double percentile : cPERCENTILES)
+  {
+    stream << "  p" << percentile << ": " << time::ToString(GetPercentile(percentile));
+  }
+  stream << "  max: " << time::ToString(GetMax());
+  return stream.str();
+}
+
+tLatencyHistogram::tRecorder::tRecorder() :
+  thread(std::this_thread::get_id()),
+  buckets(internal::cLATENCY_BUCKET_COUNT),
+  count(0),
+  sum(0),
+  min(std::numeric_limits<uint64_t>::max()),
+  max(0)
+{
+  for (auto & bucket : buckets)
+  {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+}
+
+tLatencyHistogram::tLatencyHistogram() :
+  id(next_histogram_id++)
+{}
+
+tLatencySnapshot tLatencyHistogram::GetSnapshot() const
+{
+  tLatencySnapshot result;
+  std::lock_guard<std::mutex> lock(mutex);
+  for (auto & recorder : recorders)
+  {
+    for (size_t i = 0; i < result.buckets.size(); i++)
+    {
+      result.buckets[i] += recorder->buckets[i].load(std::memory_order_relaxed);
+    }
+    result.count += recorder->count.load(std::memory_order_relaxed);
+    result.sum += recorder->sum.load(std::memory_order_relaxed);
+    result.min = std::min(result.min, recorder->min.load(std::memory_order_relaxed));
+    result.max = std::max(result.max, recorder->max.load(std::memory_order_relaxed));
+  }
+  return result;
+}
+
+tLatencyHistogram::tRecorder& tLatencyHistogram::LookupThreadRecorder()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  for (auto & recorder : recorders)
+  {
+    if (recorder->thread == std::this_thread::get_id())
+    {
+      return *recorder;
+    }
+  }
+  recorders.emplace_back(new tRecorder());
+  return *recorders.back();
+}
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
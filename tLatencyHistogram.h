@@ -0,0 +1,336 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    rrlib/time/tLatencyHistogram.h
+ *
+ * \author  agent
+ *
+ * \date    2026-10-18
+ *
+ * \brief   Contains tLatencyHistogram and tLatencySnapshot
+ *
+ * \b tLatencyHistogram
+ *
+ * Histogram for recording durations (e.g. latencies measured with Now()) from multiple threads.
+ * Recording is wait-free and takes only a few nanoseconds - so it can stay enabled in production code.
+ *
+ * \b tLatencySnapshot
+ *
+ * Copy of histogram data for evaluation: count, minimum, maximum, mean and percentiles.
+ * Snapshots can be merged (e.g. histograms of several processes or time intervals).
+ *
+ * Buckets are log-linear (as in HdrHistogram): Durations below 256 nanoseconds are recorded exactly.
+ * Each further power of two is split into 128 equally sized buckets. So the relative error of
+ * percentiles is below 1% over the whole range of tDuration. Minimum, maximum and mean are exact.
+ *
+ * Example:
+ *   static tLatencyHistogram histogram;
+ *   tTimestamp start = Now();
+ *   ...
+ *   histogram.Record(Now() - start);
+ *   ...
+ *   RRLIB_LOG_PRINT(DEBUG, histogram.GetSnapshot().ToString());
+ */
+//----------------------------------------------------------------------
+#ifndef __rrlib__time__tLatencyHistogram_h__
+#define __rrlib__time__tLatencyHistogram_h__
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/time/time.h"
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace time
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+namespace internal
+{
+
+/*! Number of buckets per power of two (values below 2 * cLATENCY_SUB_BUCKET_COUNT have one bucket per nanosecond) */
+enum { cLATENCY_SUB_BUCKET_BITS = 7, cLATENCY_SUB_BUCKET_COUNT = 1 << cLATENCY_SUB_BUCKET_BITS };
+
+/*! Number of buckets (covers all 64 bit values) */
+enum { cLATENCY_BUCKET_COUNT = (64 - cLATENCY_SUB_BUCKET_BITS + 1) << cLATENCY_SUB_BUCKET_BITS };
+
+/*! \return Index of bucket for duration in nanoseconds */
+inline size_t LatencyBucketIndex(uint64_t value)
+{
+  if (value < cLATENCY_SUB_BUCKET_COUNT)
+  {
+    return static_cast<size_t>(value);
+  }
+  unsigned int shift = 63 - __builtin_clzll(value) - cLATENCY_SUB_BUCKET_BITS;
+  return ((shift + 1) << cLATENCY_SUB_BUCKET_BITS) + static_cast<size_t>((value >> shift) - cLATENCY_SUB_BUCKET_COUNT);
+}
+
+}
+
+//----------------------------------------------------------------------
+// Class declaration
+//----------------------------------------------------------------------
+//! Histogram data for evaluation
+/*!
+ * Plain (not thread-safe) histogram - obtained from tLatencyHistogram::GetSnapshot()
+ * or filled directly via Record().
+ */
+class tLatencySnapshot
+{
+
+//----------------------------------------------------------------------
+// Public methods and typedefs
+//----------------------------------------------------------------------
+public:
+
+  /*! Creates empty snapshot */
+  tLatencySnapshot();
+
+  /*!
+   * Records duration (negative durations are recorded as zero)
+   *
+   * \param duration Duration to record
+   */
+  void Record(const tDuration& duration);
+
+  /*!
+   * Adds all recorded durations of other snapshot to this one
+   *
+   * \param other Other snapshot
+   */
+  void Merge(const tLatencySnapshot& other);
+
+  /*!
+   * \return Number of recorded durations
+   */
+  uint64_t GetCount() const
+  {
+    return count;
+  }
+
+  /*!
+   * \return Smallest recorded duration (zero if no durations were recorded)
+   */
+  tDuration GetMin() const
+  {
+    return count ? tDuration(min) : tDuration::zero();
+  }
+
+  /*!
+   * \return Largest recorded duration (zero if no durations were recorded)
+   */
+  tDuration GetMax() const
+  {
+    return tDuration(max);
+  }
+
+  /*!
+   * \return Mean of recorded durations (zero if no durations were recorded)
+   */
+  tDuration GetMean() const
+  {
+    return count ? tDuration(static_cast<int64_t>(sum / count)) : tDuration::zero();
+  }
+
+  /*!
+   * \param percentile Percentile (0 to 100 - e.g. 99.9)
+   * \return Duration that 'percentile' percent of the recorded durations do not exceed (with the histogram's precision - zero if no durations were recorded)
+   */
+  tDuration GetPercentile(double percentile) const;
+
+  /*!
+   * \return Summary with count, minimum, mean, 50th, 90th, 99th, 99.9th percentile and maximum (e.g. "count: 1000  min: 1.200 us  mean: 2.500 us  p50: 2.300 us ...")
+   */
+  std::string ToString() const;
+
+//----------------------------------------------------------------------
+// Private fields and methods
+//----------------------------------------------------------------------
+private:
+
+  friend class tLatencyHistogram;
+
+  /*! Number of recorded durations in each bucket */
+  std::vector<uint64_t> buckets;
+
+  /*! Number, sum, minimum and maximum of recorded durations (nanoseconds) */
+  uint64_t count, sum, min, max;
+};
+
+//----------------------------------------------------------------------
+// Class declaration
+//----------------------------------------------------------------------
+//! Thread-safe latency histogram
+/*!
+ * Every thread that records durations gets its own set of counters (tRecorder).
+ * As each counter has only one writer, recording requires no atomic read-modify-write operations and no locks.
+ * Snapshots merge the counters of all threads (they may be taken while other threads record durations).
+ * Counters of threads that terminated remain part of the histogram.
+ */
+class tLatencyHistogram
+{
+
+//----------------------------------------------------------------------
+// Public methods and typedefs
+//----------------------------------------------------------------------
+public:
+
+  /*! Counters of one thread */
+  class tRecorder
+  {
+  public:
+
+    /*!
+     * Records duration (negative durations are recorded as zero).
+     * May only be called by the thread that obtained this recorder.
+     *
+     * \param duration Duration to record
+     */
+    void Record(const tDuration& duration)
+    {
+      uint64_t value = duration.count() < 0 ? 0 : static_cast<uint64_t>(duration.count());
+      Increment(buckets[internal::LatencyBucketIndex(value)], 1);
+      Increment(count, 1);
+      Increment(sum, value);
+      if (value < min.load(std::memory_order_relaxed))
+      {
+        min.store(value, std::memory_order_relaxed);
+      }
+      if (value > max.load(std::memory_order_relaxed))
+      {
+        max.store(value, std::memory_order_relaxed);
+      }
+    }
+
+  private:
+
+    friend class tLatencyHistogram;
+
+    /*! Thread that this recorder belongs to */
+    std::thread::id thread;
+
+    /*! Counters (see tLatencySnapshot) */
+    std::vector<std::atomic<uint64_t>> buckets;
+    std::atomic<uint64_t> count, sum, min, max;
+
+    tRecorder();
+
+    /*! Adds value to counter (only written by one thread - so no atomic read-modify-write is necessary) */
+    static void Increment(std::atomic<uint64_t>& counter, uint64_t value)
+    {
+      counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+  };
+
+  tLatencyHistogram();
+
+  tLatencyHistogram(const tLatencyHistogram&) = delete;
+  tLatencyHistogram& operator=(const tLatencyHistogram&) = delete;
+
+  /*!
+   * Records duration (negative durations are recorded as zero)
+   *
+   * \param duration Duration to record
+   */
+  void Record(const tDuration& duration)
+  {
+    GetThreadRecorder().Record(duration);
+  }
+
+  /*!
+   * Obtains recorder of current thread.
+   * Recording via the returned recorder saves the lookup of the thread's recorder
+   * (a few nanoseconds - relevant in tight loops only).
+   *
+   * \return Recorder of current thread (valid as long as histogram exists)
+   */
+  tRecorder& GetThreadRecorder()
+  {
+    tThreadCacheEntry& entry = thread_cache[id % cTHREAD_CACHE_SIZE];
+    if (entry.histogram_id != id)
+    {
+      entry.histogram_id = id;
+      entry.recorder = &LookupThreadRecorder();
+    }
+    return *entry.recorder;
+  }
+
+  /*!
+   * \return Snapshot of all durations recorded so far (by all threads)
+   */
+  tLatencySnapshot GetSnapshot() const;
+
+//----------------------------------------------------------------------
+// Private fields and methods
+//----------------------------------------------------------------------
+private:
+
+  /*! Number of histograms whose recorders are cached per thread */
+  enum { cTHREAD_CACHE_SIZE = 8 };
+
+  /*! Entry in per-thread cache of recorders */
+  struct tThreadCacheEntry
+  {
+    uint64_t histogram_id;
+    tRecorder* recorder;
+  };
+
+  /*! Per-thread cache of recorders (indexed by histogram id) */
+  static thread_local tThreadCacheEntry thread_cache[cTHREAD_CACHE_SIZE];
+
+  /*! Unique id of this histogram (ids are never reused - so cache entries of deleted histograms never match) */
+  const uint64_t id;
+
+  /*! Recorders of all threads that recorded durations */
+  std::vector<std::unique_ptr<tRecorder>> recorders;
+
+  /*! Mutex for recorders */
+  mutable std::mutex mutex;
+
+  /*! \return Recorder of current thread (created if it does not exist yet) */
+  tRecorder& LookupThreadRecorder();
+};
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
+
+
+#endif
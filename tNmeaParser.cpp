@@ -0,0 +1,288 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    rrlib/time/tNmeaParser.cpp
+ *
+ * \author  agent
+ *
+ * \date    2026-10-18
+ *
+ */
+//----------------------------------------------------------------------
+#include "rrlib/time/tNmeaParser.h"
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <cstring>
+#include <stdexcept>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/time/calendar.h"
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+#include <cassert>
+
+//----------------------------------------------------------------------
+// Namespace usage
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace time
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+namespace
+{
+
+/*! Field in NMEA sentence */
+struct tField
+{
+  const char* data;
+  size_t length;
+};
+
+}
+
+//----------------------------------------------------------------------
+// Const values
+//----------------------------------------------------------------------
+
+/*! Maximum number of fields that are separated (RMC date is field 9) */
+static const size_t cMAX_FIELDS = 12;
+
+//----------------------------------------------------------------------
+// Implementation
+//----------------------------------------------------------------------
+
+/*! Parses 'count' decimal digits - returns -1 if there are non-digit characters */
+static inline int ParseNmeaDigits(const char* data, size_t count)
+{
+  int value = 0;
+  for (size_t i = 0; i < count; i++)
+  {
+    unsigned int digit = static_cast<unsigned char>(data[i]) - '0';
+    if (digit > 9)
+    {
+      return -1;
+    }
+    value = value * 10 + digit;
+  }
+  return value;
+}
+
+/*! \return Value of hexadecimal digit - or -1 */
+static inline int ParseHexDigit(char c)
+{
+  return (c >= '0' && c <= '9') ? c - '0' : ((c >= 'A' && c <= 'F') ? c - 'A' + 10 : ((c >= 'a' && c <= 'f') ? c - 'a' + 10 : -1));
+}
+
+/*!
+ * Parses NMEA time field (HHMMSS{.S*})
+ *
+ * \param nanoseconds_of_day Result: nanoseconds since midnight
+ * \return True if field is valid
+ */
+static bool ParseNmeaTime(const char* data, size_t length, int64_t& nanoseconds_of_day)
+{
+  if (length < 6 || (length > 6 && data[6] != '.'))
+  {
+    return false;
+  }
+  int hour = ParseNmeaDigits(data, 2), minute = ParseNmeaDigits(data + 2, 2), second = ParseNmeaDigits(data + 4, 2);
+  if (hour < 0 || hour > 23 || minute < 0 || minute > 59 || second < 0 || second > 60)
+  {
+    return false;
+  }
+  int64_t nanoseconds = 0;
+  int64_t scale = 100000000;
+  for (size_t i = 7; i < length; i++)
+  {
+    unsigned int digit = static_cast<unsigned char>(data[i]) - '0';
+    if (digit > 9)
+    {
+      return false;
+    }
+    nanoseconds += digit * scale;
+    scale /= 10;
+  }
+  nanoseconds_of_day = (hour * 3600 + minute * 60 + second) * 1000000000LL + nanoseconds;
+  return true;
+}
+
+/*! \return Timestamp for specified date and time of day (or false if date is invalid) */
+static bool ToTimestamp(int year, int month, int day, int64_t nanoseconds_of_day, tTimestamp& result)
+{
+  if (year < 0 || month < 1 || month > 12 || day < 1 || day > static_cast<int>(DaysInMonth(year, month)))
+  {
+    return false;
+  }
+  int64_t nanoseconds = DaysFromCivil(year, month, day) * 86400000000000LL + nanoseconds_of_day;
+  result = tTimestamp(std::chrono::duration_cast<tDuration>(std::chrono::nanoseconds(nanoseconds)));
+  return true;
+}
+
+/*! Parses RMC date (DDMMYY - year since 2000) and time */
+static bool ParseRmcTimestamp(const char* time, size_t time_length, const char* date, size_t date_length, tTimestamp& result)
+{
+  int64_t nanoseconds_of_day = 0;
+  if (date_length != 6 || (!ParseNmeaTime(time, time_length, nanoseconds_of_day)))
+  {
+    return false;
+  }
+  int year = ParseNmeaDigits(date + 4, 2);
+  return year >= 0 && ToTimestamp(2000 + year, ParseNmeaDigits(date + 2, 2), ParseNmeaDigits(date, 2), nanoseconds_of_day, result);
+}
+
+tNmeaParser::tNmeaParser(bool require_checksum) :
+  sentence_length(0),
+  overflow(false),
+  require_checksum(require_checksum),
+  sentence_count(0),
+  error_count(0)
+{}
+
+bool tNmeaParser::ProcessSentence(tNmeaTimestamp& result)
+{
+  sentence_count++;
+
+  // Checksum
+  size_t data_end = sentence_length;
+  const char* star = static_cast<const char*>(memchr(sentence, '*', sentence_length));
+  if (star)
+  {
+    data_end = star - sentence;
+    if (data_end + 3 != sentence_length)
+    {
+      error_count++;
+      return false;
+    }
+    int high = ParseHexDigit(star[1]), low = ParseHexDigit(star[2]);
+    unsigned char checksum = 0;
+    for (size_t i = 1; i < data_end; i++)
+    {
+      checksum ^= static_cast<unsigned char>(sentence[i]);
+    }
+    if (high < 0 || low < 0 || checksum != ((high << 4) | low))
+    {
+      error_count++;
+      return false;
+    }
+  }
+  else if (require_checksum)
+  {
+    error_count++;
+    return false;
+  }
+
+  // Sentence type (address field is talker ID + sentence formatter - e.g. "GPRMC")
+  if (data_end < 7 || sentence[6] != ',' || sentence[1] == 'P')
+  {
+    return false;
+  }
+  const char* formatter = &sentence[3];
+  bool rmc = formatter[0] == 'R' && formatter[1] == 'M' && formatter[2] == 'C';
+  bool zda = formatter[0] == 'Z' && formatter[1] == 'D' && formatter[2] == 'A';
+  if (!(rmc || zda))
+  {
+    return false;
+  }
+
+  // Split fields
+  tField fields[cMAX_FIELDS];
+  size_t field_count = 0;
+  const char* field_start = &sentence[7];
+  const char* end = &sentence[data_end];
+  for (const char* c = field_start; field_count < cMAX_FIELDS; c++)
+  {
+    if (c == end || *c == ',')
+    {
+      fields[field_count].data = field_start;
+      fields[field_count].length = c - field_start;
+      field_count++;
+      field_start = c + 1;
+      if (c == end)
+      {
+        break;
+      }
+    }
+  }
+
+  if (rmc)
+  {
+    // $xxRMC,hhmmss.ss,A,llll.ll,a,yyyyy.yy,a,x.x,x.x,ddmmyy,x.x,a*hh
+    if (field_count < 9 || fields[0].length == 0 || fields[8].length == 0)
+    {
+      return false;  // no fix yet
+    }
+    if (!ParseRmcTimestamp(fields[0].data, fields[0].length, fields[8].data, fields[8].length, result.timestamp))
+    {
+      error_count++;
+      return false;
+    }
+    result.sentence = tNmeaSentence::RMC;
+    result.valid = fields[1].length == 1 && fields[1].data[0] == 'A';
+    return true;
+  }
+
+  // $xxZDA,hhmmss.ss,dd,mm,yyyy,xx,yy*hh
+  if (field_count < 4 || fields[0].length == 0 || fields[3].length == 0)
+  {
+    return false;
+  }
+  int64_t nanoseconds_of_day = 0;
+  if (fields[1].length != 2 || fields[2].length != 2 || fields[3].length != 4 || (!ParseNmeaTime(fields[0].data, fields[0].length, nanoseconds_of_day)) ||
+      (!ToTimestamp(ParseNmeaDigits(fields[3].data, 4), ParseNmeaDigits(fields[2].data, 2), ParseNmeaDigits(fields[1].data, 2), nanoseconds_of_day, result.timestamp)))
+  {
+    error_count++;
+    return false;
+  }
+  result.sentence = tNmeaSentence::ZDA;
+  result.valid = true;
+  return true;
+}
+
+tTimestamp ParseNmeaTimestamp(const std::string& nmea_time, const std::string& nmea_date)
+{
+  tTimestamp result;
+  if (!ParseRmcTimestamp(nmea_time.c_str(), nmea_time.length(), nmea_date.c_str(), nmea_date.length(), result))
+  {
+    throw std::runtime_error("Invalid NMEA timestamp: '" + nmea_time + "' '" + nmea_date + "'");
+  }
+  return result;
+}
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
@@ -0,0 +1,222 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    rrlib/time/tNmeaParser.h
+ *
+ * \author  agent
+ *
+ * \date    2026-10-18
+ *
+ * \brief   Contains tNmeaParser
+ *
+ * \b tNmeaParser
+ *
+ * Incremental parser that extracts timestamps from a NMEA-0183 byte stream
+ * (e.g. data read from a GNSS receiver's serial port).
+ *
+ */
+//----------------------------------------------------------------------
+#ifndef __rrlib__time__tNmeaParser_h__
+#define __rrlib__time__tNmeaParser_h__
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <cstddef>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/time/time.h"
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace time
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+/*!
+ * NMEA-0183 sentences that timestamps are extracted from (with any talker ID - e.g. GPRMC, GNRMC)
+ */
+enum class tNmeaSentence
+{
+  RMC,  //!< Recommended minimum specific GNSS data (time and two-digit year)
+  ZDA   //!< Time and date (four-digit year)
+};
+
+/*!
+ * Timestamp extracted from NMEA-0183 sentence
+ */
+struct tNmeaTimestamp
+{
+  /*! Timestamp (UTC) */
+  tTimestamp timestamp;
+
+  /*! Sentence that timestamp was extracted from */
+  tNmeaSentence sentence;
+
+  /*! False if receiver marked data as invalid (RMC status 'V') */
+  bool valid;
+};
+
+//----------------------------------------------------------------------
+// Class declaration
+//----------------------------------------------------------------------
+//! Streaming NMEA-0183 timestamp parser
+/*!
+ * Extracts timestamps from a NMEA-0183 byte stream.
+ * Data can be passed in chunks of arbitrary size (e.g. as returned by read() calls) -
+ * sentences spanning multiple chunks are reassembled in an internal buffer.
+ *
+ * Handles framing ('$' ... CR/LF), validates checksums and extracts time and date from
+ * RMC and ZDA sentences (with any talker ID). All other sentences are skipped.
+ * The parser does not allocate any memory.
+ */
+class tNmeaParser
+{
+
+//----------------------------------------------------------------------
+// Public methods and typedefs
+//----------------------------------------------------------------------
+public:
+
+  /*! Maximum length of sentence (standard specifies 82 characters - some receivers exceed this) */
+  enum { cMAX_SENTENCE_LENGTH = 128 };
+
+  /*!
+   * \param require_checksum If true, sentences without checksum are discarded
+   */
+  tNmeaParser(bool require_checksum = true);
+
+  /*!
+   * Processes chunk of data from NMEA-0183 stream
+   *
+   * \param data Pointer to data
+   * \param size Number of bytes
+   * \param callback Function or functor that is called with every extracted tNmeaTimestamp (signature: void(const tNmeaTimestamp&))
+   */
+  template <typename TCallback>
+  void Parse(const char* data, size_t size, TCallback callback)
+  {
+    tNmeaTimestamp result;
+    for (const char* end = data + size; data < end; data++)
+    {
+      char c = *data;
+      if (c == '$')
+      {
+        overflow = false;
+        sentence_length = 0;
+        sentence[sentence_length++] = c;
+      }
+      else if (c == '\r' || c == '\n')
+      {
+        if (sentence_length > 0)
+        {
+          if (overflow)
+          {
+            sentence_count++;
+            error_count++;
+          }
+          else if (ProcessSentence(result))
+          {
+            callback(result);
+          }
+        }
+        sentence_length = 0;
+      }
+      else if (sentence_length > 0)
+      {
+        if (sentence_length < cMAX_SENTENCE_LENGTH)
+        {
+          sentence[sentence_length++] = c;
+        }
+        else
+        {
+          overflow = true;
+        }
+      }
+    }
+  }
+
+  /*!
+   * Discards any partially received sentence (e.g. after reconnecting to receiver)
+   */
+  void Reset()
+  {
+    sentence_length = 0;
+    overflow = false;
+  }
+
+  /*! \return Number of complete sentences received */
+  size_t GetSentenceCount() const
+  {
+    return sentence_count;
+  }
+
+  /*! \return Number of sentences discarded due to invalid checksum or format - or because they exceeded cMAX_SENTENCE_LENGTH */
+  size_t GetErrorCount() const
+  {
+    return error_count;
+  }
+
+//----------------------------------------------------------------------
+// Private fields and methods
+//----------------------------------------------------------------------
+private:
+
+  /*! Buffer for current sentence (starting with '$') */
+  char sentence[cMAX_SENTENCE_LENGTH];
+
+  /*! Number of characters in buffer (0 while waiting for start of next sentence) */
+  size_t sentence_length;
+
+  /*! True if current sentence exceeded cMAX_SENTENCE_LENGTH */
+  bool overflow;
+
+  /*! Are checksums required? */
+  bool require_checksum;
+
+  /*! Statistics */
+  size_t sentence_count, error_count;
+
+  /*!
+   * Processes complete sentence in buffer
+   *
+   * \param result Extracted timestamp is written to this variable
+   * \return True if sentence contained timestamp
+   */
+  bool ProcessSentence(tNmeaTimestamp& result);
+};
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
+
+
+#endif
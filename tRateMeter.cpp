@@ -0,0 +1,138 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    rrlib/time/tRateMeter.cpp
+ *
+ * \author  agent
+ *
+ * \date    2026-10-18
+ *
+ */
+//----------------------------------------------------------------------
+#include "rrlib/time/tRateMeter.h"
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <cmath>
+#include <thread>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+#include <cassert>
+
+//----------------------------------------------------------------------
+// Namespace usage
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace time
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Const values
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Implementation
+//----------------------------------------------------------------------
+
+tRateMeter::tRateMeter(const tDuration& time_constant, const tTimestamp& now) :
+  counter(0),
+  updating(),
+  time_constant(std::chrono::duration_cast<std::chrono::duration<double>>(time_constant).count()),
+  last_time(now.time_since_epoch().count()),
+  last_count(0),
+  initialized(false),
+  rate(0)
+{
+  assert(time_constant > tDuration::zero());
+  updating.clear();
+}
+
+double tRateMeter::GetRate(const tTimestamp& now)
+{
+  if (updating.test_and_set(std::memory_order_acquire))
+  {
+    return rate.load(std::memory_order_relaxed);  // other thread is updating
+  }
+  int64_t time = now.time_since_epoch().count();
+  uint64_t count = counter.load(std::memory_order_relaxed);
+  double result = rate.load(std::memory_order_relaxed);
+  if (time < last_time)
+  {
+    // Application time jumped back (e.g. custom clock was reset): restart measurement
+    last_time = time;
+    last_count = count;
+  }
+  else if (time > last_time)
+  {
+    double elapsed = (time - last_time) * 1e-9;
+    double current_rate = (count - last_count) / elapsed;
+    if (initialized)
+    {
+      double weight = std::exp(-elapsed / time_constant);
+      result = weight * result + (1 - weight) * current_rate;
+    }
+    else
+    {
+      result = current_rate;
+      initialized = true;
+    }
+    last_time = time;
+    last_count = count;
+    rate.store(result, std::memory_order_relaxed);
+  }
+  updating.clear(std::memory_order_release);
+  return result;
+}
+
+void tRateMeter::Reset(const tTimestamp& now)
+{
+  while (updating.test_and_set(std::memory_order_acquire))
+  {
+    std::this_thread::yield();
+  }
+  last_time = now.time_since_epoch().count();
+  last_count = counter.load(std::memory_order_relaxed);
+  initialized = false;
+  rate.store(0, std::memory_order_relaxed);
+  updating.clear(std::memory_order_release);
+}
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
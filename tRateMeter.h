@@ -0,0 +1,157 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    rrlib/time/tRateMeter.h
+ *
+ * \author  agent
+ *
+ * \date    2026-10-18
+ *
+ * \brief   Contains tRateMeter
+ *
+ * \b tRateMeter
+ *
+ * Measures rate of events (e.g. messages per second at a port) in application time.
+ * So rates remain correct with time stretching (e.g. a 100 Hz sensor in a simulation
+ * running at half speed still has 100 events per second of application time).
+ *
+ * Counting an event is a single atomic increment - no time is obtained.
+ * The rate is an exponentially weighted moving average (EWMA) that is updated lazily
+ * when it is read - from the events counted since the previous read.
+ * If the rate is read at least once per time constant, it is a true EWMA.
+ * With less frequent reads, it is the average rate since the previous read.
+ */
+//----------------------------------------------------------------------
+#ifndef __rrlib__time__tRateMeter_h__
+#define __rrlib__time__tRateMeter_h__
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <atomic>
+#include <cstdint>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/time/time.h"
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace time
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Class declaration
+//----------------------------------------------------------------------
+//! Event rate meter
+/*!
+ * All methods are thread-safe. Increment() and GetRate() are lock-free:
+ * If several threads read the rate at the same time, only one of them updates it -
+ * the others obtain the rate of the previous update.
+ */
+class tRateMeter
+{
+
+//----------------------------------------------------------------------
+// Public methods and typedefs
+//----------------------------------------------------------------------
+public:
+
+  /*!
+   * \param time_constant Time constant of EWMA in application time (weight of events decays to 1/e after this duration)
+   * \param now Current application time (start of measurement)
+   */
+  explicit tRateMeter(const tDuration& time_constant = std::chrono::seconds(1), const tTimestamp& now = Now(false));
+
+  /*!
+   * Counts events
+   *
+   * \param count Number of events
+   */
+  void Increment(uint64_t count = 1)
+  {
+    counter.fetch_add(count, std::memory_order_relaxed);
+  }
+
+  /*!
+   * \return Total number of counted events
+   */
+  uint64_t GetCount() const
+  {
+    return counter.load(std::memory_order_relaxed);
+  }
+
+  /*!
+   * Updates and returns rate
+   *
+   * \param now Current application time
+   * \return Events per second (application time)
+   */
+  double GetRate(const tTimestamp& now = Now(false));
+
+  /*!
+   * Discards rate and restarts measurement (the total number of events is kept)
+   *
+   * \param now Current application time
+   */
+  void Reset(const tTimestamp& now = Now(false));
+
+//----------------------------------------------------------------------
+// Private fields and methods
+//----------------------------------------------------------------------
+private:
+
+  /*! Number of counted events */
+  std::atomic<uint64_t> counter;
+
+  /*! Set while a thread updates the rate */
+  std::atomic_flag updating;
+
+  /*! Time constant in seconds */
+  double time_constant;
+
+  /*! Time and counter value of last update (only accessed by updating thread) */
+  int64_t last_time;
+  uint64_t last_count;
+
+  /*! Whether rate contains a value (first update sets rate instead of averaging with zero) */
+  bool initialized;
+
+  /*! Rate after last update */
+  std::atomic<double> rate;
+};
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
+
+
+#endif
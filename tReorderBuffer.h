@@ -0,0 +1,429 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    rrlib/time/tReorderBuffer.h
+ *
+ * \author  agent
+ *
+ * \date    2026-10-18
+ *
+ * \brief   Contains tReorderBuffer and tConcurrentReorderBuffer
+ *
+ * \b tReorderBuffer
+ *
+ * Restores timestamp order of elements that arrive slightly out of order (e.g. messages received via network).
+ * Elements are held back until the watermark - current application time minus maximum lateness - has
+ * passed their timestamp. They are then released in timestamp order.
+ * Elements that arrive after elements with later timestamps have been released are "late" and
+ * are handled according to tLateArrivalPolicy.
+ *
+ * \b tConcurrentReorderBuffer
+ *
+ * Reorder buffer for one producer and one consumer thread. Pushing is lock-free and wait-free.
+ *
+ * Both classes allocate all memory on construction.
+ */
+//----------------------------------------------------------------------
+#ifndef __rrlib__time__tReorderBuffer_h__
+#define __rrlib__time__tReorderBuffer_h__
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/time/tStreamMerger.h"
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace time
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+/*!
+ * How to handle elements that arrive after elements with later timestamps have been released
+ */
+enum class tLateArrivalPolicy
+{
+  DROP,    //!< Element is discarded (and counted)
+  RELEASE  //!< Element is released immediately (out of order - and counted)
+};
+
+//----------------------------------------------------------------------
+// Class declaration
+//----------------------------------------------------------------------
+//! Buffer that restores timestamp order
+/*!
+ * Elements are stored in a binary heap with fixed capacity.
+ * Elements with equal timestamps are released in the order they were pushed.
+ * If the buffer is full, the element with the smallest timestamp is released early.
+ * Not thread-safe (see tConcurrentReorderBuffer).
+ *
+ * Callbacks are called with 'const T&' for each released element.
+ *
+ * \tparam T Element type (must be default-constructible and copy- or move-assignable)
+ * \tparam TGetTimestamp Functor that returns the timestamp of an element
+ */
+template < typename T, typename TGetTimestamp = tGetRecordTimestamp<T> >
+class tReorderBuffer
+{
+
+//----------------------------------------------------------------------
+// Public methods and typedefs
+//----------------------------------------------------------------------
+public:
+
+  /*!
+   * \param capacity Maximum number of buffered elements
+   * \param max_lateness Maximum delay of elements (in application time) that is compensated
+   * \param policy How to handle late elements
+   * \param get_timestamp Functor that returns the timestamp of an element
+   */
+  tReorderBuffer(size_t capacity, const tDuration& max_lateness, tLateArrivalPolicy policy = tLateArrivalPolicy::DROP, TGetTimestamp get_timestamp = TGetTimestamp()) :
+    capacity(std::max<size_t>(1, capacity)),
+    max_lateness(max_lateness),
+    policy(policy),
+    get_timestamp(get_timestamp),
+    heap(),
+    sequence(0),
+    last_released(std::numeric_limits<int64_t>::min()),
+    late_count(0)
+  {
+    heap.reserve(this->capacity);
+  }
+
+  /*!
+   * Adds element.
+   * Releases late elements (with policy RELEASE) - or the element with the smallest timestamp if the buffer is full.
+   *
+   * \param element Element to add
+   * \param callback Callback for released elements
+   */
+  template <typename TCallback>
+  void Push(const T& element, TCallback callback)
+  {
+    tEntry entry { get_timestamp(element).time_since_epoch().count(), sequence++, element };
+    Push(entry, callback);
+  }
+
+  /*!
+   * Releases all elements that the watermark has passed
+   *
+   * \param now Current time (watermark is now - max_lateness)
+   * \param callback Callback for released elements
+   * \return Number of released elements
+   */
+  template <typename TCallback>
+  size_t Release(const tTimestamp& now, TCallback callback)
+  {
+    int64_t watermark = (now - max_lateness).time_since_epoch().count();
+    size_t count = 0;
+    while (heap.size() && heap.front().key <= watermark)
+    {
+      ReleaseFirst(callback);
+      count++;
+    }
+    return count;
+  }
+
+  /*!
+   * Releases all elements that the watermark has passed (with current application time)
+   */
+  template <typename TCallback>
+  size_t Release(TCallback callback)
+  {
+    return Release(Now(), callback);
+  }
+
+  /*!
+   * Releases all buffered elements (e.g. on shutdown)
+   *
+   * \param callback Callback for released elements
+   */
+  template <typename TCallback>
+  void Flush(TCallback callback)
+  {
+    while (heap.size())
+    {
+      ReleaseFirst(callback);
+    }
+  }
+
+  /*!
+   * \return Number of buffered elements
+   */
+  size_t GetSize() const
+  {
+    return heap.size();
+  }
+
+  /*!
+   * \return Number of late elements (dropped or released out of order)
+   */
+  size_t GetLateCount() const
+  {
+    return late_count;
+  }
+
+  /*!
+   * \return Timestamp of next element to be released (undefined if buffer is empty)
+   */
+  tTimestamp GetNextTimestamp() const
+  {
+    return tTimestamp(tDuration(heap.front().key));
+  }
+
+//----------------------------------------------------------------------
+// Private fields and methods
+//----------------------------------------------------------------------
+private:
+
+  template <typename U, typename V>
+  friend class tConcurrentReorderBuffer;
+
+  /*! Buffered element with timestamp (nanoseconds since epoch) and sequence number for stable ordering */
+  struct tEntry
+  {
+    int64_t key;
+    uint64_t sequence;
+    T element;
+  };
+
+  /*! Comparator for std heap functions (element with smallest key and sequence is at front) */
+  struct tLater
+  {
+    bool operator()(const tEntry& a, const tEntry& b) const
+    {
+      return a.key > b.key || (a.key == b.key && a.sequence > b.sequence);
+    }
+  };
+
+  /*! Maximum number of buffered elements */
+  size_t capacity;
+
+  /*! Maximum lateness that is compensated */
+  tDuration max_lateness;
+
+  /*! How to handle late elements */
+  tLateArrivalPolicy policy;
+
+  /*! Functor that returns timestamp of element */
+  TGetTimestamp get_timestamp;
+
+  /*! Buffered elements (binary heap) */
+  std::vector<tEntry> heap;
+
+  /*! Sequence number for next element */
+  uint64_t sequence;
+
+  /*! Timestamp of last released element (nanoseconds since epoch) */
+  int64_t last_released;
+
+  /*! Number of late elements */
+  size_t late_count;
+
+  template <typename TCallback>
+  void Push(tEntry& entry, TCallback& callback)
+  {
+    if (entry.key < last_released)
+    {
+      late_count++;
+      if (policy == tLateArrivalPolicy::RELEASE)
+      {
+        callback(static_cast<const T&>(entry.element));
+      }
+      return;
+    }
+    if (heap.size() == capacity)
+    {
+      if (tLater()(heap.front(), entry))
+      {
+        // new element is the smallest one
+        last_released = entry.key;
+        callback(static_cast<const T&>(entry.element));
+        return;
+      }
+      ReleaseFirst(callback);
+    }
+    heap.push_back(std::move(entry));
+    std::push_heap(heap.begin(), heap.end(), tLater());
+  }
+
+  template <typename TCallback>
+  void ReleaseFirst(TCallback& callback)
+  {
+    std::pop_heap(heap.begin(), heap.end(), tLater());
+    last_released = heap.back().key;
+    callback(static_cast<const T&>(heap.back().element));
+    heap.pop_back();
+  }
+};
+
+//----------------------------------------------------------------------
+// Class declaration
+//----------------------------------------------------------------------
+//! Reorder buffer for one producer and one consumer thread
+/*!
+ * The producer thread pushes elements to a lock-free ring buffer.
+ * The consumer thread moves them to a tReorderBuffer when releasing elements.
+ * All callbacks are called by the consumer thread.
+ *
+ * \tparam T Element type (must be default-constructible and copy- or move-assignable)
+ * \tparam TGetTimestamp Functor that returns the timestamp of an element
+ */
+template < typename T, typename TGetTimestamp = tGetRecordTimestamp<T> >
+class tConcurrentReorderBuffer
+{
+
+//----------------------------------------------------------------------
+// Public methods and typedefs
+//----------------------------------------------------------------------
+public:
+
+  /*!
+   * \param capacity Maximum number of buffered elements (in ring buffer and in reorder buffer - each)
+   * \param max_lateness Maximum delay of elements (in application time) that is compensated
+   * \param policy How to handle late elements
+   * \param get_timestamp Functor that returns the timestamp of an element
+   */
+  tConcurrentReorderBuffer(size_t capacity, const tDuration& max_lateness, tLateArrivalPolicy policy = tLateArrivalPolicy::DROP, TGetTimestamp get_timestamp = TGetTimestamp()) :
+    buffer(capacity, max_lateness, policy, get_timestamp),
+    ring(RoundUpToPowerOfTwo(std::max<size_t>(2, capacity))),
+    mask(ring.size() - 1),
+    write_index(0),
+    read_index(0)
+  {}
+
+  /*!
+   * Adds element (may only be called by producer thread)
+   *
+   * \param element Element to add
+   * \return False if ring buffer is full (element is not added in this case)
+   */
+  bool Push(const T& element)
+  {
+    size_t write = write_index.load(std::memory_order_relaxed);
+    if (write - read_index.load(std::memory_order_acquire) == ring.size())
+    {
+      return false;
+    }
+    ring[write & mask] = element;
+    write_index.store(write + 1, std::memory_order_release);
+    return true;
+  }
+
+  /*!
+   * Releases all elements that the watermark has passed (may only be called by consumer thread)
+   *
+   * \param now Current time (watermark is now - max_lateness)
+   * \param callback Callback for released elements
+   * \return Number of released elements (excluding late elements)
+   */
+  template <typename TCallback>
+  size_t Release(const tTimestamp& now, TCallback callback)
+  {
+    size_t read = read_index.load(std::memory_order_relaxed);
+    size_t write = write_index.load(std::memory_order_acquire);
+    for (; read != write; read++)
+    {
+      buffer.Push(ring[read & mask], callback);
+    }
+    read_index.store(read, std::memory_order_release);
+    return buffer.Release(now, callback);
+  }
+
+  /*!
+   * Releases all elements that the watermark has passed (with current application time)
+   */
+  template <typename TCallback>
+  size_t Release(TCallback callback)
+  {
+    return Release(Now(), callback);
+  }
+
+  /*!
+   * Releases all buffered elements (may only be called by consumer thread)
+   *
+   * \param callback Callback for released elements
+   */
+  template <typename TCallback>
+  void Flush(TCallback callback)
+  {
+    Release(tTimestamp::min() + buffer.max_lateness, callback);
+    buffer.Flush(callback);
+  }
+
+  /*!
+   * \return Number of late elements (may only be called by consumer thread)
+   */
+  size_t GetLateCount() const
+  {
+    return buffer.GetLateCount();
+  }
+
+//----------------------------------------------------------------------
+// Private fields and methods
+//----------------------------------------------------------------------
+private:
+
+  /*! Reorder buffer (only accessed by consumer thread) */
+  tReorderBuffer<T, TGetTimestamp> buffer;
+
+  /*! Ring buffer (size is a power of two) */
+  std::vector<T> ring;
+  size_t mask;
+
+  /*! Number of elements written and read (on separate cache lines - as they are written by different threads) */
+  alignas(64) std::atomic<size_t> write_index;
+  alignas(64) std::atomic<size_t> read_index;
+
+  static size_t RoundUpToPowerOfTwo(size_t value)
+  {
+    size_t result = 1;
+    while (result < value)
+    {
+      result *= 2;
+    }
+    return result;
+  }
+};
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
+
+
+#endif
@@ -0,0 +1,140 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    rrlib/time/tReplayClock.cpp
+ *
+ * \author  agent
+ *
+ * \date    2026-10-18
+ *
+ */
+//----------------------------------------------------------------------
+#include "rrlib/time/tReplayClock.h"
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <thread>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+#include <cassert>
+
+//----------------------------------------------------------------------
+// Namespace usage
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace time
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Const values
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Implementation
+//----------------------------------------------------------------------
+
+tReplayClock::tReplayClock(const std::string& file_name, tReplayPace pace) :
+  reader(file_name),
+  pace(pace),
+  started(false)
+{}
+
+tReplayClock::~tReplayClock()
+{
+  if (IsCurrentTimeSource())
+  {
+    SetTimeSource(NULL, tTimestamp());
+  }
+}
+
+bool tReplayClock::Step(tTimeEvent* event)
+{
+  tTimeEvent next;
+  if (!reader.Next(next))
+  {
+    return false;
+  }
+  if (!started)
+  {
+    started = true;
+    replay_start = tBaseClock::now();
+    recording_start = next.system_time;
+    current_time = next.application_time;
+    SetTimeSource(this, current_time);
+  }
+  else
+  {
+    if (pace == tReplayPace::RECORDED)
+    {
+      std::this_thread::sleep_until(replay_start + (next.system_time - recording_start));
+    }
+
+    // Reset to stretched system time and time stretching are reflected by subsequent results of Now()
+    bool sets_time = next.type == tTimeEventType::NOW || next.type == tTimeEventType::APPLICATION_TIME || (next.type == tTimeEventType::TIME_SOURCE && next.custom_clock);
+    if (sets_time && next.application_time != current_time)
+    {
+      current_time = next.application_time;
+      SetApplicationTime(current_time);
+    }
+  }
+  if (event)
+  {
+    *event = next;
+  }
+  return true;
+}
+
+size_t tReplayClock::Replay(const std::function<void(const tTimeEvent&)>& callback)
+{
+  size_t count = 0;
+  tTimeEvent event;
+  while (Step(&event))
+  {
+    count++;
+    if (callback)
+    {
+      callback(event);
+    }
+  }
+  return count;
+}
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
@@ -0,0 +1,157 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    rrlib/time/tReplayClock.h
+ *
+ * \author  agent
+ *
+ * \date    2026-10-18
+ *
+ * \brief   Contains tReplayClock
+ *
+ * \b tReplayClock
+ *
+ * Custom clock that replays application time recorded by tTimeRecorder.
+ *
+ * Each replayed event sets application time to its recorded application time - so Now() returns
+ * the recorded values (in replay, time stretching is not applied - as recorded results of Now() already include it).
+ * Events can be replayed at recorded pace (with the recorded system time intervals) or as fast as possible.
+ *
+ * For deterministic replay, the thread whose behavior is to be reproduced should advance the clock
+ * itself - e.g. by calling Step() before each cycle. Alternatively, Replay() can be called in a separate thread.
+ *
+ * Example:
+ *   tReplayClock clock("timeline.rec", tReplayPace::AS_FAST_AS_POSSIBLE);
+ *   while (clock.Step())
+ *   {
+ *     ... // code under test calls Now()
+ *   }
+ */
+//----------------------------------------------------------------------
+#ifndef __rrlib__time__tReplayClock_h__
+#define __rrlib__time__tReplayClock_h__
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <functional>
+#include <string>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/time/tCustomClock.h"
+#include "rrlib/time/tTimeRecorder.h"
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace time
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+/*!
+ * Pace of replay
+ */
+enum class tReplayPace
+{
+  RECORDED,            //!< Events are replayed with the recorded intervals (system time)
+  AS_FAST_AS_POSSIBLE  //!< Events are replayed without waiting
+};
+
+//----------------------------------------------------------------------
+// Class declaration
+//----------------------------------------------------------------------
+//! Replays recorded application time
+/*!
+ * The clock becomes the current time source with its first replayed event.
+ * On destruction, the time source is reset to stretched system time (if clock is still current time source).
+ * Not thread-safe (Step() and Replay() must be called by one thread).
+ */
+class tReplayClock : public tCustomClock
+{
+
+//----------------------------------------------------------------------
+// Public methods and typedefs
+//----------------------------------------------------------------------
+public:
+
+  /*!
+   * \param file_name Name of recording file
+   * \param pace Pace of replay
+   * \throws std::runtime_error if file cannot be read or is no recording
+   */
+  explicit tReplayClock(const std::string& file_name, tReplayPace pace = tReplayPace::RECORDED);
+
+  ~tReplayClock();
+
+  /*!
+   * Replays next event (waits until it is due if pace is RECORDED)
+   *
+   * \param event If not nullptr, replayed event is stored here
+   * \return False if all events have been replayed
+   * \throws std::runtime_error if file is corrupt
+   */
+  bool Step(tTimeEvent* event = nullptr);
+
+  /*!
+   * Replays all remaining events
+   *
+   * \param callback Called after each replayed event (optional)
+   * \return Number of replayed events
+   * \throws std::runtime_error if file is corrupt
+   */
+  size_t Replay(const std::function<void(const tTimeEvent&)>& callback = std::function<void(const tTimeEvent&)>());
+
+//----------------------------------------------------------------------
+// Private fields and methods
+//----------------------------------------------------------------------
+private:
+
+  /*! Reader for recorded events */
+  tTimeRecordingReader reader;
+
+  /*! Pace of replay */
+  tReplayPace pace;
+
+  /*! Whether first event has been replayed */
+  bool started;
+
+  /*! System time at which replay started - and recorded system time of first event */
+  tTimestamp replay_start, recording_start;
+
+  /*! Application time that was set last */
+  tTimestamp current_time;
+};
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
+
+
+#endif
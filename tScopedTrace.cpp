@@ -0,0 +1,334 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    rrlib/time/tScopedTrace.cpp
+ *
+ * \author  agent
+ *
+ * \date    2026-10-18
+ *
+ */
+//----------------------------------------------------------------------
+#include "rrlib/time/tScopedTrace.h"
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+#include <cassert>
+
+//----------------------------------------------------------------------
+// Namespace usage
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace time
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Const values
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Implementation
+//----------------------------------------------------------------------
+
+#ifndef RRLIB_TIME_DISABLE_TRACING
+
+namespace
+{
+
+/*! Writes string with JSON escaping (without quotes) */
+void WriteJsonString(std::ostream& stream, const char* string)
+{
+  const char* run = string;  // characters that need no escaping are written in runs
+  for (const char* c = string; *c; c++)
+  {
+    if (*c == '"' || *c == '\\' || static_cast<unsigned char>(*c) < 0x20)
+    {
+      char escaped[8];
+      snprintf(escaped, sizeof(escaped), (*c == '"' || *c == '\\') ? "\\%c" : "\\u%04x", *c);
+      stream.write(run, c - run);
+      stream << escaped;
+      run = c + 1;
+    }
+  }
+  stream << run;
+}
+
+/*!
+ * Slot in ring buffer.
+ * Fields are atomic - as the exporting thread may read a slot while it is overwritten (such spans are detected and discarded).
+ */
+struct tTraceSlot
+{
+  std::atomic<const char*> name;
+  std::atomic<int64_t> begin, end;
+  std::atomic<int> clock;
+};
+
+/*!
+ * Ring buffer of one thread.
+ *
+ * Only the recording thread writes slots. Before writing the slot for span n, it sets 'claimed' to n + 1;
+ * afterwards, 'published' to n + 1. The exporting thread can thus detect overwritten slots (seqlock-style).
+ */
+struct tThreadBuffer
+{
+  std::vector<tTraceSlot> slots;
+  uint64_t mask;
+  std::atomic<uint64_t> claimed, published;
+
+  /*! Number of spans already exported or dropped (only accessed by exporting thread - with registry mutex) */
+  uint64_t exported;
+
+  /*! Index and name of thread (name is protected by registry mutex) */
+  size_t thread_index;
+  std::string thread_name;
+
+  tThreadBuffer(size_t capacity, size_t thread_index) :
+    slots(capacity),
+    mask(capacity - 1),
+    claimed(0),
+    published(0),
+    exported(0),
+    thread_index(thread_index)
+  {}
+};
+
+/*! Ring buffers of all threads that recorded spans */
+struct tTraceRegistry
+{
+  std::mutex mutex;
+  std::vector<std::shared_ptr<tThreadBuffer>> buffers;
+  size_t buffer_size = 65536;
+};
+
+tTraceRegistry& GetRegistry()
+{
+  static tTraceRegistry registry;
+  return registry;
+}
+
+/*! Buffer of current thread (remains in registry after thread terminated - until its spans are exported) */
+thread_local std::shared_ptr<tThreadBuffer> thread_buffer;
+
+tThreadBuffer& GetThreadBuffer()
+{
+  if (!thread_buffer)
+  {
+    tTraceRegistry& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    size_t capacity = 1;
+    while (capacity < registry.buffer_size)
+    {
+      capacity *= 2;
+    }
+    thread_buffer = std::make_shared<tThreadBuffer>(capacity, registry.buffers.size() + 1);
+    registry.buffers.push_back(thread_buffer);
+  }
+  return *thread_buffer;
+}
+
+/*! Copy of span for exporting */
+struct tSpan
+{
+  const char* name;
+  int64_t begin, end;
+  int clock;
+  size_t thread_index;
+};
+
+}
+
+void internal::RecordTraceSpan(const char* name, const tTimestamp& begin, const tTimestamp& end, tTraceClock clock)
+{
+  tThreadBuffer& buffer = GetThreadBuffer();
+  uint64_t index = buffer.published.load(std::memory_order_relaxed);
+  buffer.claimed.store(index + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  tTraceSlot& slot = buffer.slots[index & buffer.mask];
+  slot.name.store(name, std::memory_order_relaxed);
+  slot.begin.store(begin.time_since_epoch().count(), std::memory_order_relaxed);
+  slot.end.store(end.time_since_epoch().count(), std::memory_order_relaxed);
+  slot.clock.store(static_cast<int>(clock), std::memory_order_relaxed);
+  buffer.published.store(index + 1, std::memory_order_release);
+}
+
+void SetTraceThreadName(const std::string& name)
+{
+  tThreadBuffer& buffer = GetThreadBuffer();
+  std::lock_guard<std::mutex> lock(GetRegistry().mutex);
+  buffer.thread_name = name;
+}
+
+void SetTraceBufferSize(size_t spans)
+{
+  tTraceRegistry& registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  registry.buffer_size = std::max<size_t>(1, spans);
+}
+
+size_t WriteChromeTrace(std::ostream& stream)
+{
+  // Copy spans from ring buffers
+  std::vector<tSpan> spans;
+  std::vector<std::pair<size_t, std::string>> thread_names;
+  uint64_t dropped = 0;
+  {
+    tTraceRegistry& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (auto & buffer : registry.buffers)
+    {
+      uint64_t capacity = buffer->slots.size();
+      uint64_t published = buffer->published.load(std::memory_order_acquire);
+      uint64_t first = std::max(buffer->exported, published > capacity ? published - capacity : 0);
+      size_t copy_start = spans.size();
+      for (uint64_t i = first; i < published; i++)
+      {
+        const tTraceSlot& slot = buffer->slots[i & buffer->mask];
+        spans.push_back(tSpan { slot.name.load(std::memory_order_relaxed), slot.begin.load(std::memory_order_relaxed), slot.end.load(std::memory_order_relaxed), slot.clock.load(std::memory_order_relaxed), buffer->thread_index });
+      }
+
+      // Discard spans that were overwritten while copying
+      std::atomic_thread_fence(std::memory_order_acquire);
+      uint64_t claimed = buffer->claimed.load(std::memory_order_relaxed);
+      uint64_t valid_first = std::max(first, claimed > capacity ? claimed - capacity : 0);
+      spans.erase(spans.begin() + copy_start, spans.begin() + copy_start + std::min(valid_first, published) - first);
+      dropped += std::min(valid_first, published) - buffer->exported;
+      buffer->exported = published;
+      if (buffer->thread_name.length())
+      {
+        thread_names.emplace_back(buffer->thread_index, buffer->thread_name);
+      }
+    }
+    registry.buffers.erase(std::remove_if(registry.buffers.begin(), registry.buffers.end(), [](const std::shared_ptr<tThreadBuffer>& buffer)
+    {
+      return buffer.use_count() == 1;  // thread terminated and all spans exported
+    }), registry.buffers.end());
+  }
+
+  // Write trace
+  const char* cPROCESS_NAMES[] = { "System time", "Application time" };
+  int64_t origin[2] = { std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::max() };
+  for (const tSpan & span : spans)
+  {
+    origin[span.clock] = std::min(origin[span.clock], span.begin);
+  }
+  const char* separator = "\n";
+  stream << "{\"traceEvents\":[";
+  for (int clock = 0; clock < 2; clock++)
+  {
+    stream << separator << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << (clock + 1) << ",\"tid\":0,\"args\":{\"name\":\"" << cPROCESS_NAMES[clock] << "\"}}";
+    separator = ",\n";
+    for (auto & thread_name : thread_names)
+    {
+      stream << separator << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << (clock + 1) << ",\"tid\":" << thread_name.first << ",\"args\":{\"name\":\"";
+      WriteJsonString(stream, thread_name.second.c_str());
+      stream << "\"}}";
+    }
+  }
+  for (const tSpan & span : spans)
+  {
+    stream << separator << "{\"name\":\"";
+    WriteJsonString(stream, span.name);
+    int64_t begin = span.begin - origin[span.clock], duration = std::max<int64_t>(0, span.end - span.begin);
+    char buffer[160];
+    snprintf(buffer, sizeof(buffer), "\",\"ph\":\"X\",\"pid\":%d,\"tid\":%zu,\"ts\":%lld.%03lld,\"dur\":%lld.%03lld}", span.clock + 1, span.thread_index,
+             static_cast<long long>(begin / 1000), static_cast<long long>(begin % 1000), static_cast<long long>(duration / 1000), static_cast<long long>(duration % 1000));
+    stream << buffer;
+  }
+  stream << "\n],\n\"displayTimeUnit\":\"ns\",\n\"otherData\":{";
+  for (int clock = 0; clock < 2; clock++)
+  {
+    if (origin[clock] != std::numeric_limits<int64_t>::max())
+    {
+      stream << "\"" << (clock ? "application" : "system") << "_time_origin\":\"" << ToIsoString(tTimestamp(tDuration(origin[clock]))) << "\",";
+    }
+  }
+  stream << "\"dropped_spans\":\"" << dropped << "\"}}\n";
+  return spans.size();
+}
+
+#else
+
+void internal::RecordTraceSpan(const char*, const tTimestamp&, const tTimestamp&, tTraceClock)
+{}
+
+void SetTraceThreadName(const std::string&)
+{}
+
+void SetTraceBufferSize(size_t)
+{}
+
+size_t WriteChromeTrace(std::ostream& stream)
+{
+  stream << "{\"traceEvents\":[],\"displayTimeUnit\":\"ns\"}\n";
+  return 0;
+}
+
+#endif
+
+size_t WriteChromeTrace(const std::string& file_name)
+{
+  std::ofstream stream(file_name);
+  if (!stream)
+  {
+    throw std::runtime_error("Could not open trace file '" + file_name + "'");
+  }
+  size_t result = WriteChromeTrace(stream);
+  stream.close();
+  if (!stream)
+  {
+    throw std::runtime_error("Could not write trace file '" + file_name + "'");
+  }
+  return result;
+}
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
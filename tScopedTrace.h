@@ -0,0 +1,195 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    rrlib/time/tScopedTrace.h
+ *
+ * \author  agent
+ *
+ * \date    2026-10-18
+ *
+ * \brief   Contains tScopedTrace and functions for exporting traces
+ *
+ * \b tScopedTrace
+ *
+ * Records the time span of a scope (e.g. a component's cycle) for timeline profiling.
+ *
+ * Spans are recorded in a ring buffer of the current thread (lock-free - no allocation except
+ * when a thread records its first span). If spans are not exported in time, the oldest ones are overwritten.
+ * WriteChromeTrace() exports recorded spans in Chrome trace event format (JSON) - which
+ * can be viewed with chrome://tracing or https://ui.perfetto.dev.
+ *
+ * Spans can be recorded in system time or in application time. Spans in application time
+ * remain meaningful when time stretching or a custom clock is used. They are exported as a separate process.
+ *
+ * Defining RRLIB_TIME_DISABLE_TRACING (for the whole project - including rrlib_time) removes all tracing code:
+ * tScopedTrace is empty then and WriteChromeTrace() writes an empty trace.
+ *
+ * Example:
+ *   void tMyModule::Update()
+ *   {
+ *     tScopedTrace trace("tMyModule::Update");
+ *     ...
+ *   }
+ */
+//----------------------------------------------------------------------
+#ifndef __rrlib__time__tScopedTrace_h__
+#define __rrlib__time__tScopedTrace_h__
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <ostream>
+#include <string>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/time/time.h"
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace time
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+/*!
+ * Clock that spans are recorded with
+ */
+enum class tTraceClock
+{
+  SYSTEM_TIME,      //!< System time (tBaseClock)
+  APPLICATION_TIME  //!< Application time (Now())
+};
+
+namespace internal
+{
+
+/*! Records span in ring buffer of current thread */
+void RecordTraceSpan(const char* name, const tTimestamp& begin, const tTimestamp& end, tTraceClock clock);
+
+}
+
+//----------------------------------------------------------------------
+// Class declaration
+//----------------------------------------------------------------------
+//! Records time span of scope
+/*!
+ * Records span from construction to destruction in ring buffer of current thread.
+ */
+class tScopedTrace
+{
+
+//----------------------------------------------------------------------
+// Public methods and typedefs
+//----------------------------------------------------------------------
+public:
+
+#ifndef RRLIB_TIME_DISABLE_TRACING
+
+  /*!
+   * \param name Name of span (only the pointer is stored - so this must be a string literal or remain valid until trace is exported)
+   * \param clock Clock to record span with
+   */
+  explicit tScopedTrace(const char* name, tTraceClock clock = tTraceClock::SYSTEM_TIME) :
+    name(name),
+    clock(clock),
+    begin(clock == tTraceClock::SYSTEM_TIME ? tBaseClock::now() : Now())
+  {}
+
+  ~tScopedTrace()
+  {
+    internal::RecordTraceSpan(name, begin, clock == tTraceClock::SYSTEM_TIME ? tBaseClock::now() : Now(), clock);
+  }
+
+#else
+
+  explicit tScopedTrace(const char*, tTraceClock = tTraceClock::SYSTEM_TIME)
+  {}
+
+#endif
+
+  tScopedTrace(const tScopedTrace&) = delete;
+  tScopedTrace& operator=(const tScopedTrace&) = delete;
+
+//----------------------------------------------------------------------
+// Private fields and methods
+//----------------------------------------------------------------------
+private:
+
+#ifndef RRLIB_TIME_DISABLE_TRACING
+
+  const char* name;
+  tTraceClock clock;
+  tTimestamp begin;
+
+#endif
+};
+
+/*!
+ * Sets name of current thread in exported traces
+ *
+ * \param name Thread name
+ */
+void SetTraceThreadName(const std::string& name);
+
+/*!
+ * Sets capacity of ring buffers of threads that record their first span afterwards
+ * (default: 65536 spans - 32 bytes each)
+ *
+ * \param spans Number of spans (rounded up to a power of two)
+ */
+void SetTraceBufferSize(size_t spans);
+
+/*!
+ * Writes all spans recorded since last export in Chrome trace event format (JSON Object Format).
+ * Exported spans are removed from the ring buffers - so this function can be called periodically
+ * (e.g. by a background thread) to write consecutive trace files.
+ * Timestamps are relative to the earliest exported span of each clock (the absolute times are stored in "otherData").
+ * May be called while other threads record spans.
+ *
+ * \param stream Stream to write trace to
+ * \return Number of exported spans
+ */
+size_t WriteChromeTrace(std::ostream& stream);
+
+/*!
+ * Writes all spans recorded since last export to file in Chrome trace event format (see above)
+ *
+ * \param file_name Name of file
+ * \return Number of exported spans
+ * \throws std::runtime_error if file cannot be written
+ */
+size_t WriteChromeTrace(const std::string& file_name);
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
+
+
+#endif
@@ -0,0 +1,278 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    rrlib/time/tStreamMerger.h
+ *
+ * \author  agent
+ *
+ * \date    2026-10-18
+ *
+ * \brief   Contains tStreamMerger
+ *
+ * \b tStreamMerger
+ *
+ * Merges several streams of records - each sorted by timestamp - into one stream sorted by timestamp
+ * (e.g. recorded streams of different sensors).
+ *
+ * Records are read from the streams on demand - so only one record per stream is buffered.
+ * The next record is selected with a loser tree: Replacing the record of a stream requires
+ * log2(number of streams) comparisons along a fixed path - with fewer comparisons and
+ * better memory locality than a binary heap (std::priority_queue).
+ *
+ * Example:
+ *   std::vector<tStreamMerger<tSample>::tRangeSource> sources;
+ *   for (auto & recording : recordings)
+ *   {
+ *     sources.emplace_back(recording.begin(), recording.end());
+ *   }
+ *   tStreamMerger<tSample> merger(std::move(sources));
+ *   tSample sample;
+ *   size_t stream;
+ *   while (merger.Next(sample, stream))
+ *   {
+ *     ...
+ *   }
+ */
+//----------------------------------------------------------------------
+#ifndef __rrlib__time__tStreamMerger_h__
+#define __rrlib__time__tStreamMerger_h__
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/time/time.h"
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace time
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+/*!
+ * Default functor for obtaining timestamp of record: Returns member 'timestamp'
+ * (records that are timestamps themselves are supported as well)
+ */
+template <typename TRecord>
+struct tGetRecordTimestamp
+{
+  tTimestamp operator()(const TRecord& record) const
+  {
+    return record.timestamp;
+  }
+};
+
+template <>
+struct tGetRecordTimestamp<tTimestamp>
+{
+  tTimestamp operator()(const tTimestamp& record) const
+  {
+    return record;
+  }
+};
+
+/*!
+ * Stream source that reads records from an iterator range
+ */
+template <typename TIterator>
+class tIteratorSource
+{
+public:
+
+  tIteratorSource(TIterator begin, TIterator end) : current(begin), end(end) {}
+
+  template <typename TRecord>
+  bool Read(TRecord& record)
+  {
+    if (current == end)
+    {
+      return false;
+    }
+    record = *current;
+    ++current;
+    return true;
+  }
+
+private:
+
+  TIterator current, end;
+};
+
+//----------------------------------------------------------------------
+// Class declaration
+//----------------------------------------------------------------------
+//! Merges timestamp-sorted streams
+/*!
+ * Records with equal timestamps are returned in order of their streams' indices
+ * (records of the same stream in the order they were read) - so the result is deterministic.
+ *
+ * \tparam TRecord Record type
+ * \tparam TSource Stream source type. Must provide method 'bool Read(TRecord& record)' which reads the next record - returning false at the end of the stream.
+ * \tparam TGetTimestamp Functor that returns the timestamp of a record
+ */
+template < typename TRecord, typename TSource = tIteratorSource<typename std::vector<TRecord>::const_iterator>, typename TGetTimestamp = tGetRecordTimestamp<TRecord> >
+class tStreamMerger
+{
+
+//----------------------------------------------------------------------
+// Public methods and typedefs
+//----------------------------------------------------------------------
+public:
+
+  typedef tIteratorSource<typename std::vector<TRecord>::const_iterator> tRangeSource;
+
+  /*!
+   * \param sources Stream sources (each sorted by timestamp)
+   * \param get_timestamp Functor that returns the timestamp of a record
+   */
+  explicit tStreamMerger(std::vector<TSource> && sources, TGetTimestamp get_timestamp = TGetTimestamp()) :
+    sources(std::move(sources)),
+    get_timestamp(get_timestamp),
+    records(this->sources.size()),
+    keys(this->sources.size()),
+    exhausted(this->sources.size()),
+    tree(std::max<size_t>(1, this->sources.size()))
+  {
+    for (size_t i = 0; i < this->sources.size(); i++)
+    {
+      ReadRecord(i);
+    }
+    if (this->sources.size())
+    {
+      tree[0] = Build(1);
+    }
+  }
+
+  /*!
+   * \return Number of streams
+   */
+  size_t GetStreamCount() const
+  {
+    return sources.size();
+  }
+
+  /*!
+   * Obtains next record (with smallest timestamp)
+   *
+   * \param record Record is moved to this variable
+   * \param stream Index of stream that record was read from is written to this variable
+   * \return False if all streams have ended (record and stream are not modified in this case)
+   */
+  bool Next(TRecord& record, size_t& stream)
+  {
+    if (sources.empty() || exhausted[tree[0]])
+    {
+      return false;
+    }
+    size_t winner = tree[0];
+    record = std::move(records[winner]);
+    stream = winner;
+
+    // Replay matches on path from winner's leaf to root
+    ReadRecord(winner);
+    for (size_t node = (winner + sources.size()) / 2; node > 0; node /= 2)
+    {
+      if (Less(tree[node], winner))
+      {
+        std::swap(tree[node], winner);
+      }
+    }
+    tree[0] = winner;
+    return true;
+  }
+
+//----------------------------------------------------------------------
+// Private fields and methods
+//----------------------------------------------------------------------
+private:
+
+  /*! Stream sources */
+  std::vector<TSource> sources;
+
+  /*! Functor that returns timestamp of record */
+  TGetTimestamp get_timestamp;
+
+  /*! Current record of each stream, its timestamp (nanoseconds since epoch) and whether stream has ended */
+  std::vector<TRecord> records;
+  std::vector<int64_t> keys;
+  std::vector<char> exhausted;
+
+  /*!
+   * Loser tree: tree[0] is the stream with the smallest record - tree[i] (i > 0) is the loser of the match at internal node i.
+   * Children of node i are 2i and 2i + 1 - with the leaf of stream s at position (number of streams + s).
+   */
+  std::vector<size_t> tree;
+
+  /*! \return True if current record of stream a is to be returned before the one of stream b */
+  bool Less(size_t a, size_t b) const
+  {
+    return keys[a] < keys[b] || (keys[a] == keys[b] && (exhausted[a] < exhausted[b] || (exhausted[a] == exhausted[b] && a < b)));
+  }
+
+  /*! Builds loser tree below node - \return Winner of subtree */
+  size_t Build(size_t node)
+  {
+    if (node >= sources.size())
+    {
+      return node - sources.size();
+    }
+    size_t left = Build(2 * node), right = Build(2 * node + 1);
+    tree[node] = Less(left, right) ? right : left;
+    return Less(left, right) ? left : right;
+  }
+
+  /*! Reads next record of stream */
+  void ReadRecord(size_t stream)
+  {
+    if (sources[stream].Read(records[stream]))
+    {
+      keys[stream] = get_timestamp(records[stream]).time_since_epoch().count();
+    }
+    else
+    {
+      keys[stream] = std::numeric_limits<int64_t>::max();
+      exhausted[stream] = true;
+    }
+  }
+};
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
+
+
+#endif
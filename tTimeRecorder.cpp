@@ -0,0 +1,406 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    rrlib/time/tTimeRecorder.cpp
+ *
+ * \author  agent
+ *
+ * \date    2026-10-18
+ *
+ */
+//----------------------------------------------------------------------
+#include "rrlib/time/tTimeRecorder.h"
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/time/varint.h"
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+#include <cassert>
+
+//----------------------------------------------------------------------
+// Namespace usage
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace time
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Const values
+//----------------------------------------------------------------------
+
+/*! File header */
+static const char cMAGIC[8] = { 'R', 'R', 'T', 'I', 'M', 'R', 'E', 'C' };
+static const uint32_t cVERSION = 1;
+static const size_t cHEADER_SIZE = 16;
+
+/*! Capacity of each thread's buffer (events) */
+static const size_t cTHREAD_BUFFER_SIZE = 16384;
+
+/*! Maximum size of an encoded event (type, two 64 bit varints and two 32 bit varints) */
+static const size_t cMAX_EVENT_SIZE = 1 + 2 * internal::cMAX_VARINT_SIZE + 5 + 5;
+
+/*! Flag in type byte for SetTimeSource() with custom clock */
+static const uint8_t cCUSTOM_CLOCK_FLAG = 0x80;
+
+//----------------------------------------------------------------------
+// Implementation
+//----------------------------------------------------------------------
+
+std::atomic<bool> internal::time_recording_active(false);
+
+namespace
+{
+
+/*!
+ * Buffer of one thread (single-producer single-consumer ring buffer).
+ * Only the recording thread advances 'written', only the recorder advances 'read'.
+ */
+struct tThreadBuffer
+{
+  std::vector<tTimeEvent> events;
+  std::atomic<uint64_t> written, read, dropped;
+
+  tThreadBuffer() :
+    events(cTHREAD_BUFFER_SIZE),
+    written(0),
+    read(0),
+    dropped(0)
+  {}
+};
+
+/*! Buffers of all threads that recorded events - and whether a recorder exists */
+struct tRecordingRegistry
+{
+  std::mutex mutex;
+  std::vector<std::shared_ptr<tThreadBuffer>> buffers;
+  bool recorder_exists = false;
+
+  /*! Wakes up flush thread of recorder (used with recorder's mutex) */
+  std::condition_variable flush_requested;
+};
+
+tRecordingRegistry& GetRegistry()
+{
+  static tRecordingRegistry registry;
+  return registry;
+}
+
+/*! Buffer of current thread (remains in registry after thread terminated - until its events are written) */
+thread_local std::shared_ptr<tThreadBuffer> thread_buffer;
+
+}
+
+void internal::RecordTimeEvent(const tTimeEvent& event)
+{
+  if (!thread_buffer)
+  {
+    std::shared_ptr<tThreadBuffer> buffer = std::make_shared<tThreadBuffer>();
+    tRecordingRegistry& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.buffers.push_back(buffer);
+    thread_buffer = buffer;
+  }
+  tThreadBuffer& buffer = *thread_buffer;
+  uint64_t index = buffer.written.load(std::memory_order_relaxed);
+  if (index - buffer.read.load(std::memory_order_acquire) >= cTHREAD_BUFFER_SIZE)
+  {
+    buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  buffer.events[index % cTHREAD_BUFFER_SIZE] = event;
+  buffer.written.store(index + 1, std::memory_order_release);
+  if (index + 1 - buffer.read.load(std::memory_order_relaxed) == cTHREAD_BUFFER_SIZE / 2)
+  {
+    GetRegistry().flush_requested.notify_one();  // buffer is half full: write events before flush interval elapses
+  }
+}
+
+tTimeRecorder::tTimeRecorder(const std::string& file_name, const tDuration& flush_interval) :
+  file_name(file_name),
+  flush_interval(flush_interval),
+  last_system_time(0),
+  last_offset(0),
+  closed(false),
+  write_failed(false),
+  event_count(0),
+  dropped_event_count(0)
+{
+  {
+    tRecordingRegistry& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    if (registry.recorder_exists)
+    {
+      throw std::runtime_error("Could not record to '" + file_name + "': another tTimeRecorder exists");
+    }
+
+    stream.open(file_name, std::ios::binary | std::ios::trunc);
+    uint8_t header[cHEADER_SIZE] = { 0 };
+    memcpy(header, cMAGIC, sizeof(cMAGIC));
+    for (size_t i = 0; i < 4; i++)
+    {
+      header[8 + i] = static_cast<uint8_t>(cVERSION >> (8 * i));
+    }
+    stream.write(reinterpret_cast<const char*>(header), cHEADER_SIZE);
+    if (!stream)
+    {
+      throw std::runtime_error("Could not create recording file '" + file_name + "'");
+    }
+
+    // Discard events that were buffered after previous recorder was closed
+    for (auto & buffer : registry.buffers)
+    {
+      buffer->read.store(buffer->written.load(std::memory_order_acquire), std::memory_order_release);
+      buffer->dropped.store(0, std::memory_order_relaxed);
+    }
+    registry.recorder_exists = true;
+  }
+
+  internal::time_recording_active.store(true);
+  Now();  // records initial application time
+  thread = std::thread(&tTimeRecorder::Run, this);
+}
+
+tTimeRecorder::~tTimeRecorder()
+{
+  try
+  {
+    Close();
+  }
+  catch (const std::exception&)
+  {}
+}
+
+void tTimeRecorder::Close()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (closed)
+    {
+      return;
+    }
+    closed = true;
+    internal::time_recording_active.store(false);
+  }
+  GetRegistry().flush_requested.notify_all();
+  thread.join();
+
+  std::lock_guard<std::mutex> lock(mutex);
+  WriteBufferedEvents();
+  stream.close();
+  {
+    tRecordingRegistry& registry = GetRegistry();
+    std::lock_guard<std::mutex> registry_lock(registry.mutex);
+    registry.recorder_exists = false;
+  }
+  if (write_failed || stream.fail())
+  {
+    throw std::runtime_error("Could not write recording file '" + file_name + "'");
+  }
+}
+
+void tTimeRecorder::Flush()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  if (!closed)
+  {
+    WriteBufferedEvents();
+    stream.flush();
+  }
+  if (write_failed || !stream)
+  {
+    throw std::runtime_error("Could not write recording file '" + file_name + "'");
+  }
+}
+
+void tTimeRecorder::Run()
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  while (!closed)
+  {
+    GetRegistry().flush_requested.wait_for(lock, flush_interval);
+    if (!closed)
+    {
+      WriteBufferedEvents();
+    }
+  }
+}
+
+void tTimeRecorder::WriteBufferedEvents()
+{
+  // Copy events from thread buffers
+  events.clear();
+  uint64_t dropped = 0;
+  {
+    tRecordingRegistry& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (auto it = registry.buffers.begin(); it != registry.buffers.end();)
+    {
+      // Check for terminated thread before reading its events (it may record events and terminate in between)
+      tThreadBuffer& buffer = **it;
+      bool thread_terminated = it->use_count() == 1;
+      std::atomic_thread_fence(std::memory_order_acquire);
+      uint64_t read = buffer.read.load(std::memory_order_relaxed);
+      uint64_t written = buffer.written.load(std::memory_order_acquire);
+      for (uint64_t i = read; i < written; i++)
+      {
+        events.push_back(buffer.events[i % cTHREAD_BUFFER_SIZE]);
+      }
+      buffer.read.store(written, std::memory_order_release);
+      dropped += buffer.dropped.exchange(0, std::memory_order_relaxed);
+      it = thread_terminated ? registry.buffers.erase(it) : it + 1;  // all events of terminated thread are written
+    }
+  }
+  dropped_event_count.fetch_add(dropped, std::memory_order_relaxed);
+  if (events.empty())
+  {
+    return;
+  }
+
+  // Encode and write events
+  std::stable_sort(events.begin(), events.end(), [](const tTimeEvent & a, const tTimeEvent & b)
+  {
+    return a.system_time < b.system_time;
+  });
+  encoded.resize(events.size() * cMAX_EVENT_SIZE);
+  uint8_t* position = encoded.data();
+  for (const tTimeEvent & event : events)
+  {
+    int64_t system_time = event.system_time.time_since_epoch().count();
+    int64_t offset = (event.application_time - event.system_time).count();
+    *(position++) = static_cast<uint8_t>(event.type) | ((event.type == tTimeEventType::TIME_SOURCE && event.custom_clock) ? cCUSTOM_CLOCK_FLAG : 0);
+    position = internal::WriteVarint(position, internal::ZigZagEncode(static_cast<uint64_t>(system_time) - static_cast<uint64_t>(last_system_time)));
+    position = internal::WriteVarint(position, internal::ZigZagEncode(static_cast<uint64_t>(offset) - static_cast<uint64_t>(last_offset)));
+    if (event.type == tTimeEventType::TIME_STRETCHING)
+    {
+      position = internal::WriteVarint(position, event.numerator);
+      position = internal::WriteVarint(position, event.denominator);
+    }
+    last_system_time = system_time;
+    last_offset = offset;
+  }
+  stream.write(reinterpret_cast<const char*>(encoded.data()), position - encoded.data());
+  write_failed |= !stream;
+  event_count.fetch_add(events.size(), std::memory_order_relaxed);
+}
+
+tTimeRecordingReader::tTimeRecordingReader(const std::string& file_name) :
+  file_name(file_name),
+  position(cHEADER_SIZE),
+  last_system_time(0),
+  last_offset(0)
+{
+  std::ifstream stream(file_name, std::ios::binary);
+  if (!stream)
+  {
+    throw std::runtime_error("Could not open recording file '" + file_name + "'");
+  }
+  data.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+  if (stream.bad())
+  {
+    throw std::runtime_error("Could not read recording file '" + file_name + "'");
+  }
+  if (data.size() < cHEADER_SIZE || memcmp(data.data(), cMAGIC, sizeof(cMAGIC)) != 0)
+  {
+    throw std::runtime_error("Invalid recording file '" + file_name + "': no recording file header");
+  }
+  uint32_t version = 0;
+  for (size_t i = 0; i < 4; i++)
+  {
+    version |= static_cast<uint32_t>(data[8 + i]) << (8 * i);
+  }
+  if (version != cVERSION)
+  {
+    throw std::runtime_error("Invalid recording file '" + file_name + "': unsupported version");
+  }
+}
+
+bool tTimeRecordingReader::Next(tTimeEvent& event)
+{
+  if (position >= data.size())
+  {
+    return false;
+  }
+  const uint8_t* current = &data[position];
+  const uint8_t* end = data.data() + data.size();
+  uint8_t type = *(current++);
+  if ((type & ~cCUSTOM_CLOCK_FLAG) > static_cast<uint8_t>(tTimeEventType::TIME_STRETCHING))
+  {
+    throw std::runtime_error("Invalid recording file '" + file_name + "': invalid event type");
+  }
+  event.type = static_cast<tTimeEventType>(type & ~cCUSTOM_CLOCK_FLAG);
+  event.custom_clock = (type & cCUSTOM_CLOCK_FLAG) != 0;
+  uint64_t system_time_delta = 0, offset_delta = 0, numerator = 0, denominator = 0;
+  bool valid = internal::ReadVarint(current, end, system_time_delta) && internal::ReadVarint(current, end, offset_delta);
+  if (event.type == tTimeEventType::TIME_STRETCHING)
+  {
+    valid = valid && internal::ReadVarint(current, end, numerator) && internal::ReadVarint(current, end, denominator);
+  }
+  if (!valid)
+  {
+    throw std::runtime_error("Invalid recording file '" + file_name + "': truncated or corrupt event");
+  }
+  int64_t system_time = static_cast<int64_t>(static_cast<uint64_t>(last_system_time) + internal::ZigZagDecode(system_time_delta));
+  int64_t offset = static_cast<int64_t>(static_cast<uint64_t>(last_offset) + internal::ZigZagDecode(offset_delta));
+  event.system_time = tTimestamp(tDuration(system_time));
+  event.application_time = event.system_time + tDuration(offset);
+  event.numerator = static_cast<uint32_t>(numerator);
+  event.denominator = static_cast<uint32_t>(denominator);
+  last_system_time = system_time;
+  last_offset = offset;
+  position = current - data.data();
+  return true;
+}
+
+void tTimeRecordingReader::Rewind()
+{
+  position = cHEADER_SIZE;
+  last_system_time = 0;
+  last_offset = 0;
+}
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
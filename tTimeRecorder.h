@@ -0,0 +1,300 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    rrlib/time/tTimeRecorder.h
+ *
+ * \author  agent
+ *
+ * \date    2026-10-18
+ *
+ * \brief   Contains tTimeRecorder and tTimeRecordingReader
+ *
+ * \b tTimeRecorder
+ *
+ * Records the application timeline to a file - in order to reproduce issues
+ * (see tReplayClock for replaying recordings).
+ * Recorded events are calls to SetTimeStretching(), SetTimeSource(),
+ * tCustomClock::SetApplicationTime() - and the results of Now().
+ * Results of NowMonotonic() are not recorded - so replays of code that measures intervals with NowMonotonic()
+ * are not deterministic (during replay, NowMonotonic() advances with the replayed application time).
+ *
+ * While no recorder exists, recording costs one relaxed atomic load per call to Now().
+ * While recording, each event is copied to a buffer of the calling thread (no locks, no allocation).
+ * A background thread of the recorder writes buffered events to the file periodically - or when a thread's buffer is half full.
+ * If a thread records events faster than they are written, events are dropped (see GetDroppedEventCount()).
+ *
+ * \b tTimeRecordingReader
+ *
+ * Reads recorded events from a file.
+ *
+ * File format (all values little endian):
+ *  - 16 byte header (magic "RRTIMREC", version (uint32), 4 reserved bytes)
+ *  - Events. Each event consists of its type (one byte - bit 7 is set for SetTimeSource() with custom clock),
+ *    the difference of its system time to the previous event's system time, the difference of its offset
+ *    (application time - system time) to the previous event's offset and - for SetTimeStretching() - numerator and denominator.
+ *    Values are zig-zag encoded varints (LEB128). So most events from Now() take four to five bytes.
+ * Events are ordered by system time. As events of different threads are sorted when they are written,
+ * events of different threads that occur almost simultaneously may be swapped (if they are written in different flushes).
+ *
+ * Example:
+ *   {
+ *     tTimeRecorder recorder("timeline.rec");
+ *     ... // run application
+ *   }
+ */
+//----------------------------------------------------------------------
+#ifndef __rrlib__time__tTimeRecorder_h__
+#define __rrlib__time__tTimeRecorder_h__
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/time/time.h"
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace time
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+/*!
+ * Type of recorded event
+ */
+enum class tTimeEventType : uint8_t
+{
+  NOW,               //!< Result of Now()
+  APPLICATION_TIME,  //!< Call to tCustomClock::SetApplicationTime() (of current time source)
+  TIME_SOURCE,       //!< Call to SetTimeSource()
+  TIME_STRETCHING    //!< Call to SetTimeStretching() (with valid parameters)
+};
+
+/*!
+ * Recorded event
+ */
+struct tTimeEvent
+{
+  tTimeEventType type;
+
+  /*! System time at which event occurred */
+  tTimestamp system_time;
+
+  /*! NOW: result; APPLICATION_TIME: new time; TIME_SOURCE: initial time; TIME_STRETCHING: application time before change */
+  tTimestamp application_time;
+
+  /*! TIME_STRETCHING: new time stretching factor */
+  uint32_t numerator, denominator;
+
+  /*! TIME_SOURCE: true if a custom clock was set - false if time source was reset to stretched system time */
+  bool custom_clock;
+};
+
+namespace internal
+{
+
+/*! Whether a tTimeRecorder is currently recording */
+extern std::atomic<bool> time_recording_active;
+
+/*! Records event in buffer of current thread (only to be called if time_recording_active is set) */
+void RecordTimeEvent(const tTimeEvent& event);
+
+}
+
+//----------------------------------------------------------------------
+// Class declaration
+//----------------------------------------------------------------------
+//! Records application timeline to file
+/*!
+ * Only one recorder may exist at a time.
+ * Recording starts on construction and ends with Close() or destruction.
+ * The first event is a result of Now() - so recordings start with the current application time.
+ */
+class tTimeRecorder
+{
+
+//----------------------------------------------------------------------
+// Public methods and typedefs
+//----------------------------------------------------------------------
+public:
+
+  /*!
+   * Creates file and starts recording
+   *
+   * \param file_name Name of file (an existing file is overwritten)
+   * \param flush_interval Interval (system time) in which buffered events are written to file
+   * \throws std::runtime_error if file cannot be created or another recorder exists
+   */
+  explicit tTimeRecorder(const std::string& file_name, const tDuration& flush_interval = std::chrono::milliseconds(10));
+
+  /*! Stops recording and closes file (see Close()) - errors are ignored */
+  ~tTimeRecorder();
+
+  tTimeRecorder(const tTimeRecorder&) = delete;
+  tTimeRecorder& operator=(const tTimeRecorder&) = delete;
+
+  /*!
+   * Stops recording, writes all buffered events and closes file.
+   * Afterwards, recorder must not be used anymore.
+   *
+   * \throws std::runtime_error if writing fails
+   */
+  void Close();
+
+  /*!
+   * Writes all buffered events to file
+   *
+   * \throws std::runtime_error if writing fails
+   */
+  void Flush();
+
+  /*!
+   * \return Number of events written to file
+   */
+  uint64_t GetEventCount() const
+  {
+    return event_count.load(std::memory_order_relaxed);
+  }
+
+  /*!
+   * \return Number of events that were dropped because buffers were full
+   */
+  uint64_t GetDroppedEventCount() const
+  {
+    return dropped_event_count.load(std::memory_order_relaxed);
+  }
+
+//----------------------------------------------------------------------
+// Private fields and methods
+//----------------------------------------------------------------------
+private:
+
+  /*! Name of file */
+  std::string file_name;
+
+  /*! Interval in which buffered events are written to file */
+  tDuration flush_interval;
+
+  /*! Mutex for all non-atomic members below */
+  std::mutex mutex;
+
+  /*! File stream */
+  std::ofstream stream;
+
+  /*! System time and offset of last written event (nanoseconds) */
+  int64_t last_system_time, last_offset;
+
+  /*! Events collected from buffers of all threads (buffer for writing - member to avoid allocation) */
+  std::vector<tTimeEvent> events;
+  std::vector<uint8_t> encoded;
+
+  /*! Whether recorder was closed - and whether writing to file failed */
+  bool closed, write_failed;
+
+  /*! Statistics */
+  std::atomic<uint64_t> event_count, dropped_event_count;
+
+  /*! Thread that writes buffered events periodically */
+  std::thread thread;
+
+  /*! Main loop of flush thread */
+  void Run();
+
+  /*! Writes buffered events to file (mutex must be locked) */
+  void WriteBufferedEvents();
+};
+
+//----------------------------------------------------------------------
+// Class declaration
+//----------------------------------------------------------------------
+//! Reads recorded events from file
+/*!
+ * Loads file into memory on construction.
+ */
+class tTimeRecordingReader
+{
+
+//----------------------------------------------------------------------
+// Public methods and typedefs
+//----------------------------------------------------------------------
+public:
+
+  /*!
+   * \param file_name Name of file
+   * \throws std::runtime_error if file cannot be read or is no recording
+   */
+  explicit tTimeRecordingReader(const std::string& file_name);
+
+  /*!
+   * Reads next event
+   *
+   * \param event Event to store result in
+   * \return False if there are no more events
+   * \throws std::runtime_error if file is corrupt
+   */
+  bool Next(tTimeEvent& event);
+
+  /*!
+   * Continues reading at first event
+   */
+  void Rewind();
+
+//----------------------------------------------------------------------
+// Private fields and methods
+//----------------------------------------------------------------------
+private:
+
+  /*! Name of file */
+  std::string file_name;
+
+  /*! File contents */
+  std::vector<uint8_t> data;
+
+  /*! Position of next event in data */
+  size_t position;
+
+  /*! System time and offset of last read event (nanoseconds) */
+  int64_t last_system_time, last_offset;
+};
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
+
+
+#endif
@@ -0,0 +1,551 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    rrlib/time/tTimeZone.cpp
+ *
+ * \author  agent
+ *
+ * \date    2026-10-18
+ *
+ */
+//----------------------------------------------------------------------
+#include "rrlib/time/tTimeZone.h"
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/time/calendar.h"
+#include "rrlib/time/tIsoTimestampFormatter.h"
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+#include <cassert>
+
+//----------------------------------------------------------------------
+// Namespace usage
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace time
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+namespace
+{
+
+/*! Transition rule from POSIX TZ string (e.g. "M3.5.0/3") */
+struct tTransitionRule
+{
+  enum class tType
+  {
+    JULIAN,           //!< Jn: day of year [1..365] - February 29 is never counted
+    ZERO_BASED_DAY,   //!< n: day of year [0..365]
+    MONTH_WEEK_DAY    //!< Mm.w.d: day d (0 = Sunday) of week w (5 = last) of month m
+  };
+
+  tType type;
+  int day, week, month;
+
+  /*! Local time of day of transition (seconds - may be negative or exceed one day) */
+  int time;
+};
+
+/*! Parsed POSIX TZ string */
+struct tPosixRule
+{
+  int standard_offset, dst_offset;  // UTC offsets (seconds - east positive)
+  bool has_dst;
+  tTransitionRule dst_start, dst_end;
+};
+
+/*! Closes file descriptor and unmaps memory on scope exit */
+struct tMappedFile
+{
+  int file_descriptor;
+  void* data;
+  size_t size;
+
+  tMappedFile() : file_descriptor(-1), data(MAP_FAILED), size(0) {}
+  ~tMappedFile()
+  {
+    if (data != MAP_FAILED)
+    {
+      munmap(data, size);
+    }
+    if (file_descriptor >= 0)
+    {
+      close(file_descriptor);
+    }
+  }
+};
+
+}
+
+//----------------------------------------------------------------------
+// Const values
+//----------------------------------------------------------------------
+
+/*! Size of TZif header */
+static const size_t cTZIF_HEADER_SIZE = 44;
+
+/*! Transitions are generated up to this year (end of tTimestamp's range) */
+static const int cLAST_GENERATED_YEAR = 2262;
+
+/*! Number of time zones that each thread caches formatters for in ToIsoString() */
+static const size_t cFORMATTER_CACHE_SIZE = 4;
+
+//----------------------------------------------------------------------
+// Implementation
+//----------------------------------------------------------------------
+
+static inline uint32_t ReadBigEndian32(const unsigned char* data)
+{
+  return (static_cast<uint32_t>(data[0]) << 24) | (static_cast<uint32_t>(data[1]) << 16) | (static_cast<uint32_t>(data[2]) << 8) | data[3];
+}
+
+static inline int64_t ReadBigEndian64(const unsigned char* data)
+{
+  return static_cast<int64_t>((static_cast<uint64_t>(ReadBigEndian32(data)) << 32) | ReadBigEndian32(data + 4));
+}
+
+/*! Parses decimal number in TZ string */
+static bool ParseRuleNumber(const char*& c, int& result)
+{
+  if (*c < '0' || *c > '9')
+  {
+    return false;
+  }
+  result = 0;
+  while (*c >= '0' && *c <= '9')
+  {
+    result = result * 10 + (*c - '0');
+    c++;
+  }
+  return true;
+}
+
+/*! Parses [+|-]hh[:mm[:ss]] in TZ string (result in seconds) */
+static bool ParseRuleTime(const char*& c, int& result)
+{
+  int sign = 1;
+  if (*c == '+' || *c == '-')
+  {
+    sign = *c == '-' ? -1 : 1;
+    c++;
+  }
+  int hours = 0, minutes = 0, seconds = 0;
+  if (!ParseRuleNumber(c, hours))
+  {
+    return false;
+  }
+  if (*c == ':')
+  {
+    c++;
+    if (!ParseRuleNumber(c, minutes))
+    {
+      return false;
+    }
+    if (*c == ':')
+    {
+      c++;
+      if (!ParseRuleNumber(c, seconds))
+      {
+        return false;
+      }
+    }
+  }
+  result = sign * (hours * 3600 + minutes * 60 + seconds);
+  return true;
+}
+
+/*! Skips zone abbreviation ("CET" or "<+0545>") in TZ string */
+static bool SkipRuleName(const char*& c)
+{
+  const char* start = c;
+  if (*c == '<')
+  {
+    while (*c && *c != '>')
+    {
+      c++;
+    }
+    if (*c != '>')
+    {
+      return false;
+    }
+    c++;
+    return true;
+  }
+  while ((*c >= 'A' && *c <= 'Z') || (*c >= 'a' && *c <= 'z'))
+  {
+    c++;
+  }
+  return c - start >= 3;
+}
+
+/*! Parses ",date[/time]" in TZ string */
+static bool ParseTransitionRule(const char*& c, tTransitionRule& rule)
+{
+  if (*c != ',')
+  {
+    return false;
+  }
+  c++;
+  rule.day = rule.week = rule.month = 0;
+  rule.time = 2 * 3600;
+  if (*c == 'J')
+  {
+    c++;
+    rule.type = tTransitionRule::tType::JULIAN;
+    if (!(ParseRuleNumber(c, rule.day) && rule.day >= 1 && rule.day <= 365))
+    {
+      return false;
+    }
+  }
+  else if (*c == 'M')
+  {
+    c++;
+    rule.type = tTransitionRule::tType::MONTH_WEEK_DAY;
+    if (!(ParseRuleNumber(c, rule.month) && *(c++) == '.' && ParseRuleNumber(c, rule.week) && *(c++) == '.' && ParseRuleNumber(c, rule.day) &&
+          rule.month >= 1 && rule.month <= 12 && rule.week >= 1 && rule.week <= 5 && rule.day <= 6))
+    {
+      return false;
+    }
+  }
+  else
+  {
+    rule.type = tTransitionRule::tType::ZERO_BASED_DAY;
+    if (!(ParseRuleNumber(c, rule.day) && rule.day <= 365))
+    {
+      return false;
+    }
+  }
+  if (*c == '/')
+  {
+    c++;
+    return ParseRuleTime(c, rule.time);
+  }
+  return true;
+}
+
+/*! Parses POSIX TZ string (e.g. "CET-1CEST,M3.5.0,M10.5.0/3") */
+static bool ParsePosixRule(const std::string& string, tPosixRule& rule)
+{
+  const char* c = string.c_str();
+  if (!(SkipRuleName(c) && ParseRuleTime(c, rule.standard_offset)))
+  {
+    return false;
+  }
+  rule.standard_offset = -rule.standard_offset;  // POSIX offsets are positive west of Greenwich
+  rule.dst_offset = rule.standard_offset;
+  rule.has_dst = *c != 0;
+  if (!rule.has_dst)
+  {
+    return true;
+  }
+  if (!SkipRuleName(c))
+  {
+    return false;
+  }
+  rule.dst_offset = rule.standard_offset + 3600;
+  if (*c != ',' && *c != 0)
+  {
+    if (!ParseRuleTime(c, rule.dst_offset))
+    {
+      return false;
+    }
+    rule.dst_offset = -rule.dst_offset;
+  }
+  if (*c == 0)
+  {
+    // No rule specified: POSIX leaves this implementation-defined - use US rules like glibc
+    rule.dst_start = tTransitionRule { tTransitionRule::tType::MONTH_WEEK_DAY, 0, 2, 3, 7200 };
+    rule.dst_end = tTransitionRule { tTransitionRule::tType::MONTH_WEEK_DAY, 0, 1, 11, 7200 };
+    return true;
+  }
+  return ParseTransitionRule(c, rule.dst_start) && ParseTransitionRule(c, rule.dst_end) && *c == 0;
+}
+
+/*! \return Day (since 1970-01-01) that rule refers to in specified year */
+static int64_t GetTransitionDay(const tTransitionRule& rule, int year)
+{
+  switch (rule.type)
+  {
+  case tTransitionRule::tType::JULIAN:
+    return DaysFromCivil(year, 1, 1) + rule.day - 1 + ((IsLeapYear(year) && rule.day >= 60) ? 1 : 0);
+  case tTransitionRule::tType::ZERO_BASED_DAY:
+    return DaysFromCivil(year, 1, 1) + rule.day;
+  default:
+  {
+    int64_t first_day = DaysFromCivil(year, rule.month, 1);
+    int first_weekday = static_cast<int>(((first_day + 4) % 7 + 7) % 7);  // 1970-01-01 was a Thursday (0 = Sunday)
+    int64_t day = first_day + (rule.day - first_weekday + 7) % 7 + (rule.week - 1) * 7;
+    while (day - first_day >= DaysInMonth(year, rule.month))
+    {
+      day -= 7;
+    }
+    return day;
+  }
+  }
+}
+
+tTimeZone::tTimeZone(const std::string& name) :
+  name(name),
+  last_index(0),
+  id(0)
+{
+  static std::atomic<uint64_t> id_counter(0);
+  id = ++id_counter;
+
+  if (name == "UTC")
+  {
+    AddSegment(std::numeric_limits<int64_t>::min(), 0);
+    return;
+  }
+
+  std::string path = name;
+  if (name.empty() || name[0] != '/')
+  {
+    const char* directory = getenv("TZDIR");
+    path = std::string(directory && *directory ? directory : "/usr/share/zoneinfo") + "/" + name;
+  }
+
+  tMappedFile file;
+  file.file_descriptor = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  struct stat status;
+  if (file.file_descriptor < 0 || fstat(file.file_descriptor, &status) != 0 || (!S_ISREG(status.st_mode)))
+  {
+    throw std::runtime_error("Could not open time zone file '" + path + "'");
+  }
+  file.size = status.st_size;
+  if (file.size > 0)
+  {
+    file.data = mmap(nullptr, file.size, PROT_READ, MAP_PRIVATE, file.file_descriptor, 0);
+  }
+  if (file.data == MAP_FAILED)
+  {
+    throw std::runtime_error("Could not map time zone file '" + path + "'");
+  }
+  try
+  {
+    ParseTzif(static_cast<const unsigned char*>(file.data), file.size);
+  }
+  catch (const std::runtime_error& e)
+  {
+    throw std::runtime_error("Invalid time zone file '" + path + "': " + e.what());
+  }
+}
+
+void tTimeZone::AddRuleTransitions(const std::string& rule_string)
+{
+  tPosixRule rule;
+  if (!ParsePosixRule(rule_string, rule))
+  {
+    throw std::runtime_error("Invalid TZ rule '" + rule_string + "'");
+  }
+  if (!rule.has_dst)
+  {
+    return;  // offset of last transition remains valid
+  }
+
+  int first_year = segment_begin.size() > 1 ? static_cast<int>(CivilFromDays(segment_begin.back() / 86400).year) : 1970;
+  for (int year = first_year; year <= cLAST_GENERATED_YEAR; year++)
+  {
+    // DST starts at local standard time and ends at local daylight saving time
+    int64_t start = GetTransitionDay(rule.dst_start, year) * 86400 + rule.dst_start.time - rule.standard_offset;
+    int64_t end = GetTransitionDay(rule.dst_end, year) * 86400 + rule.dst_end.time - rule.dst_offset;
+    bool start_first = start < end;
+    int64_t first = start_first ? start : end, second = start_first ? end : start;
+    if (first > segment_begin.back())
+    {
+      AddSegment(first, start_first ? rule.dst_offset : rule.standard_offset);
+    }
+    if (second > segment_begin.back())
+    {
+      AddSegment(second, start_first ? rule.standard_offset : rule.dst_offset);
+    }
+  }
+}
+
+void tTimeZone::AddSegment(int64_t begin, int offset)
+{
+  assert(segment_begin.empty() || begin > segment_begin.back());
+  if (segment_offset.empty() || segment_offset.back() != offset)
+  {
+    segment_begin.push_back(begin);
+    segment_offset.push_back(offset);
+  }
+}
+
+size_t tTimeZone::FindSegment(int64_t utc_seconds) const
+{
+  return std::upper_bound(segment_begin.begin(), segment_begin.end(), utc_seconds) - segment_begin.begin() - 1;
+}
+
+const tTimeZone& tTimeZone::Get(const std::string& name)
+{
+  static std::mutex mutex;
+  static std::map<std::string, std::unique_ptr<tTimeZone>> zones;
+  std::lock_guard<std::mutex> lock(mutex);
+  std::unique_ptr<tTimeZone>& zone = zones[name];
+  if (!zone)
+  {
+    try
+    {
+      zone.reset(new tTimeZone(name));
+    }
+    catch (...)
+    {
+      zones.erase(name);
+      throw;
+    }
+  }
+  return *zone;
+}
+
+tDuration tTimeZone::GetUtcOffset(const tTimestamp& timestamp) const
+{
+  int64_t seconds = std::chrono::duration_cast<std::chrono::seconds>(timestamp.time_since_epoch()).count();
+  if (timestamp < tTimestamp(std::chrono::seconds(seconds)))
+  {
+    seconds--;  // round towards negative infinity
+  }
+  return std::chrono::seconds(GetUtcOffsetSeconds(seconds));
+}
+
+void tTimeZone::ParseTzif(const unsigned char* data, size_t size)
+{
+  // Header: magic, version, reserved, isutcnt, isstdcnt, leapcnt, timecnt, typecnt, charcnt
+  if (size < cTZIF_HEADER_SIZE || data[0] != 'T' || data[1] != 'Z' || data[2] != 'i' || data[3] != 'f')
+  {
+    throw std::runtime_error("No TZif header");
+  }
+  bool version_2 = data[4] >= '2';
+  size_t time_size = 4;
+  for (int block = 0; ; block++)
+  {
+    size_t utc_count = ReadBigEndian32(data + 20), std_count = ReadBigEndian32(data + 24), leap_count = ReadBigEndian32(data + 28);
+    size_t time_count = ReadBigEndian32(data + 32), type_count = ReadBigEndian32(data + 36), char_count = ReadBigEndian32(data + 40);
+    size_t block_size = time_count * (time_size + 1) + type_count * 6 + char_count + leap_count * (time_size + 4) + std_count + utc_count;
+    if (type_count == 0 || size < cTZIF_HEADER_SIZE + block_size)
+    {
+      throw std::runtime_error("Truncated data block");
+    }
+    if (version_2 && block == 0)
+    {
+      // Skip version 1 data block (32 bit times)
+      data += cTZIF_HEADER_SIZE + block_size;
+      size -= cTZIF_HEADER_SIZE + block_size;
+      time_size = 8;
+      if (size < cTZIF_HEADER_SIZE || data[0] != 'T' || data[1] != 'Z' || data[2] != 'i' || data[3] != 'f')
+      {
+        throw std::runtime_error("No second TZif header");
+      }
+      continue;
+    }
+
+    const unsigned char* times = data + cTZIF_HEADER_SIZE;
+    const unsigned char* type_indices = times + time_count * time_size;
+    const unsigned char* types = type_indices + time_count;
+    AddSegment(std::numeric_limits<int64_t>::min(), static_cast<int32_t>(ReadBigEndian32(types)));
+    int64_t last_time = 0;
+    for (size_t i = 0; i < time_count; i++)
+    {
+      int64_t time = time_size == 8 ? ReadBigEndian64(times + i * 8) : static_cast<int32_t>(ReadBigEndian32(times + i * 4));
+      size_t type = type_indices[i];
+      if (type >= type_count || time <= segment_begin.back() || (i > 0 && time <= last_time))
+      {
+        throw std::runtime_error("Invalid transition");
+      }
+      AddSegment(time, static_cast<int32_t>(ReadBigEndian32(types + type * 6)));
+      last_time = time;
+    }
+
+    // Footer with POSIX TZ rule for times after last transition ("\nrule\n")
+    const unsigned char* footer = data + cTZIF_HEADER_SIZE + block_size;
+    const unsigned char* end = data + size;
+    if (version_2 && footer < end && *footer == '\n')
+    {
+      const unsigned char* rule_end = std::find(footer + 1, end, '\n');
+      if (rule_end == end)
+      {
+        throw std::runtime_error("Truncated footer");
+      }
+      if (rule_end > footer + 1)
+      {
+        AddRuleTransitions(std::string(footer + 1, rule_end));
+      }
+    }
+    return;
+  }
+}
+
+std::string ToIsoString(const tTimestamp& timestamp, const tTimeZone& zone)
+{
+  struct tCachedFormatter
+  {
+    uint64_t zone_id = 0;
+    tIsoTimestampFormatter formatter;
+  };
+  static thread_local tCachedFormatter cache[cFORMATTER_CACHE_SIZE];
+  static thread_local size_t next_replaced = 0;
+
+  for (tCachedFormatter & entry : cache)
+  {
+    if (entry.zone_id == zone.id)
+    {
+      return entry.formatter.Format(timestamp);
+    }
+  }
+  tCachedFormatter& entry = cache[next_replaced];
+  next_replaced = (next_replaced + 1) % cFORMATTER_CACHE_SIZE;
+  entry.zone_id = zone.id;
+  entry.formatter = tIsoTimestampFormatter(zone);
+  return entry.formatter.Format(timestamp);
+}
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
@@ -0,0 +1,194 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    rrlib/time/tTimeZone.h
+ *
+ * \author  agent
+ *
+ * \date    2026-10-18
+ *
+ * \brief   Contains tTimeZone
+ *
+ * \b tTimeZone
+ *
+ * Time zone loaded from the system's time zone database (TZif files in /usr/share/zoneinfo).
+ * Allows formatting and rounding timestamps in time zones other than the process' local one.
+ *
+ */
+//----------------------------------------------------------------------
+#ifndef __rrlib__time__tTimeZone_h__
+#define __rrlib__time__tTimeZone_h__
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <atomic>
+#include <string>
+#include <vector>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/time/time.h"
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace time
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Class declaration
+//----------------------------------------------------------------------
+//! Time zone from TZif file
+/*!
+ * Loads a time zone from a TZif file (RFC 8536 - versions 1 to 4).
+ * On loading, the file's transitions are copied to a table that is extended with the
+ * transitions generated by the file's POSIX TZ rule - up to the end of tTimestamp's range.
+ * Offset lookups are therefore a binary search only - with a cache for the last hit
+ * (so that lookups for nearby timestamps need two comparisons).
+ *
+ * Lookups are thread-safe and do not acquire any locks.
+ * Leap seconds in TZif files ("right/" zones) are ignored.
+ */
+class tTimeZone
+{
+
+//----------------------------------------------------------------------
+// Public methods and typedefs
+//----------------------------------------------------------------------
+public:
+
+  /*!
+   * Loads time zone
+   *
+   * \param name Name of time zone in time zone database (e.g. "Europe/Berlin") or absolute path of TZif file.
+   *             Zone files are looked up in $TZDIR or - if not set - in /usr/share/zoneinfo.
+   *             "UTC" is always available (also without time zone database).
+   * \throws std::runtime_error if time zone file cannot be loaded
+   */
+  explicit tTimeZone(const std::string& name);
+
+  tTimeZone(const tTimeZone&) = delete;
+  tTimeZone& operator=(const tTimeZone&) = delete;
+
+  /*!
+   * Returns time zone from process-wide cache - loading it on first access.
+   * Only this call acquires a lock - so it should not be called in time-critical code.
+   *
+   * \param name Name of time zone (see constructor)
+   * \return Time zone (reference remains valid until program exits)
+   * \throws std::runtime_error if time zone file cannot be loaded
+   */
+  static const tTimeZone& Get(const std::string& name);
+
+  /*!
+   * \return Name of time zone
+   */
+  const std::string& GetName() const
+  {
+    return name;
+  }
+
+  /*!
+   * \param timestamp Timestamp
+   * \return Offset of local time in this zone to UTC at specified time
+   */
+  tDuration GetUtcOffset(const tTimestamp& timestamp) const;
+
+  /*!
+   * \param utc_seconds Seconds since 1970-01-01T00:00:00Z
+   * \return Offset of local time in this zone to UTC at specified time (in seconds)
+   */
+  int GetUtcOffsetSeconds(int64_t utc_seconds) const
+  {
+    size_t index = last_index.load(std::memory_order_relaxed);
+    if (utc_seconds < segment_begin[index] || (index + 1 < segment_begin.size() && utc_seconds >= segment_begin[index + 1]))
+    {
+      index = FindSegment(utc_seconds);
+      last_index.store(index, std::memory_order_relaxed);
+    }
+    return segment_offset[index];
+  }
+
+//----------------------------------------------------------------------
+// Private fields and methods
+//----------------------------------------------------------------------
+private:
+
+  /*! Name of time zone */
+  std::string name;
+
+  /*!
+   * Periods with constant UTC offset:
+   * Offset segment_offset[i] is valid from segment_begin[i] (UTC seconds) to segment_begin[i + 1].
+   * segment_begin[0] is the smallest int64_t.
+   */
+  std::vector<int64_t> segment_begin;
+  std::vector<int> segment_offset;
+
+  /*! Index of segment returned by last lookup */
+  mutable std::atomic<size_t> last_index;
+
+  /*! Unique ID of this object (identifies zone in ToIsoString()'s formatter cache - unlike addresses, IDs are never reused) */
+  uint64_t id;
+
+  friend std::string ToIsoString(const tTimestamp& timestamp, const tTimeZone& zone);
+
+  /*! Binary search for segment containing specified time */
+  size_t FindSegment(int64_t utc_seconds) const;
+
+  /*! Parses TZif data (throws std::runtime_error on invalid data) */
+  void ParseTzif(const unsigned char* data, size_t size);
+
+  /*! Adds transitions generated by POSIX TZ rule (from TZif footer) */
+  void AddRuleTransitions(const std::string& rule);
+
+  /*! Adds segment (must begin after last one) - merging it with previous one if offset is identical */
+  void AddSegment(int64_t begin, int offset);
+};
+
+/*!
+ * Turns Timestamp into string representation following ISO 8601 - in specified time zone
+ * (format is identical to ToIsoString(timestamp)).
+ * Each thread caches formatters for the last few zones used - so repeated calls only render sub-second digits
+ * (see tIsoTimestampFormatter for formatting into buffers without allocating strings).
+ *
+ * \param timestamp Timestamp to convert
+ * \param zone Time zone
+ * \return String representation of timestamp
+ */
+std::string ToIsoString(const tTimestamp& timestamp, const tTimeZone& zone);
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
+
+
+#endif
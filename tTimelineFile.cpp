@@ -0,0 +1,595 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    rrlib/time/tTimelineFile.cpp
+ *
+ * \author  agent
+ *
+ * \date    2026-10-18
+ *
+ */
+//----------------------------------------------------------------------
+#include "rrlib/time/tTimelineFile.h"
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+#include <cassert>
+
+//----------------------------------------------------------------------
+// Namespace usage
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace time
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+namespace
+{
+
+struct tFileHeader
+{
+  char magic[8];
+  uint64_t version;
+};
+
+struct tTrailer
+{
+  uint64_t index_offset, block_count;
+  char magic[8];
+};
+
+}
+
+//----------------------------------------------------------------------
+// Const values
+//----------------------------------------------------------------------
+
+static const char cMAGIC[8] = { 'R', 'R', 'T', 'I', 'M', 'E', 'L', 'N' };
+static const uint64_t cVERSION = 1;
+
+/*! Value of 'reserved' in the record header that marks the start of the index (records always have 0 there) */
+static const uint32_t cINDEX_MARKER = 0x58444E49;  // "INDX"
+
+//----------------------------------------------------------------------
+// Implementation
+//----------------------------------------------------------------------
+
+/*! Reads exactly 'size' bytes at 'offset' from file (throws std::runtime_error on failure) */
+static void ReadFile(int file_descriptor, void* buffer, size_t size, uint64_t offset, const std::string& file_name)
+{
+  char* destination = static_cast<char*>(buffer);
+  while (size)
+  {
+    ssize_t result = pread(file_descriptor, destination, size, offset);
+    if (result < 0 && errno == EINTR)
+    {
+      continue;
+    }
+    if (result <= 0)
+    {
+      throw std::runtime_error("Could not read timeline file '" + file_name + "'");
+    }
+    destination += result;
+    size -= result;
+    offset += result;
+  }
+}
+
+/*!
+ * Reads index of timeline file
+ *
+ * \param file_size Size of file
+ * \return Offset of index (marker) in file - which is the end of the records (0 if file has no valid index - e.g. because tTimelineWriter was not closed)
+ */
+static uint64_t ReadIndex(int file_descriptor, uint64_t file_size, std::vector<internal::tTimelineBlock>& index, const std::string& file_name)
+{
+  tFileHeader header;
+  tTrailer trailer;
+  if (file_size < sizeof(tFileHeader))
+  {
+    throw std::runtime_error("Invalid timeline file '" + file_name + "': file too small");
+  }
+  ReadFile(file_descriptor, &header, sizeof(header), 0, file_name);
+  if (memcmp(header.magic, cMAGIC, sizeof(cMAGIC)) != 0 || header.version != cVERSION)
+  {
+    throw std::runtime_error("Invalid timeline file '" + file_name + "': no timeline file header");
+  }
+  const uint64_t index_overhead = sizeof(internal::tTimelineRecordHeader) + sizeof(tTrailer);  // marker and trailer
+  if (file_size < sizeof(tFileHeader) + index_overhead)
+  {
+    return 0;
+  }
+  ReadFile(file_descriptor, &trailer, sizeof(trailer), file_size - sizeof(tTrailer), file_name);
+  if (memcmp(trailer.magic, cMAGIC, sizeof(cMAGIC)) != 0 || trailer.index_offset < sizeof(tFileHeader) || trailer.index_offset > file_size - index_overhead ||
+      trailer.block_count > (file_size - index_overhead - trailer.index_offset) / sizeof(internal::tTimelineBlock) ||
+      trailer.index_offset + trailer.block_count * sizeof(internal::tTimelineBlock) + index_overhead != file_size)
+  {
+    return 0;
+  }
+  internal::tTimelineRecordHeader marker;
+  ReadFile(file_descriptor, &marker, sizeof(marker), trailer.index_offset, file_name);
+  if (marker.reserved != cINDEX_MARKER)
+  {
+    return 0;
+  }
+  index.resize(trailer.block_count);
+  if (trailer.block_count)
+  {
+    ReadFile(file_descriptor, index.data(), trailer.block_count * sizeof(internal::tTimelineBlock), trailer.index_offset + sizeof(marker), file_name);
+  }
+  uint64_t block_end = sizeof(tFileHeader);
+  for (const internal::tTimelineBlock & block : index)
+  {
+    if (block.offset < block_end || block.size > trailer.index_offset - block.offset || block.min > block.max)
+    {
+      index.clear();
+      return 0;
+    }
+    block_end = block.offset + block.size;
+  }
+  return trailer.index_offset;
+}
+
+/*!
+ * Rebuilds index of timeline file without valid index by scanning its records.
+ * Scanning stops at the first incomplete record - or at the marker in front of an index written by tTimelineWriter::Close().
+ *
+ * \param file_size Size of file
+ * \param block_size Maximum size of blocks in rebuilt index
+ * \return Offset after last complete record
+ */
+static uint64_t RecoverIndex(int file_descriptor, uint64_t file_size, size_t block_size, std::vector<internal::tTimelineBlock>& index, const std::string& file_name)
+{
+  index.clear();
+  uint64_t offset = sizeof(tFileHeader);
+  if (file_size <= offset)
+  {
+    return offset;
+  }
+  void* mapped_data = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+  if (mapped_data == MAP_FAILED)
+  {
+    throw std::runtime_error("Could not map timeline file '" + file_name + "'");
+  }
+  const uint8_t* data = static_cast<const uint8_t*>(mapped_data);
+  internal::tTimelineBlock block = internal::tTimelineBlock();
+  block.offset = offset;
+  while (file_size - offset >= sizeof(internal::tTimelineRecordHeader))
+  {
+    internal::tTimelineRecordHeader header;
+    memcpy(&header, data + offset, sizeof(header));
+    size_t record_size = internal::TimelineRecordSize(header.size);
+    if (header.reserved != 0 || record_size > file_size - offset)  // index marker or incomplete record
+    {
+      break;
+    }
+    if (block.record_count && block.size + record_size > block_size)
+    {
+      index.push_back(block);
+      block = internal::tTimelineBlock();
+      block.offset = offset;
+    }
+    if (block.record_count == 0)
+    {
+      block.min = header.timestamp;
+      block.max = header.timestamp;
+    }
+    block.min = std::min(block.min, header.timestamp);
+    block.max = std::max(block.max, header.timestamp);
+    block.record_count++;
+    block.size += record_size;
+    offset += record_size;
+  }
+  if (block.record_count)
+  {
+    index.push_back(block);
+  }
+  munmap(mapped_data, file_size);
+  return offset;
+}
+
+tTimelineWriter::tTimelineWriter(const std::string& file_name, size_t block_size) :
+  file_name(file_name),
+  file_descriptor(open(file_name.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644)),
+  block_size(block_size),
+  file_end(sizeof(tFileHeader)),
+  index(),
+  block(),
+  block_info()
+{
+  struct stat status;
+  if (file_descriptor < 0 || fstat(file_descriptor, &status) != 0)
+  {
+    if (file_descriptor >= 0)
+    {
+      close(file_descriptor);
+    }
+    throw std::runtime_error("Could not open timeline file '" + file_name + "'");
+  }
+  try
+  {
+    if (status.st_size == 0)
+    {
+      tFileHeader header;
+      memcpy(header.magic, cMAGIC, sizeof(cMAGIC));
+      header.version = cVERSION;
+      Write(&header, sizeof(header), 0);
+    }
+    else
+    {
+      // Append: remove index (it is written again on Close()) - or rebuild it if writer was not closed properly
+      file_end = ReadIndex(file_descriptor, status.st_size, index, file_name);
+      if (file_end == 0)
+      {
+        file_end = RecoverIndex(file_descriptor, status.st_size, block_size, index, file_name);
+      }
+      if (ftruncate(file_descriptor, file_end) != 0)
+      {
+        throw std::runtime_error("Could not truncate timeline file '" + file_name + "'");
+      }
+    }
+  }
+  catch (...)
+  {
+    close(file_descriptor);
+    throw;
+  }
+  block.reserve(block_size);
+}
+
+void tTimelineWriter::Repair(const std::string& file_name, size_t block_size)
+{
+  struct stat status;
+  if (stat(file_name.c_str(), &status) != 0)
+  {
+    throw std::runtime_error("Could not open timeline file '" + file_name + "'");
+  }
+  tTimelineWriter(file_name, block_size).Close();
+}
+
+tTimelineWriter::~tTimelineWriter()
+{
+  try
+  {
+    Close();
+  }
+  catch (const std::exception&)
+  {}
+}
+
+void tTimelineWriter::Append(const tTimestamp& timestamp, const void* data, size_t size)
+{
+  assert(file_descriptor >= 0);
+  if (size > std::numeric_limits<uint32_t>::max())
+  {
+    throw std::runtime_error("Record too large for timeline file");
+  }
+  size_t record_size = internal::TimelineRecordSize(size);
+  if (block.size() && block.size() + record_size > block_size)
+  {
+    Flush();
+  }
+
+  internal::tTimelineRecordHeader header;
+  header.timestamp = timestamp.time_since_epoch().count();
+  header.size = static_cast<uint32_t>(size);
+  header.reserved = 0;
+  size_t offset = block.size();
+  block.resize(offset + record_size);
+  memcpy(&block[offset], &header, sizeof(header));
+  memcpy(&block[offset + sizeof(header)], data, size);
+  memset(&block[offset + sizeof(header) + size], 0, record_size - sizeof(header) - size);
+
+  if (block_info.record_count == 0)
+  {
+    block_info.min = header.timestamp;
+    block_info.max = header.timestamp;
+  }
+  block_info.min = std::min(block_info.min, header.timestamp);
+  block_info.max = std::max(block_info.max, header.timestamp);
+  block_info.record_count++;
+}
+
+void tTimelineWriter::Flush()
+{
+  if (block.empty())
+  {
+    return;
+  }
+  Write(block.data(), block.size(), file_end);
+  block_info.offset = file_end;
+  block_info.size = block.size();
+  index.push_back(block_info);
+  file_end += block.size();
+  block.clear();
+  block_info = internal::tTimelineBlock();
+}
+
+void tTimelineWriter::Close()
+{
+  if (file_descriptor < 0)
+  {
+    return;
+  }
+  try
+  {
+    Flush();
+    internal::tTimelineRecordHeader marker;
+    marker.timestamp = 0;
+    marker.size = 0;
+    marker.reserved = cINDEX_MARKER;
+    tTrailer trailer;
+    trailer.index_offset = file_end;
+    trailer.block_count = index.size();
+    memcpy(trailer.magic, cMAGIC, sizeof(cMAGIC));
+    Write(&marker, sizeof(marker), file_end);
+    Write(index.data(), index.size() * sizeof(internal::tTimelineBlock), file_end + sizeof(marker));
+    Write(&trailer, sizeof(trailer), file_end + sizeof(marker) + index.size() * sizeof(internal::tTimelineBlock));
+  }
+  catch (...)
+  {
+    close(file_descriptor);
+    file_descriptor = -1;
+    throw;
+  }
+  int result = close(file_descriptor);
+  file_descriptor = -1;
+  if (result != 0)
+  {
+    throw std::runtime_error("Could not close timeline file '" + file_name + "'");
+  }
+}
+
+void tTimelineWriter::Write(const void* data, size_t size, uint64_t offset)
+{
+  const char* source = static_cast<const char*>(data);
+  while (size)
+  {
+    ssize_t result = pwrite(file_descriptor, source, size, offset);
+    if (result < 0 && errno == EINTR)
+    {
+      continue;
+    }
+    if (result <= 0)
+    {
+      throw std::runtime_error("Could not write to timeline file '" + file_name + "'");
+    }
+    source += result;
+    size -= result;
+    offset += result;
+  }
+}
+
+tTimelineRange::tTimelineRange(int64_t range_begin, int64_t range_end) :
+  mapped_data(MAP_FAILED),
+  mapped_size(0),
+  range_begin(range_begin),
+  range_end(range_end),
+  blocks()
+{}
+
+tTimelineRange::tTimelineRange(tTimelineRange && other) :
+  mapped_data(other.mapped_data),
+  mapped_size(other.mapped_size),
+  range_begin(other.range_begin),
+  range_end(other.range_end),
+  blocks(std::move(other.blocks))
+{
+  other.mapped_data = MAP_FAILED;
+  other.mapped_size = 0;
+  other.blocks.clear();
+}
+
+tTimelineRange& tTimelineRange::operator=(tTimelineRange && other)
+{
+  std::swap(mapped_data, other.mapped_data);
+  std::swap(mapped_size, other.mapped_size);
+  std::swap(range_begin, other.range_begin);
+  std::swap(range_end, other.range_end);
+  std::swap(blocks, other.blocks);
+  return *this;
+}
+
+tTimelineRange::~tTimelineRange()
+{
+  if (mapped_data != MAP_FAILED)
+  {
+    munmap(mapped_data, mapped_size);
+  }
+}
+
+tTimelineRange::tIterator tTimelineRange::begin() const
+{
+  if (blocks.empty())
+  {
+    return end();
+  }
+  tIterator result(this, 0, blocks[0].first);
+  result.Advance(false);
+  return result;
+}
+
+void tTimelineRange::tIterator::Advance(bool skip_current)
+{
+  if (skip_current)
+  {
+    position += internal::TimelineRecordSize(record.size);
+  }
+  while (block < range->blocks.size())
+  {
+    const uint8_t* block_end = range->blocks[block].second;
+    while (position < block_end)
+    {
+      internal::tTimelineRecordHeader header;
+      if (static_cast<size_t>(block_end - position) < sizeof(header))
+      {
+        throw std::runtime_error("Corrupt timeline file: truncated record");
+      }
+      memcpy(&header, position, sizeof(header));
+      size_t record_size = internal::TimelineRecordSize(header.size);
+      if (record_size > static_cast<size_t>(block_end - position))
+      {
+        throw std::runtime_error("Corrupt timeline file: truncated record");
+      }
+      if (header.timestamp >= range->range_begin && header.timestamp < range->range_end)
+      {
+        record.timestamp = tTimestamp(tDuration(header.timestamp));
+        record.data = position + sizeof(header);
+        record.size = header.size;
+        return;
+      }
+      position += record_size;
+    }
+    block++;
+    if (block < range->blocks.size())
+    {
+      position = range->blocks[block].first;
+    }
+  }
+  position = nullptr;
+}
+
+tTimelineFile::tTimelineFile(const std::string& file_name) :
+  file_name(file_name),
+  file_descriptor(open(file_name.c_str(), O_RDONLY | O_CLOEXEC)),
+  index(),
+  prefix_max(),
+  suffix_min()
+{
+  struct stat status;
+  if (file_descriptor < 0 || fstat(file_descriptor, &status) != 0 || (!S_ISREG(status.st_mode)))
+  {
+    if (file_descriptor >= 0)
+    {
+      close(file_descriptor);
+    }
+    throw std::runtime_error("Could not open timeline file '" + file_name + "'");
+  }
+  try
+  {
+    if (ReadIndex(file_descriptor, status.st_size, index, file_name) == 0)
+    {
+      throw std::runtime_error("Invalid timeline file '" + file_name + "': no valid index (file not closed properly? see tTimelineWriter::Repair())");
+    }
+  }
+  catch (...)
+  {
+    close(file_descriptor);
+    throw;
+  }
+
+  prefix_max.resize(index.size());
+  suffix_min.resize(index.size());
+  for (size_t i = 0; i < index.size(); i++)
+  {
+    prefix_max[i] = i ? std::max(prefix_max[i - 1], index[i].max) : index[i].max;
+  }
+  for (size_t i = index.size(); i-- > 0;)
+  {
+    suffix_min[i] = i + 1 < index.size() ? std::min(suffix_min[i + 1], index[i].min) : index[i].min;
+  }
+}
+
+tTimelineFile::~tTimelineFile()
+{
+  close(file_descriptor);
+}
+
+size_t tTimelineFile::GetRecordCount() const
+{
+  size_t result = 0;
+  for (const internal::tTimelineBlock & block : index)
+  {
+    result += block.record_count;
+  }
+  return result;
+}
+
+tTimelineRange tTimelineFile::Query(const tTimestamp& begin, const tTimestamp& end) const
+{
+  tTimelineRange result(begin.time_since_epoch().count(), end.time_since_epoch().count());
+  if (result.range_begin >= result.range_end)
+  {
+    return result;
+  }
+
+  // Candidate blocks: blocks after the first one with maximum >= begin and before the first one from which on all minima are >= end
+  size_t first = std::lower_bound(prefix_max.begin(), prefix_max.end(), result.range_begin) - prefix_max.begin();
+  size_t last = std::lower_bound(suffix_min.begin(), suffix_min.end(), result.range_end) - suffix_min.begin();
+  if (first >= last)
+  {
+    return result;
+  }
+
+  // Map all candidate blocks with a single mapping (pages of blocks that are not accessed are never read)
+  static const uint64_t cPAGE_SIZE = sysconf(_SC_PAGESIZE);
+  uint64_t map_offset = index[first].offset - index[first].offset % cPAGE_SIZE;
+  uint64_t map_end = index[last - 1].offset + index[last - 1].size;
+  result.mapped_size = map_end - map_offset;
+  result.mapped_data = mmap(nullptr, result.mapped_size, PROT_READ, MAP_PRIVATE, file_descriptor, map_offset);
+  if (result.mapped_data == MAP_FAILED)
+  {
+    result.mapped_size = 0;
+    throw std::runtime_error("Could not map timeline file '" + file_name + "'");
+  }
+  const uint8_t* data = static_cast<const uint8_t*>(result.mapped_data);
+  for (size_t i = first; i < last; i++)
+  {
+    if (index[i].min < result.range_end && index[i].max >= result.range_begin)
+    {
+      const uint8_t* block = data + (index[i].offset - map_offset);
+      result.blocks.emplace_back(block, block + index[i].size);
+    }
+  }
+  return result;
+}
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
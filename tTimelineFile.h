@@ -0,0 +1,415 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    rrlib/time/tTimelineFile.h
+ *
+ * \author  agent
+ *
+ * \date    2026-10-18
+ *
+ * \brief   Contains tTimelineWriter, tTimelineFile and tTimelineRange
+ *
+ * \b tTimelineWriter
+ *
+ * Appends timestamped records (arbitrary binary data) to a timeline file.
+ *
+ * \b tTimelineFile
+ *
+ * Provides efficient access to the records in a timeline file within a time range.
+ *
+ * \b tTimelineRange
+ *
+ * Result of a query: records within a time range - accessed directly in the memory-mapped file.
+ *
+ * File format (native byte order):
+ *  - 16 byte file header (magic "RRTIMELN", version)
+ *  - Blocks of records. Each record consists of timestamp (int64, nanoseconds since epoch),
+ *    size (uint32), 4 reserved bytes and data - padded to a multiple of 8 bytes
+ *    (so record data is 8-byte-aligned in memory-mapped files).
+ *  - Index marker: record header with 'reserved' set to "INDX" (records always have 0 there)
+ *  - Index: for each block, its offset, size, record count and minimum and maximum timestamp
+ *  - 24 byte trailer (index offset, block count, magic)
+ * Records are typically appended in chronological order - but this is not required.
+ * As records are self-delimiting, the index of a file that was not closed properly (e.g. because the writing process crashed)
+ * can be rebuilt from the records (see tTimelineWriter::Repair()).
+ * Queries only map blocks whose time span overlaps the queried range - so they touch only
+ * a few pages even in very large files.
+ */
+//----------------------------------------------------------------------
+#ifndef __rrlib__time__tTimelineFile_h__
+#define __rrlib__time__tTimelineFile_h__
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <vector>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/time/time.h"
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace time
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+/*!
+ * Record in timeline file
+ */
+struct tTimelineRecord
+{
+  tTimestamp timestamp;
+
+  /*! Record data (points into memory-mapped file - valid as long as tTimelineRange exists) */
+  const void* data;
+
+  /*! Size of record data in bytes */
+  size_t size;
+};
+
+namespace internal
+{
+
+/*! Block entry in index of timeline file */
+struct tTimelineBlock
+{
+  uint64_t offset, size, record_count;
+  int64_t min, max;  // minimum and maximum timestamp in block (nanoseconds since epoch)
+};
+
+/*! Header of every record in timeline file */
+struct tTimelineRecordHeader
+{
+  int64_t timestamp;
+  uint32_t size;
+  uint32_t reserved;
+};
+
+/*! \return Size of record with specified data size in timeline file */
+constexpr size_t TimelineRecordSize(size_t data_size)
+{
+  return sizeof(tTimelineRecordHeader) + ((data_size + 7) & ~static_cast<size_t>(7));
+}
+
+}
+
+//----------------------------------------------------------------------
+// Class declaration
+//----------------------------------------------------------------------
+//! Writer for timeline files
+/*!
+ * Appends records to timeline file.
+ * Records are collected in a block which is written to the file when it is full.
+ * The index is written when the writer is closed.
+ * Not thread-safe.
+ */
+class tTimelineWriter
+{
+
+//----------------------------------------------------------------------
+// Public methods and typedefs
+//----------------------------------------------------------------------
+public:
+
+  /*! Default size of blocks in bytes */
+  enum { cDEFAULT_BLOCK_SIZE = 1024 * 1024 };
+
+  /*!
+   * Opens timeline file for writing. If file exists, records are appended.
+   * If the existing file has no valid index (because a writer was not closed properly), its index is rebuilt
+   * from the records - and an incomplete last record is removed.
+   *
+   * \param file_name Name of file
+   * \param block_size Size of blocks in bytes (smaller blocks make queries more fine-grained - but increase size of index)
+   * \throws std::runtime_error if file cannot be opened or is not a timeline file
+   */
+  explicit tTimelineWriter(const std::string& file_name, size_t block_size = cDEFAULT_BLOCK_SIZE);
+
+  /*! Closes file (see Close()) - errors are ignored */
+  ~tTimelineWriter();
+
+  /*!
+   * Repairs timeline file whose writer was not closed properly:
+   * Rebuilds index from records (an incomplete last record is removed).
+   * Does nothing if file has a valid index.
+   *
+   * \param file_name Name of existing timeline file
+   * \param block_size Size of blocks in rebuilt index
+   * \throws std::runtime_error if file cannot be opened or is not a timeline file
+   */
+  static void Repair(const std::string& file_name, size_t block_size = cDEFAULT_BLOCK_SIZE);
+
+  tTimelineWriter(const tTimelineWriter&) = delete;
+  tTimelineWriter& operator=(const tTimelineWriter&) = delete;
+
+  /*!
+   * Appends record
+   *
+   * \param timestamp Timestamp of record
+   * \param data Record data
+   * \param size Size of record data in bytes
+   * \throws std::runtime_error if writing fails
+   */
+  void Append(const tTimestamp& timestamp, const void* data, size_t size);
+
+  /*!
+   * Writes index and closes file.
+   * Afterwards, writer must not be used anymore.
+   *
+   * \throws std::runtime_error if writing fails
+   */
+  void Close();
+
+  /*!
+   * Writes current block to file (even if it is not full)
+   *
+   * \throws std::runtime_error if writing fails
+   */
+  void Flush();
+
+//----------------------------------------------------------------------
+// Private fields and methods
+//----------------------------------------------------------------------
+private:
+
+  /*! Name of file */
+  std::string file_name;
+
+  /*! File descriptor (-1 if closed) */
+  int file_descriptor;
+
+  /*! Size of blocks in bytes */
+  size_t block_size;
+
+  /*! Offset of next block in file */
+  uint64_t file_end;
+
+  /*! Index of blocks that have been written */
+  std::vector<internal::tTimelineBlock> index;
+
+  /*! Current block */
+  std::vector<uint8_t> block;
+  internal::tTimelineBlock block_info;
+
+  /*! Writes data to file at specified offset (throws std::runtime_error on failure) */
+  void Write(const void* data, size_t size, uint64_t offset);
+};
+
+//----------------------------------------------------------------------
+// Class declaration
+//----------------------------------------------------------------------
+//! Records in timeline file within a time range
+/*!
+ * Result of tTimelineFile::Query().
+ * Keeps relevant part of file mapped to memory as long as it exists.
+ * Iterating yields all records in the time range (in the order they were appended).
+ */
+class tTimelineRange
+{
+  friend class tTimelineFile;
+
+//----------------------------------------------------------------------
+// Public methods and typedefs
+//----------------------------------------------------------------------
+public:
+
+  class tIterator
+  {
+    friend class tTimelineRange;
+  public:
+
+    typedef std::forward_iterator_tag iterator_category;
+    typedef const tTimelineRecord value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const tTimelineRecord* pointer;
+    typedef const tTimelineRecord& reference;
+
+    const tTimelineRecord& operator*() const
+    {
+      return record;
+    }
+    const tTimelineRecord* operator->() const
+    {
+      return &record;
+    }
+    tIterator& operator++()
+    {
+      Advance();
+      return *this;
+    }
+    tIterator operator++(int)
+    {
+      tIterator result(*this);
+      Advance();
+      return result;
+    }
+    bool operator==(const tIterator& other) const
+    {
+      return position == other.position;
+    }
+    bool operator!=(const tIterator& other) const
+    {
+      return position != other.position;
+    }
+
+  private:
+
+    const tTimelineRange* range;
+    size_t block;
+    const uint8_t* position;  // position of current record (nullptr at end)
+    tTimelineRecord record;
+
+    tIterator(const tTimelineRange* range, size_t block, const uint8_t* position) :
+      range(range), block(block), position(position), record()
+    {}
+
+    /*! Moves to next record in time range (starting with record at 'position' if 'skip_current' is false) */
+    void Advance(bool skip_current = true);
+  };
+
+  tTimelineRange(tTimelineRange && other);
+  tTimelineRange& operator=(tTimelineRange && other);
+  ~tTimelineRange();
+
+  tIterator begin() const;
+  tIterator end() const
+  {
+    return tIterator(this, blocks.size(), nullptr);
+  }
+
+  /*!
+   * \return Size of memory mapped for this range in bytes
+   */
+  size_t GetMappedSize() const
+  {
+    return mapped_size;
+  }
+
+//----------------------------------------------------------------------
+// Private fields and methods
+//----------------------------------------------------------------------
+private:
+
+  /*! Memory mapping */
+  void* mapped_data;
+  size_t mapped_size;
+
+  /*! Time range (nanoseconds since epoch - end is exclusive) */
+  int64_t range_begin, range_end;
+
+  /*! Blocks that overlap time range: start and end of each block's records */
+  std::vector<std::pair<const uint8_t*, const uint8_t*>> blocks;
+
+  tTimelineRange(int64_t range_begin, int64_t range_end);
+};
+
+//----------------------------------------------------------------------
+// Class declaration
+//----------------------------------------------------------------------
+//! Timeline file
+/*!
+ * Opens timeline file for reading and allows to query records within time ranges.
+ * Only the index is read on opening. Queries are thread-safe.
+ */
+class tTimelineFile
+{
+
+//----------------------------------------------------------------------
+// Public methods and typedefs
+//----------------------------------------------------------------------
+public:
+
+  /*!
+   * \param file_name Name of file
+   * \throws std::runtime_error if file cannot be opened or is not a valid timeline file (e.g. because tTimelineWriter was not closed - see tTimelineWriter::Repair())
+   */
+  explicit tTimelineFile(const std::string& file_name);
+
+  ~tTimelineFile();
+
+  tTimelineFile(const tTimelineFile&) = delete;
+  tTimelineFile& operator=(const tTimelineFile&) = delete;
+
+  /*!
+   * \return Number of blocks in file
+   */
+  size_t GetBlockCount() const
+  {
+    return index.size();
+  }
+
+  /*!
+   * \return Number of records in file
+   */
+  size_t GetRecordCount() const;
+
+  /*!
+   * Returns records within time range.
+   * Only blocks with records in this range are mapped to memory (pages are only read when records are accessed).
+   *
+   * \param begin Start of time range
+   * \param end End of time range (exclusive)
+   * \return Records within time range
+   * \throws std::runtime_error if mapping file fails
+   */
+  tTimelineRange Query(const tTimestamp& begin, const tTimestamp& end) const;
+
+//----------------------------------------------------------------------
+// Private fields and methods
+//----------------------------------------------------------------------
+private:
+
+  /*! Name of file */
+  std::string file_name;
+
+  /*! File descriptor */
+  int file_descriptor;
+
+  /*! Index of blocks */
+  std::vector<internal::tTimelineBlock> index;
+
+  /*!
+   * Maximum of block maxima up to (including) block i and minimum of block minima from block i on.
+   * Both are sorted - so that binary search can be used to find first and last block that may overlap time range.
+   */
+  std::vector<int64_t> prefix_max, suffix_min;
+};
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
+
+
+#endif
@@ -0,0 +1,297 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    rrlib/time/tTimestampCodec.cpp
+ *
+ * \author  agent
+ *
+ * \date    2026-10-18
+ *
+ */
+//----------------------------------------------------------------------
+#include "rrlib/time/tTimestampCodec.h"
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/time/varint.h"
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+#include <cassert>
+
+//----------------------------------------------------------------------
+// Namespace usage
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace time
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Const values
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Implementation
+//----------------------------------------------------------------------
+
+/*! Reads varint (throws std::runtime_error if it is truncated or invalid) */
+static inline uint64_t ReadVarint(const uint8_t*& position, const uint8_t* end)
+{
+  uint64_t value;
+  if (!internal::ReadVarint(position, end, value))
+  {
+    throw std::runtime_error("Corrupt timestamp data: invalid varint");
+  }
+  return value;
+}
+
+static inline void WriteLittleEndian(uint8_t* buffer, uint64_t value, size_t bytes)
+{
+  for (size_t i = 0; i < bytes; i++)
+  {
+    buffer[i] = static_cast<uint8_t>(value >> (8 * i));
+  }
+}
+
+static inline uint64_t ReadLittleEndian(const uint8_t* buffer, size_t bytes)
+{
+  uint64_t result = 0;
+  for (size_t i = 0; i < bytes; i++)
+  {
+    result |= static_cast<uint64_t>(buffer[i]) << (8 * i);
+  }
+  return result;
+}
+
+tTimestampEncoder::tTimestampEncoder(size_t block_size) :
+  block_size(block_size),
+  payload(),
+  payload_size(0),
+  count(0),
+  first(0),
+  last(0),
+  last_delta(0)
+{
+  if (block_size == 0 || block_size > std::numeric_limits<uint32_t>::max() / internal::cMAX_VARINT_SIZE)
+  {
+    throw std::runtime_error("Invalid block size for tTimestampEncoder");
+  }
+  payload.resize((block_size - 1) * internal::cMAX_VARINT_SIZE);
+}
+
+void tTimestampEncoder::Encode(const tTimestamp* timestamps, size_t count, std::vector<uint8_t>& output)
+{
+  for (size_t i = 0; i < count; i++)
+  {
+    int64_t value = timestamps[i].time_since_epoch().count();
+    if (this->count == 0)
+    {
+      first = value;
+      last = value;
+      last_delta = 0;
+    }
+    else
+    {
+      // first delta is stored as delta-of-delta to zero
+      uint64_t delta = static_cast<uint64_t>(value) - static_cast<uint64_t>(last);
+      payload_size = internal::WriteVarint(&payload[payload_size], internal::ZigZagEncode(delta - static_cast<uint64_t>(last_delta))) - payload.data();
+      last = value;
+      last_delta = static_cast<int64_t>(delta);
+    }
+    this->count++;
+    if (this->count == block_size)
+    {
+      Flush(output);
+    }
+  }
+}
+
+void tTimestampEncoder::Flush(std::vector<uint8_t>& output)
+{
+  if (count == 0)
+  {
+    return;
+  }
+  size_t offset = output.size();
+  output.resize(offset + cBLOCK_HEADER_SIZE + payload_size);
+  uint8_t* header = &output[offset];
+  WriteLittleEndian(header, static_cast<uint64_t>(first), 8);
+  WriteLittleEndian(header + 8, static_cast<uint64_t>(last), 8);
+  WriteLittleEndian(header + 16, count, 4);
+  WriteLittleEndian(header + 20, payload_size, 4);
+  std::copy(payload.data(), payload.data() + payload_size, header + cBLOCK_HEADER_SIZE);
+  count = 0;
+  payload_size = 0;
+}
+
+tTimestampDecoder::tTimestampDecoder(const uint8_t* data, size_t size) :
+  data(data),
+  size(size),
+  next_block(0),
+  position(data),
+  payload_end(data),
+  remaining(0),
+  block_start(false),
+  last(0),
+  last_delta(0)
+{}
+
+void tTimestampDecoder::ReadBlockHeader(size_t offset, int64_t& first, int64_t& last, size_t& count, size_t& payload_size) const
+{
+  if (size - offset < tTimestampEncoder::cBLOCK_HEADER_SIZE)
+  {
+    throw std::runtime_error("Corrupt timestamp data: truncated block header");
+  }
+  const uint8_t* header = data + offset;
+  first = static_cast<int64_t>(ReadLittleEndian(header, 8));
+  last = static_cast<int64_t>(ReadLittleEndian(header + 8, 8));
+  count = ReadLittleEndian(header + 16, 4);
+  payload_size = ReadLittleEndian(header + 20, 4);
+  if (count == 0 || payload_size > size - offset - tTimestampEncoder::cBLOCK_HEADER_SIZE)
+  {
+    throw std::runtime_error("Corrupt timestamp data: invalid block header");
+  }
+}
+
+bool tTimestampDecoder::NextBlock()
+{
+  if (next_block >= size)
+  {
+    return false;
+  }
+  int64_t first, block_last;
+  size_t count, payload_size;
+  ReadBlockHeader(next_block, first, block_last, count, payload_size);
+  position = data + next_block + tTimestampEncoder::cBLOCK_HEADER_SIZE;
+  payload_end = position + payload_size;
+  next_block += tTimestampEncoder::cBLOCK_HEADER_SIZE + payload_size;
+  remaining = count;
+  block_start = true;
+  last = first;
+  last_delta = 0;
+  return true;
+}
+
+inline int64_t tTimestampDecoder::DecodeNext()
+{
+  assert(remaining > 0);
+  remaining--;
+  if (block_start)
+  {
+    block_start = false;
+  }
+  else
+  {
+    last_delta = static_cast<int64_t>(static_cast<uint64_t>(last_delta) + internal::ZigZagDecode(ReadVarint(position, payload_end)));
+    last = static_cast<int64_t>(static_cast<uint64_t>(last) + static_cast<uint64_t>(last_delta));
+  }
+  if (remaining == 0 && position != payload_end)
+  {
+    throw std::runtime_error("Corrupt timestamp data: payload size does not match");
+  }
+  return last;
+}
+
+size_t tTimestampDecoder::Decode(tTimestamp* output, size_t max_count)
+{
+  size_t decoded = 0;
+  while (decoded < max_count)
+  {
+    if (remaining == 0 && !NextBlock())
+    {
+      break;
+    }
+    size_t n = std::min(remaining, max_count - decoded);
+    for (size_t i = 0; i < n; i++)
+    {
+      output[decoded++] = tTimestamp(tDuration(DecodeNext()));
+    }
+  }
+  return decoded;
+}
+
+void tTimestampDecoder::Seek(const tTimestamp& timestamp)
+{
+  Rewind();
+  int64_t target = timestamp.time_since_epoch().count();
+  while (next_block < size)
+  {
+    int64_t first, block_last;
+    size_t count, payload_size;
+    ReadBlockHeader(next_block, first, block_last, count, payload_size);
+    if (std::max(first, block_last) < target)
+    {
+      next_block += tTimestampEncoder::cBLOCK_HEADER_SIZE + payload_size;
+      continue;
+    }
+
+    NextBlock();
+    while (remaining)
+    {
+      const uint8_t* saved_position = position;
+      size_t saved_remaining = remaining;
+      bool saved_block_start = block_start;
+      int64_t saved_last = last, saved_last_delta = last_delta;
+      if (DecodeNext() >= target)
+      {
+        position = saved_position;
+        remaining = saved_remaining;
+        block_start = saved_block_start;
+        last = saved_last;
+        last_delta = saved_last_delta;
+        return;
+      }
+    }
+  }
+}
+
+void tTimestampDecoder::Rewind()
+{
+  next_block = 0;
+  position = data;
+  payload_end = data;
+  remaining = 0;
+  block_start = false;
+}
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
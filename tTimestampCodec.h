@@ -0,0 +1,233 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    rrlib/time/tTimestampCodec.h
+ *
+ * \author  agent
+ *
+ * \date    2026-10-18
+ *
+ * \brief   Contains tTimestampEncoder and tTimestampDecoder
+ *
+ * \b tTimestampEncoder
+ *
+ * Compresses sequences of timestamps (e.g. sample times of a sensor) for storage or transmission.
+ *
+ * \b tTimestampDecoder
+ *
+ * Decompresses data created by tTimestampEncoder.
+ *
+ * Format:
+ * Data consists of blocks. Each block starts with a 24 byte header (all values little endian):
+ *  - first timestamp of block (int64, nanoseconds since epoch)
+ *  - last timestamp of block (int64)
+ *  - number of timestamps in block (uint32)
+ *  - size of block's payload in bytes (uint32)
+ * The payload contains the second timestamp as delta to the first one - and all further
+ * timestamps as delta-of-delta (difference between consecutive deltas).
+ * All values are zig-zag encoded varints (LEB128). For periodic samples, most deltas-of-deltas
+ * are small - and take one or two bytes.
+ * Blocks can be skipped by reading their headers only - which allows seeking.
+ */
+//----------------------------------------------------------------------
+#ifndef __rrlib__time__tTimestampCodec_h__
+#define __rrlib__time__tTimestampCodec_h__
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <cstdint>
+#include <vector>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/time/time.h"
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace time
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Class declaration
+//----------------------------------------------------------------------
+//! Timestamp sequence encoder
+/*!
+ * Encodes timestamps using delta-of-delta and zig-zag varint encoding (see file description).
+ * Timestamps are collected in a block - which is appended to the output when it is full.
+ * Timestamps may be in any order - sorted sequences with regular intervals compress best.
+ */
+class tTimestampEncoder
+{
+
+//----------------------------------------------------------------------
+// Public methods and typedefs
+//----------------------------------------------------------------------
+public:
+
+  /*! Size of block header in bytes */
+  enum { cBLOCK_HEADER_SIZE = 24 };
+
+  /*! Default number of timestamps per block */
+  enum { cDEFAULT_BLOCK_SIZE = 1024 };
+
+  /*!
+   * \param block_size Number of timestamps per block (smaller blocks allow more fine-grained seeking - larger blocks compress slightly better)
+   */
+  tTimestampEncoder(size_t block_size = cDEFAULT_BLOCK_SIZE);
+
+  /*!
+   * Encodes timestamps
+   *
+   * \param timestamps Timestamps to encode
+   * \param count Number of timestamps
+   * \param output Completed blocks are appended to this vector
+   */
+  void Encode(const tTimestamp* timestamps, size_t count, std::vector<uint8_t>& output);
+
+  /*!
+   * Appends current block to output - even if it is not full yet
+   * (e.g. before closing a file or sending a message)
+   *
+   * \param output Vector to append block to
+   */
+  void Flush(std::vector<uint8_t>& output);
+
+//----------------------------------------------------------------------
+// Private fields and methods
+//----------------------------------------------------------------------
+private:
+
+  /*! Number of timestamps per block */
+  size_t block_size;
+
+  /*! Payload of current block (allocated for maximum size) */
+  std::vector<uint8_t> payload;
+  size_t payload_size;
+
+  /*! Number of timestamps in current block */
+  size_t count;
+
+  /*! First and last timestamp in current block, delta between last two (nanoseconds) */
+  int64_t first, last, last_delta;
+};
+
+//----------------------------------------------------------------------
+// Class declaration
+//----------------------------------------------------------------------
+//! Timestamp sequence decoder
+/*!
+ * Decodes data created by tTimestampEncoder.
+ * The data is not copied - and must exist as long as the decoder is used.
+ */
+class tTimestampDecoder
+{
+
+//----------------------------------------------------------------------
+// Public methods and typedefs
+//----------------------------------------------------------------------
+public:
+
+  /*!
+   * \param data Encoded data (one or more complete blocks)
+   * \param size Size of data in bytes
+   */
+  tTimestampDecoder(const uint8_t* data, size_t size);
+
+  /*!
+   * Decodes timestamps
+   *
+   * \param output Array to write decoded timestamps to
+   * \param max_count Maximum number of timestamps to decode (size of output array)
+   * \return Number of decoded timestamps (0 if end of data has been reached)
+   * \throws std::runtime_error if data is corrupt
+   */
+  size_t Decode(tTimestamp* output, size_t max_count);
+
+  /*!
+   * Positions decoder at the first timestamp that is not before specified timestamp
+   * (assumes that timestamps are sorted - otherwise, blocks are skipped based on their first and last timestamp only).
+   * Blocks before this timestamp are skipped without decoding them.
+   *
+   * \param timestamp Timestamp to seek to
+   * \throws std::runtime_error if data is corrupt
+   */
+  void Seek(const tTimestamp& timestamp);
+
+  /*!
+   * Positions decoder at the start of the data
+   */
+  void Rewind();
+
+//----------------------------------------------------------------------
+// Private fields and methods
+//----------------------------------------------------------------------
+private:
+
+  /*! Encoded data */
+  const uint8_t* data;
+  size_t size;
+
+  /*! Position of next block header */
+  size_t next_block;
+
+  /*! Current position in payload of current block and end of payload */
+  const uint8_t* position;
+  const uint8_t* payload_end;
+
+  /*! Number of timestamps in current block that have not been decoded yet */
+  size_t remaining;
+
+  /*! True if first timestamp of current block (stored in header) has not been decoded yet */
+  bool block_start;
+
+  /*! Last decoded timestamp and delta (nanoseconds) */
+  int64_t last, last_delta;
+
+  /*!
+   * Reads and checks block header at specified offset
+   * \throws std::runtime_error if header is invalid
+   */
+  void ReadBlockHeader(size_t offset, int64_t& first, int64_t& last, size_t& count, size_t& payload_size) const;
+
+  /*! Starts decoding block at next_block - \return False if there are no more blocks */
+  bool NextBlock();
+
+  /*! Decodes next timestamp from current block (remaining must be > 0) */
+  int64_t DecodeNext();
+};
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
+
+
+#endif
@@ -0,0 +1,151 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    rrlib/time/tTimestampIndex.cpp
+ *
+ * \author  agent
+ *
+ * \date    2026-10-18
+ *
+ */
+//----------------------------------------------------------------------
+#include "rrlib/time/tTimestampIndex.h"
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+#include <cassert>
+
+//----------------------------------------------------------------------
+// Namespace usage
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace time
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Const values
+//----------------------------------------------------------------------
+
+
+//----------------------------------------------------------------------
+// Implementation
+//----------------------------------------------------------------------
+
+tTimestampIndex::tTimestampIndex(const tTimestamp* timestamps, size_t count) :
+  sorted(count),
+  interpolation_offset(0),
+  interpolation_scale(0),
+  buckets(count / cBUCKET_SIZE + 1, tBucket { count, 0 })
+{
+  for (size_t i = 0; i < count; i++)
+  {
+    sorted[i] = timestamps[i].time_since_epoch().count();
+    if (i && sorted[i] < sorted[i - 1])
+    {
+      throw std::runtime_error("Timestamps for tTimestampIndex must be sorted");
+    }
+  }
+  if (count > 1 && sorted.back() > sorted.front())
+  {
+    interpolation_offset = static_cast<double>(sorted.front());
+    interpolation_scale = (count - 1) / (static_cast<double>(sorted.back()) - interpolation_offset);
+  }
+
+  // Values in (sorted[i - 1], sorted[i]] have search result i (Ceil) - and estimated positions between those of sorted[i - 1] and sorted[i]
+  // (the same holds for [sorted[i - 1], sorted[i]) and Floor)
+  size_t previous_position = 0;
+  for (size_t i = 0; i <= count; i++)
+  {
+    size_t position = i < count ? Interpolate(sorted[i]) : count;
+    for (size_t bucket = previous_position / cBUCKET_SIZE; bucket <= position / cBUCKET_SIZE; bucket++)
+    {
+      buckets[bucket].begin = std::min(buckets[bucket].begin, i);
+      buckets[bucket].end = std::max(buckets[bucket].end, i);
+    }
+    previous_position = position;
+  }
+}
+
+void tTimestampIndex::Ceil(const tTimestamp* probes, size_t count, size_t* result) const
+{
+  int64_t previous_value = std::numeric_limits<int64_t>::max();
+  size_t previous_result = 0;
+  for (size_t i = 0; i < count; i++)
+  {
+    int64_t value = probes[i].time_since_epoch().count();
+    previous_result = Search<false>(value, value >= previous_value ? previous_result : 0);
+    previous_value = value;
+    result[i] = previous_result;
+  }
+}
+
+void tTimestampIndex::Floor(const tTimestamp* probes, size_t count, size_t* result) const
+{
+  int64_t previous_value = std::numeric_limits<int64_t>::max();
+  size_t upper_bound = 0;
+  for (size_t i = 0; i < count; i++)
+  {
+    int64_t value = probes[i].time_since_epoch().count();
+    upper_bound = Search<true>(value, value >= previous_value ? upper_bound : 0);
+    previous_value = value;
+    result[i] = upper_bound ? upper_bound - 1 : sorted.size();
+  }
+}
+
+void tTimestampIndex::Nearest(const tTimestamp* probes, size_t count, size_t* result) const
+{
+  int64_t previous_value = std::numeric_limits<int64_t>::max();
+  size_t ceil = 0;
+  for (size_t i = 0; i < count; i++)
+  {
+    int64_t value = probes[i].time_since_epoch().count();
+    ceil = Search<false>(value, value >= previous_value ? ceil : 0);
+    previous_value = value;
+    result[i] = Nearest(value, ceil);
+  }
+}
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
@@ -0,0 +1,265 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    rrlib/time/tTimestampIndex.h
+ *
+ * \author  agent
+ *
+ * \date    2026-10-18
+ *
+ * \brief   Contains tTimestampIndex
+ *
+ * \b tTimestampIndex
+ *
+ * Index over a sorted array of timestamps for fast lookup of the sample closest to a given time
+ * (e.g. for sensor fusion).
+ *
+ * Timestamps of periodic samples are close to uniformly distributed: The position of a
+ * timestamp in the sorted array can be estimated by linear interpolation. For each group of
+ * cBUCKET_SIZE estimated positions, the index stores the range of actual positions that values
+ * with this estimate can have. A lookup therefore touches one bucket entry and the few
+ * cache lines of the sorted array in this range - instead of causing a cache miss in almost
+ * every step as std::lower_bound does on large arrays.
+ * Gaps in the data (e.g. paused recordings) only widen the ranges of buckets near the gap.
+ * For very irregular data, lookups degrade to a binary search on the whole array.
+ */
+//----------------------------------------------------------------------
+#ifndef __rrlib__time__tTimestampIndex_h__
+#define __rrlib__time__tTimestampIndex_h__
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <cstdint>
+#include <vector>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/time/time.h"
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace time
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Class declaration
+//----------------------------------------------------------------------
+//! Index for nearest-time lookup in sorted timestamp arrays
+/*!
+ * All queries return indices in the original array - or GetSize() if there is no such timestamp.
+ * If the array contains equal timestamps, Ceil and Nearest return the first - Floor the last of them.
+ * The index does not reference the original array - and is immutable (queries are thread-safe).
+ */
+class tTimestampIndex
+{
+
+//----------------------------------------------------------------------
+// Public methods and typedefs
+//----------------------------------------------------------------------
+public:
+
+  /*!
+   * \param timestamps Sorted array of timestamps
+   * \param count Number of timestamps
+   * \throws std::runtime_error if timestamps are not sorted
+   */
+  tTimestampIndex(const tTimestamp* timestamps, size_t count);
+
+  /*!
+   * \return Number of timestamps in index
+   */
+  size_t GetSize() const
+  {
+    return sorted.size();
+  }
+
+  /*!
+   * \param index Index of timestamp (< GetSize())
+   * \return Timestamp with this index
+   */
+  tTimestamp Get(size_t index) const
+  {
+    return tTimestamp(tDuration(sorted[index]));
+  }
+
+  /*!
+   * \param timestamp Timestamp to look up
+   * \return Index of first timestamp that is not before 'timestamp' (as std::lower_bound)
+   */
+  size_t Ceil(const tTimestamp& timestamp) const
+  {
+    return Search<false>(timestamp.time_since_epoch().count());
+  }
+
+  /*!
+   * \param timestamp Timestamp to look up
+   * \return Index of last timestamp that is not after 'timestamp'
+   */
+  size_t Floor(const tTimestamp& timestamp) const
+  {
+    size_t upper_bound = Search<true>(timestamp.time_since_epoch().count());
+    return upper_bound ? upper_bound - 1 : sorted.size();
+  }
+
+  /*!
+   * \param timestamp Timestamp to look up
+   * \return Index of timestamp closest to 'timestamp' (the earlier one on ties)
+   */
+  size_t Nearest(const tTimestamp& timestamp) const
+  {
+    int64_t value = timestamp.time_since_epoch().count();
+    return Nearest(value, Search<false>(value));
+  }
+
+  /*!
+   * Batch variants of the queries above.
+   * If probes are sorted, each search starts from the previous result (galloping search) -
+   * so that close probes are looked up in a few steps. Unsorted probes are supported as well.
+   *
+   * \param probes Timestamps to look up
+   * \param count Number of timestamps to look up
+   * \param result Array that resulting indices are written to (must have 'count' elements)
+   */
+  void Ceil(const tTimestamp* probes, size_t count, size_t* result) const;
+  void Floor(const tTimestamp* probes, size_t count, size_t* result) const;
+  void Nearest(const tTimestamp* probes, size_t count, size_t* result) const;
+
+//----------------------------------------------------------------------
+// Private fields and methods
+//----------------------------------------------------------------------
+private:
+
+  /*! Number of estimated positions per bucket */
+  enum { cBUCKET_SIZE = 8 };
+
+  /*! Range of possible positions for all values whose estimated position is in bucket (end is inclusive) */
+  struct tBucket
+  {
+    size_t begin, end;
+  };
+
+  /*! Timestamps in sorted order (nanoseconds since epoch) */
+  std::vector<int64_t> sorted;
+
+  /*! Parameters for interpolation: estimated position = (value - interpolation_offset) * interpolation_scale */
+  double interpolation_offset, interpolation_scale;
+
+  /*! Buckets (bucket i contains estimated positions i * cBUCKET_SIZE to (i + 1) * cBUCKET_SIZE - 1) */
+  std::vector<tBucket> buckets;
+
+  /*! \return Estimated position of value in sorted array (monotonic in value) */
+  size_t Interpolate(int64_t value) const
+  {
+    double position = (static_cast<double>(value) - interpolation_offset) * interpolation_scale;
+    return position <= 0 ? 0 : (position >= sorted.size() ? sorted.size() : static_cast<size_t>(position));
+  }
+
+  /*!
+   * Searches for first timestamp >= value (or > value if cUPPER_BOUND is true)
+   *
+   * \param first Index that result is known to be not smaller than (result for a smaller probe value)
+   * \return Index in sorted array (GetSize() if there is no such timestamp)
+   */
+  template <bool cUPPER_BOUND>
+  size_t Search(int64_t value, size_t first = 0) const
+  {
+    const tBucket& bucket = buckets[Interpolate(value) / cBUCKET_SIZE];
+    size_t begin = bucket.begin, end = bucket.end;
+    if (first > begin)
+    {
+      // Previous result is in range: gallop from there (consecutive sorted probes usually have close results)
+      begin = first;
+      for (size_t step = 1; step < end - begin; step *= 2)
+      {
+        if (!Before<cUPPER_BOUND>(sorted[begin + step - 1], value))
+        {
+          end = begin + step - 1;
+          break;
+        }
+        begin += step;
+      }
+    }
+    while (begin < end)
+    {
+      size_t middle = (begin + end) / 2;
+      if (Before<cUPPER_BOUND>(sorted[middle], value))
+      {
+        begin = middle + 1;
+      }
+      else
+      {
+        end = middle;
+      }
+    }
+    return begin;
+  }
+
+  /*! \return Whether timestamp is before search result for value */
+  template <bool cUPPER_BOUND>
+  static bool Before(int64_t timestamp, int64_t value)
+  {
+    return cUPPER_BOUND ? timestamp <= value : timestamp < value;
+  }
+
+  /*! \return Index of closest timestamp - given index of first timestamp >= value */
+  size_t Nearest(int64_t value, size_t ceil) const
+  {
+    if (ceil == 0)
+    {
+      return 0;
+    }
+    if (ceil < sorted.size())
+    {
+      // compare as unsigned differences to avoid overflow
+      uint64_t after = static_cast<uint64_t>(sorted[ceil]) - static_cast<uint64_t>(value);
+      uint64_t before = static_cast<uint64_t>(value) - static_cast<uint64_t>(sorted[ceil - 1]);
+      if (before > after)
+      {
+        return ceil;
+      }
+    }
+    // first of several equal timestamps
+    size_t result = ceil - 1;
+    while (result > 0 && sorted[result - 1] == sorted[result])
+    {
+      result--;
+    }
+    return result;
+  }
+};
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
+
+
+#endif
@@ -0,0 +1,205 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    rrlib/time/tTokenBucket.h
+ *
+ * \author  agent
+ *
+ * \date    2026-10-18
+ *
+ * \brief   Contains tTokenBucket
+ *
+ * \b tTokenBucket
+ *
+ * Lock-free token bucket for rate limiting (e.g. log output, network sends or retries).
+ * Tokens are refilled at a constant rate in application time - so limits follow time stretching
+ * (e.g. a simulation running at double speed may send twice as many messages per second of system time).
+ *
+ * Instead of a token count and the time of the last refill, the bucket stores a single timestamp:
+ * the time at which the bucket was (or will be) empty - if no tokens had been acquired after that.
+ * The number of tokens at time t is (t - empty time) * rate - limited to the capacity.
+ * So the complete state fits into one 64 bit word that is updated with compare-and-swap
+ * (as in the "generic cell rate algorithm").
+ *
+ * Example:
+ *   static tTokenBucket log_limit(10, 20);  // 10 messages per second - bursts of up to 20 messages
+ *   if (log_limit.TryAcquire())
+ *   {
+ *     RRLIB_LOG_PRINT(WARNING, ...);
+ *   }
+ */
+//----------------------------------------------------------------------
+#ifndef __rrlib__time__tTokenBucket_h__
+#define __rrlib__time__tTokenBucket_h__
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/time/time.h"
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+#include <cassert>
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace time
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Class declaration
+//----------------------------------------------------------------------
+//! Token bucket rate limiter
+/*!
+ * All methods are thread-safe and lock-free.
+ * Application time is assumed to advance monotonically
+ * (if it jumps back, no tokens are refilled until it reaches the previous time again).
+ */
+class tTokenBucket
+{
+
+//----------------------------------------------------------------------
+// Public methods and typedefs
+//----------------------------------------------------------------------
+public:
+
+  /*!
+   * \param rate Tokens per second (application time - at most one billion: the refill interval is rounded to nanoseconds)
+   * \param capacity Maximum number of tokens in bucket (maximum burst)
+   * \param full Whether bucket is initially full (otherwise, it is empty)
+   * \param now Current application time
+   */
+  tTokenBucket(double rate, uint64_t capacity, bool full = true, const tTimestamp& now = Now()) :
+    interval(std::max<int64_t>(1, std::llround(1e9 / rate))),
+    capacity(capacity),
+    capacity_time(static_cast<int64_t>(capacity) * interval),
+    empty_time(now.time_since_epoch().count() - (full ? capacity_time : 0))
+  {
+    assert(rate > 0 && capacity > 0);
+  }
+
+  /*!
+   * Acquires tokens if enough tokens are available
+   *
+   * \param tokens Number of tokens to acquire
+   * \param now Current application time
+   * \return True if tokens were acquired. False if not enough tokens are available (no tokens are acquired in this case).
+   */
+  bool TryAcquire(uint64_t tokens = 1, const tTimestamp& now = Now())
+  {
+    if (tokens > GetCapacity())
+    {
+      return false;  // (also avoids overflow when computing cost)
+    }
+    int64_t time = now.time_since_epoch().count();
+    int64_t cost = static_cast<int64_t>(tokens) * interval;
+    int64_t current = empty_time.load(std::memory_order_relaxed);
+    while (true)
+    {
+      int64_t updated = std::max(current, time - capacity_time) + cost;
+      if (updated > time)
+      {
+        return false;
+      }
+      if (empty_time.compare_exchange_weak(current, updated, std::memory_order_relaxed))
+      {
+        return true;
+      }
+    }
+  }
+
+  /*!
+   * \param tokens Number of tokens
+   * \param now Current application time
+   * \return Duration (application time) until the specified number of tokens will be available (zero if they are available now - tDuration::max() if tokens exceed capacity)
+   */
+  tDuration GetTimeUntilAvailable(uint64_t tokens = 1, const tTimestamp& now = Now()) const
+  {
+    if (tokens > GetCapacity())
+    {
+      return tDuration::max();
+    }
+    int64_t time = now.time_since_epoch().count();
+    int64_t cost = static_cast<int64_t>(tokens) * interval;
+    int64_t available_time = std::max(empty_time.load(std::memory_order_relaxed), time - capacity_time) + cost;
+    return tDuration(std::max<int64_t>(0, available_time - time));
+  }
+
+  /*!
+   * \param now Current application time
+   * \return Number of tokens currently available (may be fractional - or negative if application time jumped back)
+   */
+  double GetAvailableTokens(const tTimestamp& now = Now()) const
+  {
+    int64_t time = now.time_since_epoch().count();
+    return static_cast<double>(time - std::max(empty_time.load(std::memory_order_relaxed), time - capacity_time)) / interval;
+  }
+
+  /*!
+   * \return Capacity of bucket
+   */
+  uint64_t GetCapacity() const
+  {
+    return capacity;
+  }
+
+//----------------------------------------------------------------------
+// Private fields and methods
+//----------------------------------------------------------------------
+private:
+
+  /*! Refill interval per token (nanoseconds) */
+  const int64_t interval;
+
+  /*! Maximum number of tokens in bucket */
+  const uint64_t capacity;
+
+  /*! Time to refill whole bucket (nanoseconds) */
+  const int64_t capacity_time;
+
+  /*! Time at which bucket was (or will be) empty (nanoseconds since epoch - see file description) */
+  std::atomic<int64_t> empty_time;
+};
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
+
+
+#endif
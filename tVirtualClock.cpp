@@ -0,0 +1,234 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    rrlib/time/tVirtualClock.cpp
+ *
+ * \author  agent
+ *
+ * \date    2026-10-18
+ *
+ */
+//----------------------------------------------------------------------
+#include "rrlib/time/tVirtualClock.h"
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <algorithm>
+#include <stdexcept>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+#include <cassert>
+
+//----------------------------------------------------------------------
+// Namespace usage
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace time
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Const values
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Implementation
+//----------------------------------------------------------------------
+
+/*! Clock that current thread is registered with as worker (nullptr if none) */
+static thread_local tVirtualClock* worker_clock = nullptr;
+
+tVirtualClock::tWorker::tWorker(tVirtualClock& clock) :
+  clock(clock)
+{
+  if (worker_clock)
+  {
+    throw std::runtime_error("Thread is already registered as worker of a tVirtualClock");
+  }
+  std::lock_guard<std::mutex> lock(clock.mutex);
+  worker_clock = &clock;
+  clock.worker_count++;
+}
+
+tVirtualClock::tWorker::~tWorker()
+{
+  std::lock_guard<std::mutex> lock(clock.mutex);
+  worker_clock = nullptr;
+  clock.worker_count--;
+  clock.TryAdvance();  // remaining workers may all be blocked
+}
+
+tVirtualClock::tVirtualClock(const tTimestamp& start_time) :
+  time(start_time),
+  worker_count(0),
+  blocked_worker_count(0)
+{
+  SetTimeSource(this, start_time);
+}
+
+tVirtualClock::~tVirtualClock()
+{
+  assert(waiters.empty() && worker_count == 0);
+  if (IsCurrentTimeSource())
+  {
+    SetTimeSource(NULL, tTimestamp());
+  }
+}
+
+tTimestamp tVirtualClock::GetTime() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return time;
+}
+
+bool tVirtualClock::WaitUntil(const tTimestamp& deadline, const std::function<bool()>& predicate)
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  tWaiter waiter = { deadline, worker_clock == this, false };
+  waiters.push_back(&waiter);
+  bool result = false;
+  while (true)
+  {
+    if (predicate && predicate())
+    {
+      result = true;
+      break;
+    }
+    if (deadline != cNO_TIME && time >= deadline)
+    {
+      break;
+    }
+    if (!waiter.blocked)
+    {
+      Block(waiter);
+    }
+    if (!TryAdvance())
+    {
+      wake_up.wait(lock);
+    }
+  }
+  if (waiter.blocked)
+  {
+    Unblock(waiter);
+  }
+  waiters.erase(std::find(waiters.begin(), waiters.end(), &waiter));
+  return result;
+}
+
+void tVirtualClock::BlockUntil(const tTimestamp& wake_up_time) const
+{
+  if (worker_clock == this)
+  {
+    worker_clock->SleepUntil(wake_up_time);  // virtual time only advances while all workers are blocked in the clock
+  }
+  else
+  {
+    tCustomClock::BlockUntil(wake_up_time);
+  }
+}
+
+void tVirtualClock::Notify()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  for (tWaiter * waiter : waiters)
+  {
+    if (waiter->blocked)
+    {
+      Unblock(*waiter);
+    }
+  }
+  wake_up.notify_all();
+}
+
+void tVirtualClock::Block(tWaiter& waiter)
+{
+  waiter.blocked = true;
+  if (waiter.worker)
+  {
+    blocked_worker_count++;
+  }
+}
+
+void tVirtualClock::Unblock(tWaiter& waiter)
+{
+  waiter.blocked = false;
+  if (waiter.worker)
+  {
+    blocked_worker_count--;
+  }
+}
+
+bool tVirtualClock::TryAdvance()
+{
+  if (blocked_worker_count < worker_count)
+  {
+    return false;
+  }
+  tTimestamp earliest = cNO_TIME;
+  for (tWaiter * waiter : waiters)
+  {
+    if (waiter->blocked && waiter->deadline != cNO_TIME && (earliest == cNO_TIME || waiter->deadline < earliest))
+    {
+      earliest = waiter->deadline;
+    }
+  }
+  if (earliest == cNO_TIME)
+  {
+    return false;
+  }
+
+  // Waiters whose deadline has been reached become runnable at once (so that time is not advanced again before they run)
+  if (earliest > time)
+  {
+    time = earliest;
+    SetApplicationTime(time);
+  }
+  for (tWaiter * waiter : waiters)
+  {
+    if (waiter->blocked && waiter->deadline != cNO_TIME && waiter->deadline <= time)
+    {
+      Unblock(*waiter);
+    }
+  }
+  wake_up.notify_all();
+  return true;
+}
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
@@ -0,0 +1,224 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    rrlib/time/tVirtualClock.h
+ *
+ * \author  agent
+ *
+ * \date    2026-10-18
+ *
+ * \brief   Contains tVirtualClock
+ *
+ * \b tVirtualClock
+ *
+ * Custom clock for discrete-event simulation: application time does not advance on its own -
+ * it jumps to the earliest pending wake-up as soon as all registered worker threads are blocked
+ * in SleepUntil(), SleepFor() or WaitUntil() of the clock.
+ * So tests and batch simulations run as fast as the CPU allows (instead of waiting for
+ * system time to pass) - with application time behaving as if sleeps took exactly the requested time.
+ *
+ * Worker threads register with a tWorker object. A worker that is not blocked in one of the clock's
+ * functions (e.g. because it is computing or waiting for I/O) is considered to be running - and time
+ * does not advance until it blocks in the clock again.
+ * Threads that are not registered may also sleep and wait - but they never prevent time from advancing.
+ * rrlib::time::SleepUntil() and SleepFor() block in the clock if the calling thread is a worker of the clock.
+ * As time advances as soon as all registered workers are blocked, a thread that starts several workers
+ * should be registered as worker itself until the new workers have registered.
+ * Setting application time notifies all tTimeStretchingListeners (e.g. tWatchdog).
+ *
+ * Example:
+ *   tVirtualClock clock(start_time);
+ *   std::thread thread([&]()
+ *   {
+ *     tVirtualClock::tWorker worker(clock);
+ *     while (...)
+ *     {
+ *       ... // control cycle
+ *       clock.SleepFor(std::chrono::milliseconds(10));
+ *     }
+ *   });
+ */
+//----------------------------------------------------------------------
+#ifndef __rrlib__time__tVirtualClock_h__
+#define __rrlib__time__tVirtualClock_h__
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/time/tCustomClock.h"
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace time
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Class declaration
+//----------------------------------------------------------------------
+//! Virtual time for discrete-event simulation
+/*!
+ * All methods are thread-safe.
+ * If all workers wait without deadline (and are not notified), they wait forever.
+ */
+class tVirtualClock : public tCustomClock
+{
+
+//----------------------------------------------------------------------
+// Public methods and typedefs
+//----------------------------------------------------------------------
+public:
+
+  /*!
+   * Registers current thread as worker (for its lifetime).
+   * A thread may be worker of one clock at a time (otherwise, constructor throws std::runtime_error).
+   */
+  class tWorker
+  {
+  public:
+    explicit tWorker(tVirtualClock& clock);
+    ~tWorker();
+
+    tWorker(const tWorker&) = delete;
+    tWorker& operator=(const tWorker&) = delete;
+
+  private:
+    tVirtualClock& clock;
+  };
+
+  /*!
+   * Creates clock and sets it as time source for application time
+   *
+   * \param start_time Initial application time
+   */
+  explicit tVirtualClock(const tTimestamp& start_time = Now());
+
+  /*! Resets time source to stretched system time (if clock is still current time source) - no thread may be waiting */
+  ~tVirtualClock();
+
+  /*!
+   * \return Current virtual time (equals Now() while clock is current time source)
+   */
+  tTimestamp GetTime() const;
+
+  /*!
+   * Blocks calling thread until virtual time has reached wake-up time
+   *
+   * \param wake_up_time Wake-up time
+   */
+  void SleepUntil(const tTimestamp& wake_up_time)
+  {
+    WaitUntil(wake_up_time, std::function<bool()>());
+  }
+
+  /*!
+   * Blocks calling thread until virtual time has advanced by specified duration
+   *
+   * \param duration Duration to sleep
+   */
+  void SleepFor(const tDuration& duration)
+  {
+    SleepUntil(GetTime() + duration);
+  }
+
+  /*!
+   * Blocks calling thread until predicate is true or deadline has been reached.
+   * Predicate is checked on calling and after each call to Notify() - with the clock's mutex locked
+   * (so it should only read state that is changed before calling Notify()).
+   *
+   * \param deadline Deadline (cNO_TIME for no deadline)
+   * \param predicate Predicate to wait for (if empty, waits until deadline)
+   * \return Result of predicate (false if deadline was reached)
+   */
+  bool WaitUntil(const tTimestamp& deadline, const std::function<bool()>& predicate);
+
+  /*!
+   * Wakes up all threads blocked in WaitUntil() - in order to check their predicates
+   */
+  void Notify();
+
+  /*!
+   * Workers of this clock block in SleepUntil(). Other threads sleep as in tCustomClock.
+   */
+  virtual void BlockUntil(const tTimestamp& wake_up_time) const override;
+
+//----------------------------------------------------------------------
+// Private fields and methods
+//----------------------------------------------------------------------
+private:
+
+  /*! Thread blocked in WaitUntil() */
+  struct tWaiter
+  {
+    tTimestamp deadline;
+    bool worker;
+    bool blocked;  // false while thread is runnable (e.g. after being notified but before it checked its predicate)
+  };
+
+  /*! Mutex for all members below */
+  mutable std::mutex mutex;
+
+  /*! Signals waiters that they are runnable */
+  std::condition_variable wake_up;
+
+  /*! Current virtual time */
+  tTimestamp time;
+
+  /*! Number of registered workers - and of workers that are blocked */
+  size_t worker_count, blocked_worker_count;
+
+  /*! Threads currently in WaitUntil() */
+  std::vector<tWaiter*> waiters;
+
+  /*! Marks waiter as blocked/runnable */
+  void Block(tWaiter& waiter);
+  void Unblock(tWaiter& waiter);
+
+  /*!
+   * Advances time to earliest deadline of blocked waiters if no worker is running (mutex must be locked)
+   *
+   * \return True if time was advanced
+   */
+  bool TryAdvance();
+};
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
+
+
+#endif
@@ -0,0 +1,271 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    rrlib/time/tWatchdog.cpp
+ *
+ * \author  agent
+ *
+ * \date    2026-10-18
+ *
+ */
+//----------------------------------------------------------------------
+#include "rrlib/time/tWatchdog.h"
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <algorithm>
+#include <utility>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+#include <cassert>
+
+//----------------------------------------------------------------------
+// Namespace usage
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace time
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Const values
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Implementation
+//----------------------------------------------------------------------
+
+tWatchdog::tHandle::tHandle(tHandle && other) :
+  watchdog(other.watchdog),
+  index(other.index),
+  deadline(other.deadline)
+{
+  other.watchdog = nullptr;
+}
+
+tWatchdog::tHandle& tWatchdog::tHandle::operator=(tHandle && other)
+{
+  if (this != &other)
+  {
+    Unregister();
+    watchdog = other.watchdog;
+    index = other.index;
+    deadline = other.deadline;
+    other.watchdog = nullptr;
+  }
+  return *this;
+}
+
+void tWatchdog::tHandle::Unregister()
+{
+  if (watchdog)
+  {
+    watchdog->Unregister(index);
+    watchdog = nullptr;
+  }
+}
+
+tWatchdog::tWatchdog(const tDuration& check_interval) :
+  check_interval(check_interval),
+  check_requested(false),
+  stop(false),
+  calling_callbacks(false),
+  last_check(cNO_TIME.time_since_epoch().count()),
+  listener(*this)
+{
+  assert(check_interval > tDuration::zero());
+  thread = std::thread(&tWatchdog::Run, this);
+}
+
+tWatchdog::~tWatchdog()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    assert(free_indices.size() == callbacks.size() && "All handles must be unregistered before watchdog is deleted");
+    stop = true;
+  }
+  wake_up.notify_all();
+  thread.join();
+}
+
+tWatchdog::tHandle tWatchdog::Register(const tCallback& callback, const tTimestamp& deadline)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  size_t index;
+  if (free_indices.empty())
+  {
+    index = callbacks.size();
+    if (index == chunks.size() * cCHUNK_SIZE)
+    {
+      chunks.emplace_back(new tChunk());
+    }
+    callbacks.push_back(callback);
+    generations.push_back(0);
+  }
+  else
+  {
+    index = free_indices.back();
+    free_indices.pop_back();
+    callbacks[index] = callback;
+  }
+  tChunk& chunk = *chunks[index / cCHUNK_SIZE];
+  chunk.reported[index % cCHUNK_SIZE] = cNO_TIME.time_since_epoch().count();
+  chunk.deadlines[index % cCHUNK_SIZE].Store(deadline, std::memory_order_relaxed);
+  return tHandle(this, index, &chunk.deadlines[index % cCHUNK_SIZE]);
+}
+
+size_t tWatchdog::GetEntryCount() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return callbacks.size() - free_indices.size();
+}
+
+void tWatchdog::Run()
+{
+  const int64_t no_time = cNO_TIME.time_since_epoch().count();
+  struct tExpiredEntry
+  {
+    tCallback callback;
+    size_t index;
+    uint64_t generation;
+    tTimestamp deadline;
+  };
+  std::vector<tExpiredEntry> expired;
+  std::unique_lock<std::mutex> lock(mutex);
+  while (!stop)
+  {
+    // Obtain time without holding mutex (listener notifications are called with time mutex locked)
+    lock.unlock();
+    tTimestamp now_timestamp = Now();
+    tDuration wait_duration = ToSystemDuration(check_interval);
+    int64_t now = now_timestamp.time_since_epoch().count();
+    lock.lock();
+    last_check.store(now, std::memory_order_relaxed);
+    check_requested = false;
+
+    // Scan deadlines (unused entries have deadline cNO_TIME)
+    size_t remaining = callbacks.size();
+    for (size_t c = 0; remaining > 0; c++)
+    {
+      tChunk& chunk = *chunks[c];
+      size_t count = std::min<size_t>(remaining, cCHUNK_SIZE);
+      for (size_t i = 0; i < count; i++)
+      {
+        int64_t deadline = chunk.deadlines[i].Load(std::memory_order_relaxed).time_since_epoch().count();
+        if (deadline < now && deadline != no_time && deadline != chunk.reported[i])
+        {
+          chunk.reported[i] = deadline;
+          size_t index = c * cCHUNK_SIZE + i;
+          expired.push_back(tExpiredEntry { callbacks[index], index, generations[index], tTimestamp(tDuration(deadline)) });
+        }
+      }
+      remaining -= count;
+    }
+
+    // Call callbacks without holding mutex (they may register and unregister entries - entries unregistered by previous callbacks are skipped)
+    if (!expired.empty())
+    {
+      calling_callbacks = true;
+      for (tExpiredEntry & entry : expired)
+      {
+        bool registered = generations[entry.index] == entry.generation;
+        lock.unlock();
+        if (registered)
+        {
+          entry.callback(entry.deadline);
+        }
+        lock.lock();
+      }
+      expired.clear();
+      calling_callbacks = false;
+      callbacks_returned.notify_all();
+    }
+
+    if (!check_requested && !stop)
+    {
+      wake_up.wait_for(lock, wait_duration);
+    }
+  }
+}
+
+void tWatchdog::RequestCheck()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    check_requested = true;
+  }
+  wake_up.notify_all();
+}
+
+void tWatchdog::Unregister(size_t index)
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  if (std::this_thread::get_id() != thread.get_id())
+  {
+    callbacks_returned.wait(lock, [this]() { return !calling_callbacks; });
+  }
+  chunks[index / cCHUNK_SIZE]->deadlines[index % cCHUNK_SIZE].Store(cNO_TIME, std::memory_order_relaxed);
+  callbacks[index] = tCallback();
+  generations[index]++;
+  free_indices.push_back(index);
+}
+
+void tWatchdog::tListener::TimeChanged(const tTimestamp& current_time)
+{
+  // Custom clocks may call this very frequently: only wake up monitor thread if time advanced by check interval or jumped back
+  int64_t last_check = watchdog.last_check.load(std::memory_order_relaxed);
+  int64_t time = current_time.time_since_epoch().count();
+  if (time < last_check || time - last_check >= watchdog.check_interval.count())
+  {
+    watchdog.RequestCheck();
+  }
+}
+
+void tWatchdog::tListener::TimeModeChanged(tTimeMode)
+{
+  watchdog.RequestCheck();
+}
+
+void tWatchdog::tListener::TimeStretchingFactorChanged(bool)
+{
+  watchdog.RequestCheck();
+}
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
@@ -0,0 +1,268 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    rrlib/time/tWatchdog.h
+ *
+ * \author  agent
+ *
+ * \date    2026-10-18
+ *
+ * \brief   Contains tWatchdog
+ *
+ * \b tWatchdog
+ *
+ * Monitors deadlines of many entries (e.g. components that need to send heartbeats) with a single thread.
+ * If an entry's deadline passes, its callback is called (once per deadline).
+ *
+ * Setting a deadline (or sending a heartbeat) is a single relaxed atomic store.
+ * Deadlines of all entries are stored in contiguous arrays - so the monitor thread can
+ * check 100000 entries in well below a millisecond.
+ *
+ * Deadlines are in application time. The monitor thread is woken up if time stretching
+ * or time mode changes - or if a custom clock jumps back or advances by more than the check interval.
+ *
+ * Example:
+ *   tWatchdog watchdog;
+ *   tWatchdog::tHandle handle = watchdog.Register([](const tTimestamp& deadline) { RRLIB_LOG_PRINT(ERROR, "Missed heartbeat"); });
+ *   while (...)
+ *   {
+ *     handle.Heartbeat(std::chrono::milliseconds(100));
+ *     ...
+ *   }
+ */
+//----------------------------------------------------------------------
+#ifndef __rrlib__time__tWatchdog_h__
+#define __rrlib__time__tWatchdog_h__
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/time/tAtomicTimestamp.h"
+#include "rrlib/time/tTimeStretchingListener.h"
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace time
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Class declaration
+//----------------------------------------------------------------------
+//! Deadline monitor
+/*!
+ * Callbacks are called by the monitor thread (at most one check interval after the deadline passed).
+ * They may register and unregister entries - but must not delete the watchdog.
+ * Unregistering an entry from another thread waits until running callbacks have returned -
+ * so objects used by the callback may be deleted afterwards.
+ */
+class tWatchdog
+{
+
+//----------------------------------------------------------------------
+// Public methods and typedefs
+//----------------------------------------------------------------------
+public:
+
+  /*! Callback that is called with the missed deadline */
+  typedef std::function<void(const tTimestamp& deadline)> tCallback;
+
+  /*!
+   * Handle for watchdog entry (unregisters entry on destruction)
+   */
+  class tHandle
+  {
+  public:
+
+    tHandle() : watchdog(nullptr), index(0), deadline(nullptr) {}
+    tHandle(tHandle && other);
+    tHandle& operator=(tHandle && other);
+    ~tHandle()
+    {
+      Unregister();
+    }
+
+    /*!
+     * Sets deadline of entry
+     *
+     * \param deadline New deadline (cNO_TIME disables monitoring)
+     */
+    void SetDeadline(const tTimestamp& deadline)
+    {
+      this->deadline->Store(deadline, std::memory_order_relaxed);
+    }
+
+    /*!
+     * Sets deadline to current application time plus timeout
+     *
+     * \param timeout Maximum time until next heartbeat
+     */
+    void Heartbeat(const tDuration& timeout)
+    {
+      SetDeadline(Now() + timeout);
+    }
+
+    /*!
+     * \return Current deadline of entry
+     */
+    tTimestamp GetDeadline() const
+    {
+      return deadline->Load(std::memory_order_relaxed);
+    }
+
+    /*!
+     * \return Whether handle refers to a registered entry
+     */
+    bool IsRegistered() const
+    {
+      return watchdog != nullptr;
+    }
+
+    /*!
+     * Unregisters entry (callback will not be called afterwards - see class description)
+     */
+    void Unregister();
+
+  private:
+
+    friend class tWatchdog;
+
+    tWatchdog* watchdog;
+    size_t index;
+    tAtomicTimestamp* deadline;
+
+    tHandle(tWatchdog* watchdog, size_t index, tAtomicTimestamp* deadline) : watchdog(watchdog), index(index), deadline(deadline) {}
+  };
+
+  /*!
+   * Creates watchdog and starts monitor thread
+   *
+   * \param check_interval Interval (application time) in which deadlines are checked
+   */
+  explicit tWatchdog(const tDuration& check_interval = std::chrono::milliseconds(10));
+
+  /*! Stops monitor thread (all handles must have been unregistered or destroyed before) */
+  ~tWatchdog();
+
+  /*!
+   * Registers entry
+   *
+   * \param callback Callback to call when deadline is missed
+   * \param deadline Initial deadline (cNO_TIME disables monitoring)
+   * \return Handle for setting deadlines
+   */
+  tHandle Register(const tCallback& callback, const tTimestamp& deadline = cNO_TIME);
+
+  /*!
+   * \return Number of registered entries
+   */
+  size_t GetEntryCount() const;
+
+//----------------------------------------------------------------------
+// Private fields and methods
+//----------------------------------------------------------------------
+private:
+
+  /*! Number of entries per chunk */
+  enum { cCHUNK_SIZE = 4096 };
+
+  /*! Chunk of entries (chunks are never moved - so handles can point to deadlines) */
+  struct tChunk
+  {
+    /*! Deadlines set by handles */
+    tAtomicTimestamp deadlines[cCHUNK_SIZE];
+
+    /*! Deadline that callback was called for last (nanoseconds since epoch) */
+    int64_t reported[cCHUNK_SIZE];
+  };
+
+  /*! Interval in which deadlines are checked (application time) */
+  const tDuration check_interval;
+
+  /*! Mutex for all non-atomic members below */
+  mutable std::mutex mutex;
+
+  /*! Entries: chunks, callbacks, generations (incremented whenever entry is unregistered) and unused indices (entry i is in chunk i / cCHUNK_SIZE) */
+  std::vector<std::unique_ptr<tChunk>> chunks;
+  std::vector<tCallback> callbacks;
+  std::vector<uint64_t> generations;
+  std::vector<size_t> free_indices;
+
+  /*! Signals monitor thread to check deadlines or stop - and signals unregistering threads that callbacks have returned */
+  std::condition_variable wake_up, callbacks_returned;
+  bool check_requested, stop, calling_callbacks;
+
+  /*! Application time of last check (nanoseconds since epoch) */
+  std::atomic<int64_t> last_check;
+
+  /*! Monitor thread */
+  std::thread thread;
+
+  /*! Main loop of monitor thread */
+  void Run();
+
+  /*! Wakes up monitor thread */
+  void RequestCheck();
+
+  /*! Unregisters entry */
+  void Unregister(size_t index);
+
+  /*! Wakes up monitor thread on changes of application time (member - so it is unregistered before other members are destroyed) */
+  class tListener : public tTimeStretchingListener
+  {
+  public:
+    explicit tListener(tWatchdog& watchdog) : watchdog(watchdog) {}
+
+  private:
+    tWatchdog& watchdog;
+
+    virtual void TimeChanged(const tTimestamp& current_time) override;
+    virtual void TimeModeChanged(tTimeMode) override;
+    virtual void TimeStretchingFactorChanged(bool) override;
+  };
+  tListener listener;
+};
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
+
+
+#endif
@@ -0,0 +1,975 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    rrlib/time/tests/benchmark_time.cpp
+ *
+ * \author  agent
+ *
+ * \date    2026-10-18
+ *
+ * Throughput benchmarks for parsing, formatting and encoding functions.
+ * Compares them to straightforward implementations based on libc functions.
+ *
+ * Usage: benchmark_time [NMEA log file]
+ */
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <queue>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <time.h>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/time/time.h"
+#include "rrlib/time/batch_conversion.h"
+#include "rrlib/time/tNmeaParser.h"
+#include "rrlib/time/rounding.h"
+#include "rrlib/time/tTimeZone.h"
+#include "rrlib/time/formatting.h"
+#include "rrlib/time/tTimestampCodec.h"
+#include "rrlib/time/tTimestampIndex.h"
+#include "rrlib/time/tStreamMerger.h"
+#include "rrlib/time/tApproximateTimeMatcher.h"
+#include "rrlib/time/tLatencyHistogram.h"
+#include "rrlib/time/tScopedTrace.h"
+#include "rrlib/time/tCycleCounter.h"
+#include "rrlib/time/tRateMeter.h"
+#include "rrlib/time/tTokenBucket.h"
+#include "rrlib/time/tWatchdog.h"
+#include "rrlib/time/tTimeRecorder.h"
+#include "rrlib/time/tVirtualClock.h"
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+#include <cassert>
+
+//----------------------------------------------------------------------
+// Namespace usage
+//----------------------------------------------------------------------
+using namespace rrlib::time;
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Const values
+//----------------------------------------------------------------------
+
+/*! Number of test strings */
+const size_t cSAMPLE_COUNT = 1000000;
+
+//----------------------------------------------------------------------
+// Implementation
+//----------------------------------------------------------------------
+
+/*!
+ * Runs benchmark function and prints throughput
+ *
+ * \param name Name of benchmark
+ * \param operations Number of operations performed by function
+ * \param bytes Number of bytes processed by function
+ * \param function Function to benchmark (returns some value to prevent optimizing the benchmark away)
+ */
+template <typename TFunction>
+static void RunBenchmark(const char* name, size_t operations, size_t bytes, TFunction function)
+{
+  tTimestamp start = tBaseClock::now();
+  volatile int64_t result = function();
+  (void)result;
+  double seconds = std::chrono::duration_cast<std::chrono::duration<double>>(tBaseClock::now() - start).count();
+  printf("%-48s %8.1f ns/op %10.1f MB/s\n", name, seconds * 1e9 / operations, bytes / seconds / 1e6);
+}
+
+/*! Reference: strptime/timegm based parsing (as implemented in earlier rrlib_time versions) */
+static tTimestamp ParseIsoTimestampLibc(const std::string& s)
+{
+  tm t;
+  memset(&t, 0, sizeof(t));
+  time_t tz = 0;
+  char charbuf[s.length() + 1];
+  strncpy(charbuf, s.c_str(), s.length() + 1);
+  char* c = strptime(charbuf, "%FT%T", &t);
+  std::chrono::nanoseconds rest(0);
+  if (c && *c == '.')
+  {
+    char nanos[32];
+    memset(nanos, '0', 9);
+    for (unsigned int i = 0; i < sizeof(nanos); i++)
+    {
+      c++;
+      if (!isdigit(*c))
+      {
+        break;
+      }
+      nanos[i] = *c;
+    }
+    nanos[9] = 0;
+    rest = std::chrono::nanoseconds(atoi(nanos));
+  }
+  char* colon = c ? strchr(c, ':') : NULL;
+  if (c && ((*c == '+') || (*c == '-')) && colon)
+  {
+    int sign = (*c == '-') ? -1 : 1;
+    *colon = 0;
+    tz = atoi(c) * -3600;
+    colon++;
+    if (*colon == '3')
+    {
+      tz += sign * -1800;
+    }
+  }
+  time_t parsed = timegm(&t) + tz;
+  return std::chrono::system_clock::from_time_t(parsed) + std::chrono::duration_cast<tDuration>(rest);
+}
+
+static void BenchmarkIsoTimestampParsing()
+{
+  std::vector<std::string> strings;
+  size_t bytes = 0;
+  tTimestamp timestamp = ParseIsoTimestamp("2014-04-04T14:14:14.141414141+02:00");
+  for (size_t i = 0; i < cSAMPLE_COUNT; i++)
+  {
+    timestamp += std::chrono::microseconds(12345);
+    strings.push_back(ToIsoString(timestamp));
+    bytes += strings.back().length();
+  }
+
+  RunBenchmark("ParseIsoTimestamp (strptime/timegm)", strings.size(), bytes, [&]()
+  {
+    int64_t sum = 0;
+    for (const std::string & s : strings)
+    {
+      sum += ParseIsoTimestampLibc(s).time_since_epoch().count();
+    }
+    return sum;
+  });
+  RunBenchmark("ParseIsoTimestamp", strings.size(), bytes, [&]()
+  {
+    int64_t sum = 0;
+    for (const std::string & s : strings)
+    {
+      sum += ParseIsoTimestamp(s).time_since_epoch().count();
+    }
+    return sum;
+  });
+
+  std::vector<tTimestamp> result(strings.size());
+  RunBenchmark("ParseIsoTimestamps (std::string array)", strings.size(), bytes, [&]()
+  {
+    return static_cast<int64_t>(ParseIsoTimestamps(strings.data(), strings.size(), result.data()));
+  });
+
+  const size_t cSTRIDE = 36;
+  std::string buffer;
+  for (const std::string & s : strings)
+  {
+    buffer += s;
+    buffer.resize(buffer.length() + cSTRIDE - s.length(), '\n');
+  }
+  RunBenchmark("ParseIsoTimestamps (fixed stride buffer)", strings.size(), bytes, [&]()
+  {
+    return static_cast<int64_t>(ParseIsoTimestamps(buffer.c_str(), cSTRIDE, strings.size(), result.data()));
+  });
+  RunBenchmark("TryParseIsoTimestamp (fixed stride buffer)", strings.size(), bytes, [&]()
+  {
+    int64_t sum = 0;
+    for (size_t i = 0; i < strings.size(); i++)
+    {
+      sum += TryParseIsoTimestamp(&buffer[i * cSTRIDE], cSTRIDE - 1, result[i]) ? 1 : 0;
+    }
+    return sum;
+  });
+}
+
+static void BenchmarkIsoTimestampFormatting()
+{
+  std::vector<tTimestamp> timestamps;
+  tTimestamp timestamp = ParseIsoTimestamp("2014-04-04T14:14:14.141414141+02:00");
+  for (size_t i = 0; i < cSAMPLE_COUNT; i++)
+  {
+    timestamp += std::chrono::microseconds(12345);
+    timestamps.push_back(timestamp);
+  }
+  std::string output;
+  FormatIsoTimestamps(timestamps.data(), timestamps.size(), output);
+  size_t bytes = output.length();
+
+  RunBenchmark("ToIsoString (strftime/localtime_r)", timestamps.size(), bytes, [&]()
+  {
+    int64_t sum = 0;
+    for (const tTimestamp & t : timestamps)
+    {
+      char buf[64];
+      time_t tt = std::chrono::system_clock::to_time_t(t);
+      tm tmp;
+      sum += strftime(buf, sizeof(buf), "%FT%T", localtime_r(&tt, &tmp));
+      sum += strftime(buf, sizeof(buf), "%z", localtime_r(&tt, &tmp));
+      sum += sprintf(buf, ".%09d", static_cast<int>((t - std::chrono::system_clock::from_time_t(tt)).count()));
+    }
+    return sum;
+  });
+  RunBenchmark("ToIsoString", timestamps.size(), bytes, [&]()
+  {
+    int64_t sum = 0;
+    for (const tTimestamp & t : timestamps)
+    {
+      sum += ToIsoString(t).length();
+    }
+    return sum;
+  });
+  RunBenchmark("FormatIsoTimestamps", timestamps.size(), bytes, [&]()
+  {
+    output.clear();
+    FormatIsoTimestamps(timestamps.data(), timestamps.size(), output);
+    return static_cast<int64_t>(output.length());
+  });
+
+  const tTimeZone& zone = tTimeZone::Get("UTC");
+  RunBenchmark("ToIsoString (tTimeZone)", timestamps.size(), bytes, [&]()
+  {
+    int64_t sum = 0;
+    for (const tTimestamp & t : timestamps)
+    {
+      sum += ToIsoString(t, zone).length();
+    }
+    return sum;
+  });
+}
+
+/*! Appends NMEA sentence with checksum to 'log' */
+static void AppendNmeaSentence(std::string& log, const char* data)
+{
+  unsigned char checksum = 0;
+  for (const char* c = data; *c; c++)
+  {
+    checksum ^= static_cast<unsigned char>(*c);
+  }
+  char checksum_string[8];
+  snprintf(checksum_string, sizeof(checksum_string), "*%02X\r\n", checksum);
+  log += '$';
+  log += data;
+  log += checksum_string;
+}
+
+static void BenchmarkNmeaParsing(const char* log_file)
+{
+  std::string log;
+  if (log_file)
+  {
+    FILE* file = fopen(log_file, "rb");
+    if (!file)
+    {
+      printf("Could not open %s\n", log_file);
+      return;
+    }
+    char buffer[65536];
+    size_t read = 0;
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    {
+      log.append(buffer, read);
+    }
+    fclose(file);
+  }
+  else
+  {
+    // Synthetic log of a 1 Hz receiver (RMC, GGA, GSA and ZDA every second)
+    for (size_t i = 0; i < cSAMPLE_COUNT / 4; i++)
+    {
+      char sentence[128];
+      unsigned int hour = (i / 3600) % 24, minute = (i / 60) % 60, second = i % 60, day = 1 + (i / 86400) % 28;
+      snprintf(sentence, sizeof(sentence), "GPRMC,%02u%02u%02u.00,A,4807.038,N,01131.000,E,022.4,084.4,%02u0324,003.1,W", hour, minute, second, day);
+      AppendNmeaSentence(log, sentence);
+      snprintf(sentence, sizeof(sentence), "GPGGA,%02u%02u%02u.00,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,", hour, minute, second);
+      AppendNmeaSentence(log, sentence);
+      AppendNmeaSentence(log, "GPGSA,A,3,04,05,,09,12,,,24,,,,,2.5,1.3,2.1");
+      snprintf(sentence, sizeof(sentence), "GPZDA,%02u%02u%02u.00,%02u,03,2024,00,00", hour, minute, second, day);
+      AppendNmeaSentence(log, sentence);
+    }
+  }
+
+  tNmeaParser parser;
+  const size_t cCHUNK_SIZE = 4096;  // typical size of serial port reads
+  RunBenchmark("tNmeaParser (sentences)", std::max<size_t>(1, std::count(log.begin(), log.end(), '$')), log.length(), [&]()
+  {
+    int64_t sum = 0;
+    for (size_t i = 0; i < log.length(); i += cCHUNK_SIZE)
+    {
+      parser.Parse(&log[i], std::min(cCHUNK_SIZE, log.length() - i), [&sum](const tNmeaTimestamp & t)
+      {
+        sum += t.timestamp.time_since_epoch().count();
+      });
+    }
+    return sum;
+  });
+  printf("  %zu sentences, %zu errors\n", parser.GetSentenceCount(), parser.GetErrorCount());
+}
+
+/*! Reference: gmtime_r/timegm based GetLastFullHour() (as implemented in earlier rrlib_time versions) */
+static tTimestamp GetLastFullHourLibc(const tTimestamp& timestamp)
+{
+  std::time_t input_time = std::chrono::system_clock::to_time_t(timestamp);
+  tm full_hour_time;
+  gmtime_r(&input_time, &full_hour_time);
+  full_hour_time.tm_sec = 0;
+  full_hour_time.tm_min = 0;
+  return std::chrono::system_clock::from_time_t(timegm(&full_hour_time));
+}
+
+static void BenchmarkRounding()
+{
+  std::vector<tTimestamp> timestamps, result(cSAMPLE_COUNT);
+  tTimestamp timestamp = ParseIsoTimestamp("2014-04-04T14:14:14.141414141Z");
+  for (size_t i = 0; i < cSAMPLE_COUNT; i++)
+  {
+    timestamp += std::chrono::microseconds(12345);
+    timestamps.push_back(timestamp);
+  }
+  const size_t bytes = cSAMPLE_COUNT * sizeof(tTimestamp);
+
+  RunBenchmark("GetLastFullHour (gmtime_r/timegm)", cSAMPLE_COUNT, bytes, [&]()
+  {
+    int64_t sum = 0;
+    for (const tTimestamp & t : timestamps)
+    {
+      sum += GetLastFullHourLibc(t).time_since_epoch().count();
+    }
+    return sum;
+  });
+  RunBenchmark("Floor (hour)", cSAMPLE_COUNT, bytes, [&]()
+  {
+    int64_t sum = 0;
+    for (const tTimestamp & t : timestamps)
+    {
+      sum += Floor(t, tCalendarUnit::HOUR).time_since_epoch().count();
+    }
+    return sum;
+  });
+  RunBenchmark("Floor (15 minutes)", cSAMPLE_COUNT, bytes, [&]()
+  {
+    int64_t sum = 0;
+    for (const tTimestamp & t : timestamps)
+    {
+      sum += Floor(t, std::chrono::minutes(15)).time_since_epoch().count();
+    }
+    return sum;
+  });
+  RunBenchmark("Floor batch (15 minutes)", cSAMPLE_COUNT, bytes, [&]()
+  {
+    Floor(timestamps.data(), timestamps.size(), std::chrono::minutes(15), result.data());
+    return result.back().time_since_epoch().count();
+  });
+  RunBenchmark("Floor batch (local day)", cSAMPLE_COUNT, bytes, [&]()
+  {
+    Floor(timestamps.data(), timestamps.size(), tCalendarUnit::DAY, result.data(), tCalendarZone::LOCAL);
+    return result.back().time_since_epoch().count();
+  });
+  RunBenchmark("Floor batch (month)", cSAMPLE_COUNT, bytes, [&]()
+  {
+    Floor(timestamps.data(), timestamps.size(), tCalendarUnit::MONTH, result.data());
+    return result.back().time_since_epoch().count();
+  });
+}
+
+static void BenchmarkDurationFormatting()
+{
+  std::vector<std::chrono::nanoseconds> durations;
+  for (size_t i = 0; i < cSAMPLE_COUNT; i++)
+  {
+    durations.push_back(std::chrono::nanoseconds((i * 7919) % 100000000));
+  }
+  const size_t bytes = cSAMPLE_COUNT * sizeof(std::chrono::nanoseconds);
+
+  RunBenchmark("ToString (std::string)", cSAMPLE_COUNT, bytes, [&]()
+  {
+    int64_t sum = 0;
+    for (auto duration : durations)
+    {
+      sum += ToString(duration).length();
+    }
+    return sum;
+  });
+  RunBenchmark("ToString (buffer)", cSAMPLE_COUNT, bytes, [&]()
+  {
+    int64_t sum = 0;
+    char buffer[cMAX_DURATION_STRING_LENGTH + 1];
+    for (auto duration : durations)
+    {
+      sum += ToString(duration, buffer);
+    }
+    return sum;
+  });
+  std::ostringstream stream;
+  RunBenchmark("operator << (Formatted(duration))", cSAMPLE_COUNT, bytes, [&]()
+  {
+    for (auto duration : durations)
+    {
+      stream << Formatted(duration) << '\n';
+    }
+    return static_cast<int64_t>(stream.tellp());
+  });
+}
+
+static void BenchmarkTimestampCodec()
+{
+  // Typical recorded streams: sensor with scheduling jitter, hardware-timestamped sensor, network messages
+  std::vector<std::pair<const char*, std::vector<tTimestamp>>> streams =
+  {
+    { "100 Hz sensor (jitter)", std::vector<tTimestamp>() },
+    { "1 kHz sensor (exact)", std::vector<tTimestamp>() },
+    { "Messages (irregular)", std::vector<tTimestamp>() }
+  };
+  tTimestamp start = ParseIsoTimestamp("2014-04-04T14:14:14.141414141Z");
+  uint64_t random = 12345;
+  for (size_t i = 0; i < cSAMPLE_COUNT; i++)
+  {
+    random = random * 6364136223846793005ULL + 1442695040888963407ULL;
+    streams[0].second.push_back(start + std::chrono::milliseconds(10 * i) + std::chrono::microseconds((random >> 33) % 100));
+    streams[1].second.push_back(start + std::chrono::microseconds(1000 * i));
+    streams[2].second.push_back((i ? streams[2].second.back() : start) + std::chrono::microseconds((random >> 33) % 50000));
+  }
+
+  for (auto & stream : streams)
+  {
+    const std::vector<tTimestamp>& timestamps = stream.second;
+    const size_t bytes = timestamps.size() * sizeof(tTimestamp);
+    std::vector<uint8_t> data;
+    std::vector<tTimestamp> decoded(timestamps.size());
+    std::string name = std::string("tTimestampEncoder: ") + stream.first;
+    RunBenchmark(name.c_str(), timestamps.size(), bytes, [&]()
+    {
+      data.clear();
+      tTimestampEncoder encoder;
+      encoder.Encode(timestamps.data(), timestamps.size(), data);
+      encoder.Flush(data);
+      return static_cast<int64_t>(data.size());
+    });
+    name = std::string("tTimestampDecoder: ") + stream.first;
+    RunBenchmark(name.c_str(), timestamps.size(), bytes, [&]()
+    {
+      tTimestampDecoder decoder(data.data(), data.size());
+      return static_cast<int64_t>(decoder.Decode(decoded.data(), decoded.size()));
+    });
+    printf("  %.2f bytes per timestamp, compression ratio %.1f\n", static_cast<double>(data.size()) / timestamps.size(), static_cast<double>(bytes) / data.size());
+  }
+}
+
+static void BenchmarkTimestampIndex()
+{
+  // Samples of a sensor with jitter (1 kHz) - and with gaps (recording paused every 1000 samples: interpolation is not accurate) - probes at random times
+  for (int test = 0; test < 3; test++)
+  {
+    const size_t size = test == 1 ? 8 * cSAMPLE_COUNT : cSAMPLE_COUNT;
+    const bool gaps = test == 2;
+    std::vector<tTimestamp> timestamps, probes;
+    tTimestamp timestamp = ParseIsoTimestamp("2014-04-04T14:14:14.141414141Z");
+    uint64_t random = 12345;
+    for (size_t i = 0; i < size; i++)
+    {
+      random = random * 6364136223846793005ULL + 1442695040888963407ULL;
+      timestamp += std::chrono::microseconds(950 + (random >> 33) % 100) + std::chrono::seconds(gaps && i % 1000 == 999 ? (random >> 40) % 60 : 0);
+      timestamps.push_back(timestamp);
+    }
+    const uint64_t duration = (timestamps.back() - timestamps.front()).count();
+    for (size_t i = 0; i < cSAMPLE_COUNT; i++)
+    {
+      random = random * 6364136223846793005ULL + 1442695040888963407ULL;
+      probes.push_back(timestamps.front() + tDuration((random >> 8) % duration));
+    }
+    tTimestampIndex index(timestamps.data(), timestamps.size());
+    std::vector<size_t> result(probes.size());
+    const size_t bytes = probes.size() * sizeof(tTimestamp);
+    printf("%zu timestamps%s:\n", size, gaps ? " with gaps" : "");
+
+    RunBenchmark("std::lower_bound (random probes)", probes.size(), bytes, [&]()
+    {
+      int64_t sum = 0;
+      for (const tTimestamp & probe : probes)
+      {
+        sum += std::lower_bound(timestamps.begin(), timestamps.end(), probe) - timestamps.begin();
+      }
+      return sum;
+    });
+    RunBenchmark("tTimestampIndex::Ceil (random probes)", probes.size(), bytes, [&]()
+    {
+      int64_t sum = 0;
+      for (const tTimestamp & probe : probes)
+      {
+        sum += index.Ceil(probe);
+      }
+      return sum;
+    });
+    RunBenchmark("tTimestampIndex::Nearest (random probes)", probes.size(), bytes, [&]()
+    {
+      int64_t sum = 0;
+      for (const tTimestamp & probe : probes)
+      {
+        sum += index.Nearest(probe);
+      }
+      return sum;
+    });
+
+    RunBenchmark("tTimestampIndex::Nearest batch (random probes)", probes.size(), bytes, [&]()
+    {
+      index.Nearest(probes.data(), probes.size(), result.data());
+      return static_cast<int64_t>(result.back());
+    });
+
+    std::sort(probes.begin(), probes.end());
+    RunBenchmark("std::lower_bound (sorted probes)", probes.size(), bytes, [&]()
+    {
+      int64_t sum = 0;
+      for (const tTimestamp & probe : probes)
+      {
+        sum += std::lower_bound(timestamps.begin(), timestamps.end(), probe) - timestamps.begin();
+      }
+      return sum;
+    });
+    RunBenchmark("tTimestampIndex::Nearest batch (sorted probes)", probes.size(), bytes, [&]()
+    {
+      index.Nearest(probes.data(), probes.size(), result.data());
+      return static_cast<int64_t>(result.back());
+    });
+
+    // Dense probes (one per sample - e.g. matching two sensors)
+    for (size_t i = 0; i < probes.size(); i++)
+    {
+      probes[i] = timestamps[i] + std::chrono::microseconds(300);
+    }
+    RunBenchmark("tTimestampIndex::Nearest (dense sorted probes)", probes.size(), bytes, [&]()
+    {
+      int64_t sum = 0;
+      for (const tTimestamp & probe : probes)
+      {
+        sum += index.Nearest(probe);
+      }
+      return sum;
+    });
+    RunBenchmark("tTimestampIndex::Nearest batch (dense sorted probes)", probes.size(), bytes, [&]()
+    {
+      index.Nearest(probes.data(), probes.size(), result.data());
+      return static_cast<int64_t>(result.back());
+    });
+  }
+}
+
+static void BenchmarkStreamMerging()
+{
+  struct tSample
+  {
+    tTimestamp timestamp;
+    int64_t value;
+  };
+  const size_t cSTREAMS = 32;
+  std::vector<std::vector<tSample>> recordings(cSTREAMS);
+  tTimestamp start = ParseIsoTimestamp("2014-04-04T14:14:14.141414141Z");
+  uint64_t random = 12345;
+  for (size_t stream = 0; stream < cSTREAMS; stream++)
+  {
+    // Different rates (around 1 kHz) with jitter
+    tTimestamp timestamp = start;
+    for (size_t i = 0; i < cSAMPLE_COUNT / cSTREAMS; i++)
+    {
+      random = random * 6364136223846793005ULL + 1442695040888963407ULL;
+      timestamp += std::chrono::microseconds(900 + 10 * stream + (random >> 33) % 100);
+      recordings[stream].push_back(tSample { timestamp, static_cast<int64_t>(i) });
+    }
+  }
+  const size_t bytes = cSAMPLE_COUNT * sizeof(tSample);
+
+  RunBenchmark("std::priority_queue merge (32 streams)", cSAMPLE_COUNT, bytes, [&]()
+  {
+    typedef std::pair<int64_t, size_t> tEntry;  // timestamp, stream
+    std::priority_queue<tEntry, std::vector<tEntry>, std::greater<tEntry>> queue;
+    std::vector<size_t> positions(cSTREAMS, 0);
+    for (size_t stream = 0; stream < cSTREAMS; stream++)
+    {
+      queue.emplace(recordings[stream][0].timestamp.time_since_epoch().count(), stream);
+    }
+    int64_t sum = 0;
+    while (!queue.empty())
+    {
+      size_t stream = queue.top().second;
+      queue.pop();
+      sum += recordings[stream][positions[stream]].value;
+      if (++positions[stream] < recordings[stream].size())
+      {
+        queue.emplace(recordings[stream][positions[stream]].timestamp.time_since_epoch().count(), stream);
+      }
+    }
+    return sum;
+  });
+  RunBenchmark("tStreamMerger (32 streams)", cSAMPLE_COUNT, bytes, [&]()
+  {
+    std::vector<tStreamMerger<tSample>::tRangeSource> sources;
+    for (auto & recording : recordings)
+    {
+      sources.emplace_back(recording.begin(), recording.end());
+    }
+    tStreamMerger<tSample> merger(std::move(sources));
+    int64_t sum = 0;
+    tSample sample;
+    size_t stream;
+    while (merger.Next(sample, stream))
+    {
+      sum += sample.value;
+    }
+    return sum;
+  });
+  RunBenchmark("tStreamMerger + tApproximateTimeMatcher", cSAMPLE_COUNT, bytes, [&]()
+  {
+    std::vector<tStreamMerger<tSample>::tRangeSource> sources;
+    for (auto & recording : recordings)
+    {
+      sources.emplace_back(recording.begin(), recording.end());
+    }
+    tStreamMerger<tSample> merger(std::move(sources));
+    tApproximateTimeMatcher<tSample> matcher(cSTREAMS, 0, std::chrono::microseconds(500));
+    int64_t sets = 0;
+    tSample sample;
+    size_t stream;
+    auto callback = [&sets](const std::vector<const tSample*>&)
+    {
+      sets++;
+    };
+    while (merger.Next(sample, stream))
+    {
+      matcher.Push(stream, sample, callback);
+    }
+    matcher.Flush(callback);
+    return sets;
+  });
+}
+
+static void BenchmarkLatencyHistogram()
+{
+  std::vector<tDuration> durations;
+  uint64_t random = 12345;
+  for (size_t i = 0; i < cSAMPLE_COUNT; i++)
+  {
+    random = random * 6364136223846793005ULL + 1442695040888963407ULL;
+    durations.push_back(tDuration((random >> 33) % 10000000));
+  }
+  const size_t bytes = durations.size() * sizeof(tDuration);
+  tLatencyHistogram histogram;
+
+  RunBenchmark("tLatencyHistogram::Record", durations.size(), bytes, [&]()
+  {
+    for (const tDuration & duration : durations)
+    {
+      histogram.Record(duration);
+    }
+    return static_cast<int64_t>(durations.size());
+  });
+  RunBenchmark("tLatencyHistogram::tRecorder::Record", durations.size(), bytes, [&]()
+  {
+    tLatencyHistogram::tRecorder& recorder = histogram.GetThreadRecorder();
+    for (const tDuration & duration : durations)
+    {
+      recorder.Record(duration);
+    }
+    return static_cast<int64_t>(durations.size());
+  });
+  RunBenchmark("tLatencyHistogram::GetSnapshot + GetPercentile", 1, 0, [&]()
+  {
+    return histogram.GetSnapshot().GetPercentile(99.9).count();
+  });
+}
+
+static void BenchmarkScopedTrace()
+{
+  RunBenchmark("tScopedTrace (system time)", cSAMPLE_COUNT, 0, [&]()
+  {
+    for (size_t i = 0; i < cSAMPLE_COUNT; i++)
+    {
+      tScopedTrace trace("Benchmark");
+    }
+    return 0;
+  });
+  RunBenchmark("tScopedTrace (application time)", cSAMPLE_COUNT, 0, [&]()
+  {
+    for (size_t i = 0; i < cSAMPLE_COUNT; i++)
+    {
+      tScopedTrace trace("Benchmark", tTraceClock::APPLICATION_TIME);
+    }
+    return 0;
+  });
+  std::ostringstream stream;
+  RunBenchmark("WriteChromeTrace (65536 spans)", 65536, 0, [&]()
+  {
+    return static_cast<int64_t>(WriteChromeTrace(stream));
+  });
+}
+
+static void BenchmarkCycleCounter()
+{
+  RunBenchmark("tBaseClock::now", cSAMPLE_COUNT, 0, [&]()
+  {
+    int64_t sum = 0;
+    for (size_t i = 0; i < cSAMPLE_COUNT; i++)
+    {
+      sum += tBaseClock::now().time_since_epoch().count();
+    }
+    return sum;
+  });
+  tCycleCapture capture(cSAMPLE_COUNT);
+  capture.Start();
+  RunBenchmark("tCycleCapture::Capture", cSAMPLE_COUNT, 0, [&]()
+  {
+    for (size_t i = 0; i < cSAMPLE_COUNT; i++)
+    {
+      capture.Capture();
+    }
+    return static_cast<int64_t>(capture.GetSize());
+  });
+  capture.Stop();
+  const tCycleCalibration& calibration = capture.GetCalibration();
+  std::vector<tTimestamp> timestamps(cSAMPLE_COUNT);
+  const size_t bytes = cSAMPLE_COUNT * sizeof(uint64_t);
+  RunBenchmark("tCycleCalibration::ToTimestamp", cSAMPLE_COUNT, bytes, [&]()
+  {
+    for (size_t i = 0; i < cSAMPLE_COUNT; i++)
+    {
+      timestamps[i] = calibration.ToTimestamp(capture.GetCycles()[i]);
+    }
+    return timestamps.back().time_since_epoch().count();
+  });
+  RunBenchmark("tCycleCalibration::ToTimestamps", cSAMPLE_COUNT, bytes, [&]()
+  {
+    calibration.ToTimestamps(capture.GetCycles(), cSAMPLE_COUNT, timestamps.data());
+    return timestamps.back().time_since_epoch().count();
+  });
+}
+
+static void BenchmarkRateMeter()
+{
+  tRateMeter meter;
+  RunBenchmark("tRateMeter::Increment", cSAMPLE_COUNT, 0, [&]()
+  {
+    for (size_t i = 0; i < cSAMPLE_COUNT; i++)
+    {
+      meter.Increment();
+    }
+    return static_cast<int64_t>(meter.GetCount());
+  });
+  RunBenchmark("tRateMeter::GetRate (Now(false))", cSAMPLE_COUNT, 0, [&]()
+  {
+    double sum = 0;
+    for (size_t i = 0; i < cSAMPLE_COUNT; i++)
+    {
+      meter.Increment();
+      sum += meter.GetRate();
+    }
+    return static_cast<int64_t>(sum);
+  });
+}
+
+static void BenchmarkTokenBucket()
+{
+  tTokenBucket bucket(1e6, 1000);
+  RunBenchmark("tTokenBucket::TryAcquire (Now())", cSAMPLE_COUNT, 0, [&]()
+  {
+    int64_t acquired = 0;
+    for (size_t i = 0; i < cSAMPLE_COUNT; i++)
+    {
+      acquired += bucket.TryAcquire() ? 1 : 0;
+    }
+    return acquired;
+  });
+  RunBenchmark("tTokenBucket::TryAcquire (Now(false))", cSAMPLE_COUNT, 0, [&]()
+  {
+    int64_t acquired = 0;
+    for (size_t i = 0; i < cSAMPLE_COUNT; i++)
+    {
+      acquired += bucket.TryAcquire(1, Now(false)) ? 1 : 0;
+    }
+    return acquired;
+  });
+}
+
+static void BenchmarkWatchdog()
+{
+  const size_t cENTRIES = 100000;
+  tWatchdog watchdog(std::chrono::milliseconds(1));
+  std::atomic<size_t> missed(0);
+  std::vector<tWatchdog::tHandle> handles;
+  for (size_t i = 0; i < cENTRIES; i++)
+  {
+    handles.push_back(watchdog.Register([&](const tTimestamp&)
+    {
+      missed++;
+    }));
+  }
+  RunBenchmark("tWatchdog::tHandle::SetDeadline (100k entries)", cSAMPLE_COUNT, 0, [&]()
+  {
+    tTimestamp deadline = Now() + std::chrono::seconds(10);
+    for (size_t i = 0; i < cSAMPLE_COUNT; i++)
+    {
+      handles[i % cENTRIES].SetDeadline(deadline);
+    }
+    return static_cast<int64_t>(handles[0].GetDeadline().time_since_epoch().count());
+  });
+  RunBenchmark("tWatchdog::tHandle::Heartbeat (100k entries)", cSAMPLE_COUNT, 0, [&]()
+  {
+    for (size_t i = 0; i < cSAMPLE_COUNT; i++)
+    {
+      handles[i % cENTRIES].Heartbeat(std::chrono::seconds(10));
+    }
+    return static_cast<int64_t>(handles[0].GetDeadline().time_since_epoch().count());
+  });
+  RunBenchmark("tWatchdog detect 100k missed (incl. 1 ms interval)", cENTRIES, 0, [&]()
+  {
+    tTimestamp deadline = Now();
+    for (auto & handle : handles)
+    {
+      handle.SetDeadline(deadline);
+    }
+    while (missed.load() < cENTRIES)
+    {
+      std::this_thread::yield();
+    }
+    return static_cast<int64_t>(missed.load());
+  });
+}
+
+static void BenchmarkTimeRecorder()
+{
+  RunBenchmark("Now() (not recording)", cSAMPLE_COUNT, 0, [&]()
+  {
+    int64_t sum = 0;
+    for (size_t i = 0; i < cSAMPLE_COUNT; i++)
+    {
+      sum += Now().time_since_epoch().count();
+    }
+    return sum;
+  });
+  const std::string file_name = "/tmp/rrlib_time_benchmark_recording.bin";
+  tTimeRecorder recorder(file_name);
+  RunBenchmark("Now() (recording)", cSAMPLE_COUNT / 10, 0, [&]()
+  {
+    int64_t sum = 0;
+    for (size_t i = 0; i < cSAMPLE_COUNT / 10; i++)
+    {
+      sum += Now().time_since_epoch().count();
+    }
+    return sum;
+  });
+  recorder.Close();
+  printf("  recorded %llu events (%llu dropped)\n", static_cast<unsigned long long>(recorder.GetEventCount()), static_cast<unsigned long long>(recorder.GetDroppedEventCount()));
+  RunBenchmark("tTimeRecordingReader::Next", recorder.GetEventCount(), 0, [&]()
+  {
+    tTimeRecordingReader reader(file_name);
+    tTimeEvent event;
+    int64_t sum = 0;
+    while (reader.Next(event))
+    {
+      sum += event.application_time.time_since_epoch().count();
+    }
+    return sum;
+  });
+  remove(file_name.c_str());
+}
+
+static void BenchmarkVirtualClock()
+{
+  const size_t cCYCLES = 10000;
+  tVirtualClock clock;
+  RunBenchmark("tVirtualClock::SleepFor (no workers)", cSAMPLE_COUNT, 0, [&]()
+  {
+    for (size_t i = 0; i < cSAMPLE_COUNT; i++)
+    {
+      clock.SleepFor(std::chrono::milliseconds(10));
+    }
+    return static_cast<int64_t>(clock.GetTime().time_since_epoch().count());
+  });
+  RunBenchmark("tVirtualClock::SleepFor (2 workers)", 2 * cCYCLES, 0, [&]()
+  {
+    std::atomic<int> started(0);
+    auto worker_function = [&](tDuration period)
+    {
+      tVirtualClock::tWorker worker(clock);
+      started++;
+      for (size_t i = 0; i < cCYCLES; i++)
+      {
+        clock.SleepFor(period);
+      }
+    };
+    std::unique_ptr<tVirtualClock::tWorker> starter(new tVirtualClock::tWorker(clock));
+    std::thread thread1(worker_function, std::chrono::milliseconds(10));
+    std::thread thread2(worker_function, std::chrono::milliseconds(15));
+    while (started < 2)
+    {
+      std::this_thread::yield();
+    }
+    starter.reset();
+    thread1.join();
+    thread2.join();
+    return static_cast<int64_t>(clock.GetTime().time_since_epoch().count());
+  });
+}
+
+static void BenchmarkMonotonicTime()
+{
+  RunBenchmark("NowMonotonic()", cSAMPLE_COUNT, 0, [&]()
+  {
+    int64_t sum = 0;
+    for (size_t i = 0; i < cSAMPLE_COUNT; i++)
+    {
+      sum += NowMonotonic().time_since_epoch().count();
+    }
+    return sum;
+  });
+}
+
+int main(int argc, char **argv)
+{
+  BenchmarkIsoTimestampParsing();
+  BenchmarkIsoTimestampFormatting();
+  BenchmarkNmeaParsing(argc > 1 ? argv[1] : NULL);
+  BenchmarkRounding();
+  BenchmarkDurationFormatting();
+  BenchmarkTimestampCodec();
+  BenchmarkTimestampIndex();
+  BenchmarkStreamMerging();
+  BenchmarkLatencyHistogram();
+  BenchmarkScopedTrace();
+  BenchmarkCycleCounter();
+  BenchmarkRateMeter();
+  BenchmarkTokenBucket();
+  BenchmarkWatchdog();
+  BenchmarkTimeRecorder();
+  BenchmarkVirtualClock();
+  BenchmarkMonotonicTime();
+  return 0;
+}
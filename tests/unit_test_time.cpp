@@ -32,6 +32,20 @@
 //----------------------------------------------------------------------
 // External includes (system with <>, local with "")
 //----------------------------------------------------------------------
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <unistd.h>
+#include <vector>
 
 //----------------------------------------------------------------------
 // Internal includes with ""
@@ -39,6 +53,31 @@
 #include "rrlib/util/tUnitTestSuite.h"
 
 #include "rrlib/time/time.h"
+#include "rrlib/time/tIsoTimestampFormatter.h"
+#include "rrlib/time/batch_conversion.h"
+#include "rrlib/time/literals.h"
+#include "rrlib/time/calendar.h"
+#include "rrlib/time/tNmeaParser.h"
+#include "rrlib/time/time_scales.h"
+#include "rrlib/time/rounding.h"
+#include "rrlib/time/tTimeZone.h"
+#include "rrlib/time/formatting.h"
+#include "rrlib/time/tTimestampCodec.h"
+#include "rrlib/time/tTimelineFile.h"
+#include "rrlib/time/tTimestampIndex.h"
+#include "rrlib/time/tStreamMerger.h"
+#include "rrlib/time/tApproximateTimeMatcher.h"
+#include "rrlib/time/tReorderBuffer.h"
+#include "rrlib/time/tLatencyHistogram.h"
+#include "rrlib/time/tScopedTrace.h"
+#include "rrlib/time/tCycleCounter.h"
+#include "rrlib/time/tRateMeter.h"
+#include "rrlib/time/tTokenBucket.h"
+#include "rrlib/time/tWatchdog.h"
+#include "rrlib/time/tCustomClock.h"
+#include "rrlib/time/tTimeRecorder.h"
+#include "rrlib/time/tReplayClock.h"
+#include "rrlib/time/tVirtualClock.h"
 
 //----------------------------------------------------------------------
 // Debugging
@@ -72,10 +111,61 @@ class TestTime : public util::tUnitTestSuite
 {
   RRLIB_UNIT_TESTS_BEGIN_SUITE(TestTime);
   RRLIB_UNIT_TESTS_ADD_TEST(Test);
+  RRLIB_UNIT_TESTS_ADD_TEST(TestTimeStretching);
+  RRLIB_UNIT_TESTS_ADD_TEST(TestFormatter);
+  RRLIB_UNIT_TESTS_ADD_TEST(TestIsoTimestampParsing);
+  RRLIB_UNIT_TESTS_ADD_TEST(TestBatchParsing);
+  RRLIB_UNIT_TESTS_ADD_TEST(TestBatchFormatting);
+  RRLIB_UNIT_TESTS_ADD_TEST(TestIsoDurationParsing);
+  RRLIB_UNIT_TESTS_ADD_TEST(TestCalendarAndTimestampLiterals);
+  RRLIB_UNIT_TESTS_ADD_TEST(TestNmeaParser);
+  RRLIB_UNIT_TESTS_ADD_TEST(TestTimeScales);
+  RRLIB_UNIT_TESTS_ADD_TEST(TestRounding);
+  RRLIB_UNIT_TESTS_ADD_TEST(TestTimeZone);
+  RRLIB_UNIT_TESTS_ADD_TEST(TestDurationFormatting);
+  RRLIB_UNIT_TESTS_ADD_TEST(TestTimestampCodec);
+  RRLIB_UNIT_TESTS_ADD_TEST(TestTimelineFile);
+  RRLIB_UNIT_TESTS_ADD_TEST(TestTimestampIndex);
+  RRLIB_UNIT_TESTS_ADD_TEST(TestStreamMerging);
+  RRLIB_UNIT_TESTS_ADD_TEST(TestReorderBuffer);
+  RRLIB_UNIT_TESTS_ADD_TEST(TestLatencyHistogram);
+  RRLIB_UNIT_TESTS_ADD_TEST(TestScopedTrace);
+  RRLIB_UNIT_TESTS_ADD_TEST(TestCycleCounter);
+  RRLIB_UNIT_TESTS_ADD_TEST(TestRateMeter);
+  RRLIB_UNIT_TESTS_ADD_TEST(TestTokenBucket);
+  RRLIB_UNIT_TESTS_ADD_TEST(TestWatchdog);
+  RRLIB_UNIT_TESTS_ADD_TEST(TestTimeRecording);
+  RRLIB_UNIT_TESTS_ADD_TEST(TestVirtualClock);
+  RRLIB_UNIT_TESTS_ADD_TEST(TestMonotonicTime);
   RRLIB_UNIT_TESTS_END_SUITE;
 
 private:
 
+  /*! Unique temporary file - removed on destruction */
+  class tTemporaryFile
+  {
+  public:
+    tTemporaryFile()
+    {
+      char buffer[] = "/tmp/rrlib_time_unit_test_XXXXXX";
+      int file_descriptor = mkstemp(buffer);
+      if (file_descriptor < 0)
+      {
+        throw std::runtime_error("Could not create temporary file");
+      }
+      close(file_descriptor);
+      name = buffer;
+    }
+
+    ~tTemporaryFile()
+    {
+      remove(name.c_str());
+    }
+
+    /*! File name */
+    std::string name;
+  };
+
   virtual void Test()
   {
     std::cout << " (Now is: " << ToIsoString(std::chrono::system_clock::now()) << ") ";
@@ -175,6 +265,1516 @@ private:
     }
 
   }
+
+  void TestTimeStretching()
+  {
+    // Application time ahead of system time results in negative internal time difference - changing the factor again stores it
+    SetTimeStretching(2, 1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    SetTimeStretching(3, 1);
+    std::shared_ptr<std::atomic<bool>> returned(new std::atomic<bool>(false));
+    std::thread([returned]()
+    {
+      Now();
+      returned->store(true);
+    }).detach();
+    for (int i = 0; i < 100 && (!returned->load()); i++)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Now() should return after stretching factor was changed again", returned->load());
+
+    tTimestamp system_start = tBaseClock::now();
+    tTimestamp start = Now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    tDuration system_elapsed = tBaseClock::now() - system_start;
+    tDuration elapsed = Now() - start;
+    SetTimeStretching(1, 1);
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Time stretching should be applied", elapsed >= 3 * std::chrono::milliseconds(20) && elapsed <= 3 * system_elapsed + std::chrono::milliseconds(5));
+  }
+
+  void TestFormatter()
+  {
+    tIsoTimestampFormatter formatter;
+    tTimestamp timestamp = ParseIsoTimestamp("2014-04-04T14:14:14+00:00");
+    std::string first = formatter.Format(timestamp);
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Formatter and ToIsoString should produce identical output", ToIsoString(timestamp), first);
+
+    // sub-second timestamps of the same second reuse cached prefix
+    const char* expected_fractions[] = { ".001", ".000001", ".000000001", ".120", ".123456789" };
+    const tDuration offsets[] = { std::chrono::milliseconds(1), std::chrono::microseconds(1), std::chrono::nanoseconds(1), std::chrono::milliseconds(120), std::chrono::nanoseconds(123456789) };
+    for (size_t i = 0; i < 5; i++)
+    {
+      std::string expected = first.substr(0, 19) + expected_fractions[i] + first.substr(19);
+      RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Sub-second digits should be formatted correctly", expected, formatter.Format(timestamp + offsets[i]));
+    }
+
+    // switching seconds back and forth must rebuild cache
+    for (int i = -3; i <= 3; i++)
+    {
+      tTimestamp other = timestamp + std::chrono::seconds(i * 1000) + std::chrono::nanoseconds(i * 250);
+      RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Formatted timestamp should parse to same timestamp", other, ParseIsoTimestamp(formatter.Format(other)));
+    }
+
+    // timestamps before 1970
+    tTimestamp early = ParseIsoTimestamp("1969-12-31T23:59:59.5+00:00");
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Formatted timestamp should parse to same timestamp", early, ParseIsoTimestamp(formatter.Format(early)));
+  }
+
+  void TestIsoTimestampParsing()
+  {
+    tTimestamp reference = ParseIsoTimestamp("2014-04-04T14:14:14+00:00");
+    const char* equivalent[] = { "2014-04-04T14:14:14Z", "2014-04-04t14:14:14z", "2014-04-04 14:14:14Z", "2014-04-04T14:14:14", "2014-04-04T16:14:14+02", "2014-04-04T16:14:14+0200",
+                                 "2014-04-04T19:59:14+05:45", "2014-04-04T08:29:14-05:45", "2014-04-05T00:14:14+10:00", "2014-04-04T14:14:13.9999999999999+00:00"
+                               };
+    for (const char* s : equivalent)
+    {
+      tTimestamp parsed = ParseIsoTimestamp(s);
+      if (s[19] == '.')
+      {
+        parsed += std::chrono::nanoseconds(1);
+      }
+      RRLIB_UNIT_TESTS_EQUALITY_MESSAGE(std::string("Timestamp should equal reference: ") + s, reference, parsed);
+    }
+
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Timestamp before 1970", tTimestamp(std::chrono::duration_cast<tDuration>(std::chrono::milliseconds(-500))), ParseIsoTimestamp("1969-12-31T23:59:59.5Z"));
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Leap day", std::string("P1D"), ToIsoString(ParseIsoTimestamp("2016-03-01T00:00:00Z") - ParseIsoTimestamp("2016-02-29T00:00:00Z")));
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Leap second", ParseIsoTimestamp("2017-01-01T00:00:00Z"), ParseIsoTimestamp("2016-12-31T23:59:60Z"));
+
+    const char* invalid[] = { "", "2014-04-04", "2014-4-04T14:14:14Z", "2014-13-04T14:14:14Z", "2014-02-29T14:14:14Z", "2014-04-04T24:14:14Z", "2014-04-04T14:14:14.Z",
+                              "2014-04-04T14:14:14+2:00", "2014-04-04T14:14:14+02:60", "2014-04-04T14:14:14Z ", "2014-04-04T14:14:14GMT", "3000-01-01T00:00:00Z"
+                            };
+    for (const char* s : invalid)
+    {
+      tTimestamp parsed;
+      RRLIB_UNIT_TESTS_ASSERT_MESSAGE(std::string("Parsing should fail: ") + s, !TryParseIsoTimestamp(s, strlen(s), parsed));
+      RRLIB_UNIT_TESTS_EXCEPTION(ParseIsoTimestamp(s), std::runtime_error);
+    }
+
+    tTimestamp parsed;
+    tParseError error;
+    TryParseIsoTimestamp("2014-04-04T14:61:14Z", 20, parsed, &error);
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Error should point to minutes", static_cast<size_t>(14), error.position);
+    TryParseIsoTimestamp("2014-04-04T14:14:14+02:00 ", 26, parsed, &error);
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Error should point to trailing space", static_cast<size_t>(25), error.position);
+  }
+
+  void TestBatchParsing()
+  {
+    std::vector<std::string> strings = { "2014-04-04T14:14:14+02:00", "2014-04-04T14:14:14.141+05:45", "2014-04-04T14:14:14.141414-09:30", "2014-04-04T14:14:14.141414141Z",
+                                         "2014-04-04t14:14:14Z", "2014-04-04T14:14:14", "2014-04-04T14:14:14+0200", "2016-02-29T23:59:60.5+00:00", "2014-02-29T14:14:14+02:00",
+                                         "2014-04-04T14:14:14.+02:00", "2014-04-04T14:14:1x+02:00", "2014-04-04X14:14:14+02:00", "1677-09-22T00:00:00Z", "", "2014-04-04T14:14:14.1234567891Z"
+                                       };
+    std::vector<tTimestamp> result(strings.size());
+    size_t expected_count = 0;
+    for (size_t i = 0; i < strings.size(); i++)
+    {
+      tTimestamp expected = cNO_TIME;
+      expected_count += TryParseIsoTimestamp(strings[i].c_str(), strings[i].length(), expected) ? 1 : 0;
+    }
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Number of parsed timestamps should match", expected_count, ParseIsoTimestamps(strings.data(), strings.size(), result.data()));
+    for (size_t i = 0; i < strings.size(); i++)
+    {
+      tTimestamp expected = cNO_TIME;
+      TryParseIsoTimestamp(strings[i].c_str(), strings[i].length(), expected);
+      RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Batch parsing should yield same result as single parsing: " + strings[i], expected, result[i]);
+    }
+
+    // fixed stride
+    std::string buffer;
+    std::vector<tTimestamp> expected;
+    tTimestamp timestamp = ParseIsoTimestamp("2014-04-04T14:14:14.141414141+02:00");
+    for (int i = 0; i < 101; i++)
+    {
+      timestamp += std::chrono::microseconds(123456789);
+      expected.push_back(timestamp);
+      std::string s = ToIsoString(timestamp);
+      s.resize(40, ' ');
+      buffer += s;
+    }
+    result.resize(expected.size());
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("All timestamps should be parsed", expected.size(), ParseIsoTimestamps(buffer.c_str(), 40, expected.size(), result.data()));
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Batch parsing should yield original timestamps", expected == result);
+  }
+
+  void TestBatchFormatting()
+  {
+    // spans daylight saving time changes in many time zones, days, months and years - and times before 1970
+    std::vector<tTimestamp> timestamps;
+    tTimestamp timestamp = ParseIsoTimestamp("2014-03-29T22:59:59.999Z");
+    for (int i = 0; i < 2000; i++)
+    {
+      timestamps.push_back(timestamp);
+      timestamp += std::chrono::seconds(97) + std::chrono::nanoseconds(i % 4 == 0 ? 0 : (i % 4 == 1 ? 125000000 : (i % 4 == 2 ? 123456000 : 1)));
+    }
+    timestamps.push_back(ParseIsoTimestamp("1969-12-31T23:59:59.999999999Z"));
+    timestamps.push_back(ParseIsoTimestamp("1900-02-28T12:00:00Z"));
+    timestamps.push_back(ParseIsoTimestamp("2000-02-29T12:00:00.5Z"));
+    timestamps.push_back(ParseIsoTimestamp("2016-12-31T23:59:59.000000123Z"));
+
+    std::string expected;
+    for (size_t i = 0; i < timestamps.size(); i++)
+    {
+      expected += (i ? "," : "") + ToIsoString(timestamps[i]);
+    }
+    std::string output = "prefix";
+    FormatIsoTimestamps(timestamps.data(), timestamps.size(), output, ',');
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Batch formatting should yield same output as ToIsoString()", "prefix" + expected, output);
+  }
+
+  void TestIsoDurationParsing()
+  {
+    constexpr tDuration cHALF_SECOND = "PT0.5S"_iso_duration;
+    constexpr tDuration cLONG = "P1Y2M4DT3H43.22S"_iso_duration;
+    static_assert(cHALF_SECOND == std::chrono::milliseconds(500), "Literal should be evaluated at compile time");
+    static_assert("P2W"_iso_duration == std::chrono::hours(14 * 24), "Literal should be evaluated at compile time");
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Literal and ParseIsoDuration should yield same duration", ParseIsoDuration("P1Y2M4DT3H43.22S"), cLONG);
+
+    const char* valid[] = { "P", "PT", "P0D", "PT0.5S", "PT2,5S", "P1Y", "P13M", "P1Y11M", "P2W", "P400D", "PT3235.025S", "PT43.1234S", "P1Y244DT3H43.22S", "PT1H1M1.000000001S", "PT0.0000000001S", "P290Y" };
+    for (const char* s : valid)
+    {
+      tDuration parsed;
+      RRLIB_UNIT_TESTS_ASSERT_MESSAGE(std::string("Parsing should succeed: ") + s, TryParseIsoDuration(s, strlen(s), parsed));
+      RRLIB_UNIT_TESTS_EQUALITY_MESSAGE(std::string("Literal parser should yield same result: ") + s, std::chrono::duration_cast<std::chrono::nanoseconds>(parsed).count(), internal::ParseDurationLiteral(s, strlen(s)));
+    }
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Duration should be P1Y11M", ToIsoString(ParseIsoDuration("P1Y334D")), ToIsoString(ParseIsoDuration("P1Y11M")));
+
+    const char* invalid[] = { "", "T1S", "P1", "P1S", "PT1D", "P1D1Y", "P1Y1Y", "PTT1S", "P1.5D", "PT1.S", "PT1X", "P1000Y", "PT1234567890123456S" };
+    for (const char* s : invalid)
+    {
+      tDuration parsed;
+      RRLIB_UNIT_TESTS_ASSERT_MESSAGE(std::string("Parsing should fail: ") + s, !TryParseIsoDuration(s, strlen(s), parsed));
+      RRLIB_UNIT_TESTS_EXCEPTION(ParseIsoDuration(s), std::runtime_error);
+      RRLIB_UNIT_TESTS_EXCEPTION(internal::ParseDurationLiteral(s, strlen(s)), std::invalid_argument);
+    }
+  }
+
+  void TestCalendarAndTimestampLiterals()
+  {
+    static_assert(DaysFromCivil(1970, 1, 1) == 0 && DaysFromCivil(2000, 3, 1) == 11017 && DaysFromCivil(1969, 12, 31) == -1, "Should be evaluated at compile time");
+    static_assert(CivilFromDays(11017).year == 2000 && CivilFromDays(11017).month == 3 && CivilFromDays(11017).day == 1, "Should be evaluated at compile time");
+    for (int64_t day = -200000; day < 200000; day += 7)
+    {
+      tCivilDate date = CivilFromDays(day);
+      RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Civil date conversion should round-trip", day == DaysFromCivil(date.year, date.month, date.day) && date.day <= DaysInMonth(date.year, date.month));
+    }
+
+    constexpr tTimestamp cGPS_EPOCH = "1980-01-06T00:00:00Z"_iso_timestamp;
+    static_assert(cGPS_EPOCH.time_since_epoch() == std::chrono::seconds(315964800), "Literal should be evaluated at compile time");
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Literal should equal parsed timestamp", ParseIsoTimestamp("2014-04-04T14:14:14.141414141+02:00"), "2014-04-04T14:14:14.141414141+02:00"_iso_timestamp);
+
+    const char* valid[] = { "2014-04-04T14:14:14Z", "2014-04-04t14:14:14z", "2014-04-04 14:14:14.5", "2016-02-29T16:14:14+02", "2014-04-04T16:14:14-0230", "2014-04-04T19:59:14.000000001+05:45",
+                            "1969-12-31T23:59:59.9999999999Z", "2016-12-31T23:59:60Z", "1677-09-22T00:00:00Z", "2262-04-11T00:00:00Z"
+                          };
+    for (const char* s : valid)
+    {
+      RRLIB_UNIT_TESTS_EQUALITY_MESSAGE(std::string("Literal parser should yield same result: ") + s, ParseIsoTimestamp(s).time_since_epoch().count(), internal::ParseTimestampLiteral(s, strlen(s)));
+    }
+    const char* invalid[] = { "", "2014-04-04", "2014-4-04T14:14:14Z", "2014-13-04T14:14:14Z", "2014-02-29T14:14:14Z", "2014-04-04T24:14:14Z", "2014-04-04T14:14:14.Z",
+                              "2014-04-04T14:14:14+2:00", "2014-04-04T14:14:14+02:60", "2014-04-04T14:14:14Z ", "2014-04-04T14:14:14GMT", "3000-01-01T00:00:00Z", "2014-04-04T14:14:14+02:00:00"
+                            };
+    for (const char* s : invalid)
+    {
+      RRLIB_UNIT_TESTS_EXCEPTION(internal::ParseTimestampLiteral(s, strlen(s)), std::invalid_argument);
+    }
+  }
+
+  void TestNmeaParser()
+  {
+    const std::string stream =
+      "4807.038,N*1F\r\n"  // tail of sentence received before connecting
+      "$GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230324,003.1,W*61\r\n"
+      "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\n"
+      "$GNRMC,235959.50,V,,,,,,,311224,,,N*60\r\n"
+      "$GPZDA,201530.00,04,07,2002,00,00*60\r\n"
+      "$GPRMC,,V,,,,,,,,,,N*53\r\n"
+      "$GPRMC,123519,A,,,,,,,320194,,,A*4B\r\n"                                     // invalid date
+      "$GPRMC,123520,A,4807.038,N,01131.000,E,022.4,084.4,230324,003.1,W*6A\r\n"    // invalid checksum
+      "$GPRMC,123520,A,4807.038,N,01131.000,E,022.4,084.4,230324,003.1,W\r\n"      // no checksum
+      "$GPTXT,01,01,02,ANTENNA STATUS OK - RECEIVER SOFTWARE VERSION 1.0 - THIS TEXT SENTENCE IS LONGER THAN ANY NMEA-0183 SENTENCE THE PARSER BUFFERS*00\r\n";  // too long
+    const std::vector<tTimestamp> expected = { ParseIsoTimestamp("2024-03-23T12:35:19Z"), ParseIsoTimestamp("2024-12-31T23:59:59.5Z"), ParseIsoTimestamp("2002-07-04T20:15:30Z") };
+
+    for (size_t chunk_size : { stream.length(), static_cast<size_t>(1), static_cast<size_t>(7) })
+    {
+      tNmeaParser parser;
+      std::vector<tNmeaTimestamp> result;
+      for (size_t i = 0; i < stream.length(); i += chunk_size)
+      {
+        parser.Parse(stream.c_str() + i, std::min(chunk_size, stream.length() - i), [&result](const tNmeaTimestamp & t)
+        {
+          result.push_back(t);
+        });
+      }
+      RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("All sentences should be counted", static_cast<size_t>(9), parser.GetSentenceCount());
+      RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Invalid sentences should be counted", static_cast<size_t>(4), parser.GetErrorCount());
+      RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Three timestamps should be extracted", expected.size(), result.size());
+      for (size_t i = 0; i < result.size(); i++)
+      {
+        RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Extracted timestamp should be correct", expected[i], result[i].timestamp);
+      }
+      RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Sentence types and status should be extracted", result.size() == 3 && result[0].valid && (!result[1].valid) && result[2].sentence == tNmeaSentence::ZDA && result[1].sentence == tNmeaSentence::RMC);
+    }
+
+    RRLIB_UNIT_TESTS_EXCEPTION(ParseNmeaTimestamp("140512", "310214"), std::runtime_error);
+  }
+
+  void TestTimeScales()
+  {
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("TAI - UTC before leap second", tDuration(std::chrono::seconds(36)), GetTaiOffset(ParseIsoTimestamp("2016-12-31T23:59:59Z")));
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("TAI - UTC after leap second", tDuration(std::chrono::seconds(37)), GetTaiOffset(ParseIsoTimestamp("2017-01-01T00:00:00Z")));
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("TAI - UTC before table", tDuration(std::chrono::seconds(10)), GetTaiOffset(ParseIsoTimestamp("1970-01-01T00:00:00Z")));
+
+    tTimestamp utc = ParseIsoTimestamp("2024-03-23T12:35:19.5Z");
+    tGpsTime gps = UtcToGps(utc);
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("GPS week should be correct", static_cast<int64_t>(2306), gps.week);
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("GPS time of week should be correct", tDuration(std::chrono::milliseconds(563737500)), gps.time_of_week);
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("GPS time should convert back to UTC", utc, GpsToUtc(gps));
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Start of GPS week should be correct", ParseIsoTimestamp("2016-12-31T23:59:43Z"), GpsToUtc(tGpsTime { 1930, tDuration::zero() }));
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Last second of day should be repeated during leap second", ParseIsoTimestamp("2016-12-31T23:59:59.5Z"), TaiToUtc(UtcToTai(ParseIsoTimestamp("2017-01-01T00:00:00Z")) - std::chrono::milliseconds(500)));
+
+    std::vector<tTimestamp> timestamps, tai(1000), utc_round_trip(1000);
+    std::vector<tGpsTime> gps_times(1000);
+    for (size_t i = 0; i < 1000; i++)
+    {
+      timestamps.push_back(ParseIsoTimestamp("1985-01-01T00:00:00Z") + std::chrono::hours(i * 337));
+    }
+    UtcToTai(timestamps.data(), timestamps.size(), tai.data());
+    TaiToUtc(tai.data(), tai.size(), utc_round_trip.data());
+    UtcToGps(timestamps.data(), timestamps.size(), gps_times.data());
+    for (size_t i = 0; i < timestamps.size(); i++)
+    {
+      RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Batch conversion should yield same results as single conversion", UtcToTai(timestamps[i]), tai[i]);
+      RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Batch conversion should yield same results as single conversion", UtcToGps(timestamps[i]).time_of_week, gps_times[i].time_of_week);
+    }
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Conversion to TAI should round-trip", timestamps == utc_round_trip);
+    GpsToUtc(gps_times.data(), gps_times.size(), utc_round_trip.data());
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Conversion to GPS time should round-trip", timestamps == utc_round_trip);
+
+    // Load table with additional (hypothetical) leap second
+    tTemporaryFile temporary_file;
+    const std::string& file_name = temporary_file.name;
+    {
+      std::ofstream file(file_name);
+      file << "#\tTest table\n#@\t3991593600\n2272060800\t10\t# 1 Jan 1972\n3692217600\t37\t# 1 Jan 2017\n3976214400\t38\t# 1 Jan 2026\n";
+    }
+    LoadLeapSecondTable(file_name);
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("TAI - UTC should be taken from loaded table", tDuration(std::chrono::seconds(38)), GetTaiOffset(ParseIsoTimestamp("2026-01-01T00:00:00Z")));
+    {
+      std::ofstream file(file_name);
+      int offset = 10;
+      for (const char* date : { "1972-01-01", "1972-07-01", "1973-01-01", "1974-01-01", "1975-01-01", "1976-01-01", "1977-01-01", "1978-01-01", "1979-01-01", "1980-01-01",
+                                "1981-07-01", "1982-07-01", "1983-07-01", "1985-07-01", "1988-01-01", "1990-01-01", "1991-01-01", "1992-07-01", "1993-07-01", "1994-07-01",
+                                "1996-01-01", "1997-07-01", "1999-01-01", "2006-01-01", "2009-01-01", "2012-07-01", "2015-07-01", "2017-01-01"
+                              })
+      {
+        tTimestamp transition = ParseIsoTimestamp(std::string(date) + "T00:00:00Z");
+        file << (std::chrono::duration_cast<std::chrono::seconds>(transition.time_since_epoch()).count() + 2208988800LL) << " " << (offset++) << "\n";
+      }
+    }
+    LoadLeapSecondTable(file_name);
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("TAI - UTC should be taken from loaded table", tDuration(std::chrono::seconds(37)), GetTaiOffset(ParseIsoTimestamp("2026-01-01T00:00:00Z")));
+    UtcToTai(timestamps.data(), timestamps.size(), utc_round_trip.data());
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Loaded table should yield same results as compiled-in table", tai == utc_round_trip);
+    remove(file_name.c_str());
+    RRLIB_UNIT_TESTS_EXCEPTION(LoadLeapSecondTable(file_name), std::runtime_error);
+  }
+
+  void TestRounding()
+  {
+    tTimestamp timestamp = ParseIsoTimestamp("2024-03-23T14:14:14.5Z");
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Floor to fixed duration", ParseIsoTimestamp("2024-03-23T14:00:00Z"), Floor(timestamp, std::chrono::minutes(15)));
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Ceil to fixed duration", ParseIsoTimestamp("2024-03-23T14:15:00Z"), Ceil(timestamp, std::chrono::minutes(15)));
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Round to fixed duration", ParseIsoTimestamp("2024-03-23T14:15:00Z"), Round(timestamp, std::chrono::minutes(15)));
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Round to fixed duration", ParseIsoTimestamp("2024-03-23T14:14:14Z"), Round(timestamp - std::chrono::nanoseconds(1), std::chrono::seconds(1)));
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Floor before 1970", ParseIsoTimestamp("1969-12-31T23:59:59Z"), Floor(ParseIsoTimestamp("1969-12-31T23:59:59.5Z"), std::chrono::seconds(1)));
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Boundary should not be changed", ParseIsoTimestamp("2024-03-23T14:00:00Z"), Ceil(ParseIsoTimestamp("2024-03-23T14:00:00Z"), std::chrono::hours(1)));
+
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Floor to week", ParseIsoTimestamp("2024-03-18T00:00:00Z"), Floor(timestamp, tCalendarUnit::WEEK));
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Floor to month", ParseIsoTimestamp("2024-03-01T00:00:00Z"), Floor(timestamp, tCalendarUnit::MONTH));
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Ceil to month", ParseIsoTimestamp("2024-04-01T00:00:00Z"), Ceil(timestamp, tCalendarUnit::MONTH));
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Ceil to month", ParseIsoTimestamp("2025-01-01T00:00:00Z"), Ceil(ParseIsoTimestamp("2024-12-31T00:00:00Z"), tCalendarUnit::MONTH));
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Round to year", ParseIsoTimestamp("2024-01-01T00:00:00Z"), Round(timestamp, tCalendarUnit::YEAR));
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Round to day", ParseIsoTimestamp("2024-03-24T00:00:00Z"), Round(timestamp, tCalendarUnit::DAY));
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Floor to minute", ParseIsoTimestamp("2024-03-23T14:14:00Z"), Floor(timestamp, tCalendarUnit::MINUTE));
+
+    tTimestamp local_day = Floor(timestamp, tCalendarUnit::DAY, tCalendarZone::LOCAL);
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Floor to local day should yield local midnight", std::string("T00:00:00"), ToIsoString(local_day).substr(10, 9));
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Floor to local day should yield local midnight", local_day <= timestamp && timestamp - local_day < std::chrono::hours(26));
+
+    std::vector<tTimestamp> timestamps, result(2000);
+    for (size_t i = 0; i < 2000; i++)
+    {
+      timestamps.push_back(ParseIsoTimestamp("2023-12-30T21:17:00Z") + std::chrono::seconds(i * i * 97));
+    }
+    for (tCalendarZone zone : { tCalendarZone::UTC, tCalendarZone::LOCAL })
+    {
+      for (tCalendarUnit unit : { tCalendarUnit::SECOND, tCalendarUnit::MINUTE, tCalendarUnit::HOUR, tCalendarUnit::DAY, tCalendarUnit::WEEK, tCalendarUnit::MONTH, tCalendarUnit::YEAR })
+      {
+        Floor(timestamps.data(), timestamps.size(), unit, result.data(), zone);
+        for (size_t i = 0; i < timestamps.size(); i++)
+        {
+          RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Batch floor should yield same result", Floor(timestamps[i], unit, zone), result[i]);
+        }
+        Round(timestamps.data(), timestamps.size(), unit, result.data(), zone);
+        for (size_t i = 0; i < timestamps.size(); i++)
+        {
+          RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Batch round should yield same result", Round(timestamps[i], unit, zone), result[i]);
+        }
+      }
+    }
+    Ceil(timestamps.data(), timestamps.size(), std::chrono::minutes(10), result.data());
+    for (size_t i = 0; i < timestamps.size(); i++)
+    {
+      RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Batch ceil should yield same result", Ceil(timestamps[i], std::chrono::minutes(10)), result[i]);
+    }
+  }
+
+  void TestTimeZone()
+  {
+    const tTimeZone& utc = tTimeZone::Get("UTC");
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Time zones should be cached", &utc == &tTimeZone::Get("UTC"));
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("UTC should be formatted correctly", std::string("2014-04-04T14:14:14.141+00:00"), ToIsoString(ParseIsoTimestamp("2014-04-04T14:14:14.141Z"), utc));
+    RRLIB_UNIT_TESTS_EXCEPTION(tTimeZone::Get("Nonexistent/Zone"), std::runtime_error);
+
+    // Compare with libc for zones from time zone database
+    const char* original_tz = getenv("TZ");
+    std::string original_tz_copy = original_tz ? original_tz : "";
+    for (const char* name : { "Europe/Berlin", "America/New_York", "Asia/Kathmandu", "Australia/Lord_Howe", "America/Santiago", "Pacific/Apia" })
+    {
+      std::unique_ptr<tTimeZone> zone;
+      try
+      {
+        zone.reset(new tTimeZone(name));
+      }
+      catch (const std::runtime_error&)
+      {
+        continue;  // time zone database not installed
+      }
+      setenv("TZ", name, 1);
+      tzset();
+      for (int64_t second = -2000000000; second < 8000000000LL; second += 3607 * 13)
+      {
+        time_t t = second;
+        tm local;
+        localtime_r(&t, &local);
+        RRLIB_UNIT_TESTS_EQUALITY_MESSAGE(std::string("Offset should equal libc's: ") + name, static_cast<int>(local.tm_gmtoff), zone->GetUtcOffsetSeconds(second));
+      }
+      tTimestamp timestamp = ParseIsoTimestamp("2024-03-23T14:14:14.5Z");
+      for (int i = 0; i < 400; i++, timestamp += std::chrono::hours(23))
+      {
+        RRLIB_UNIT_TESTS_EQUALITY_MESSAGE(std::string("Formatting should equal local formatting: ") + name, ToIsoString(timestamp), ToIsoString(timestamp, *zone));
+        RRLIB_UNIT_TESTS_EQUALITY_MESSAGE(std::string("Rounding should equal local rounding: ") + name, Floor(timestamp, tCalendarUnit::DAY, tCalendarZone::LOCAL), Floor(timestamp, tCalendarUnit::DAY, *zone));
+      }
+    }
+    if (original_tz)
+    {
+      setenv("TZ", original_tz_copy.c_str(), 1);
+    }
+    else
+    {
+      unsetenv("TZ");
+    }
+    tzset();
+  }
+
+  void TestDurationFormatting()
+  {
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Zero duration", std::string("0 ms"), ToString(std::chrono::nanoseconds(0)));
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Three fractional digits", std::string("1.500 ms"), ToString(std::chrono::microseconds(1500)));
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Six fractional digits", std::string("1.234567 ms"), ToString(std::chrono::nanoseconds(1234567)));
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Negative duration", std::string("-7200000.000 ms"), ToString(std::chrono::hours(-2)));
+
+    char buffer[cMAX_DURATION_STRING_LENGTH + 1];
+    const std::pair<tDurationFormat, const char*> formats[] =
+    {
+      { tDurationFormat(tDurationFormat::tUnit::MICROSECONDS), "1234.567 us" },
+      { tDurationFormat(tDurationFormat::tUnit::SECONDS), "0.001234567 s" },
+      { tDurationFormat(tDurationFormat::tUnit::SECONDS, 3), "0.001 s" },
+      { tDurationFormat(tDurationFormat::tUnit::MILLISECONDS, 0), "1 ms" },
+      { tDurationFormat(tDurationFormat::tUnit::MILLISECONDS, 9), "1.234567000 ms" },
+      { tDurationFormat(tDurationFormat::tUnit::NANOSECONDS), "1234567 ns" }
+    };
+    for (auto & format : formats)
+    {
+      RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Duration should be formatted as specified", std::string(format.second), std::string(buffer, ToString(std::chrono::nanoseconds(1234567), buffer, format.first)));
+    }
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Rounding should carry", std::string("-2.00 s"), std::string(buffer, ToString(std::chrono::nanoseconds(-1999999999), buffer, tDurationFormat(tDurationFormat::tUnit::SECONDS, 2))));
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Minimum duration", std::string("-9223372036.854775808 s"), std::string(buffer, ToString(std::chrono::nanoseconds::min(), buffer, tDurationFormat(tDurationFormat::tUnit::SECONDS))));
+
+    // Round trip
+    int64_t value = 1;
+    for (int i = 0; i < 200; i++, value = value * 7 + i)
+    {
+      for (std::chrono::nanoseconds duration : { std::chrono::nanoseconds(value), std::chrono::nanoseconds(-value), std::chrono::nanoseconds(value - value % 1000) })
+      {
+        RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Buffer variant should yield same result", ToString(duration), std::string(buffer, ToString(duration, buffer)));
+        RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Parsing should yield formatted duration: " + ToString(duration), duration.count(), ParseDuration(ToString(duration)).count());
+        ToString(duration, buffer, tDurationFormat(tDurationFormat::tUnit::SECONDS));
+        RRLIB_UNIT_TESTS_EQUALITY_MESSAGE(std::string("Parsing should yield formatted duration: ") + buffer, duration.count(), ParseDuration(buffer).count());
+      }
+      value = value % 1000000000000000000LL;
+    }
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Legacy units should be parsed", std::chrono::nanoseconds(std::chrono::minutes(3)).count(), ParseDuration("3 minutes").count());
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Legacy units should be parsed", std::chrono::nanoseconds(std::chrono::hours(-1)).count(), ParseDuration("-1 hour").count());
+    for (const char* s : { "", "ms", "1.5 minutes", "1. ms", "1 xs", "-", "10000000000 s", "1 ms ", "+1 ms" })
+    {
+      RRLIB_UNIT_TESTS_EXCEPTION(ParseDuration(s), std::runtime_error);
+    }
+
+    // Streams
+    std::ostringstream stream;
+    tTimestamp timestamp = ParseIsoTimestamp("2014-04-04T14:14:14.141Z");
+    stream << Formatted(std::chrono::microseconds(1500)) << " " << Formatted(timestamp) << " " << Formatted(timestamp, tTimeZone::Get("UTC"));
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Stream output should be identical to string functions", "1.500 ms " + ToIsoString(timestamp) + " 2014-04-04T14:14:14.141+00:00", stream.str());
+  }
+
+  void TestTimestampCodec()
+  {
+    // 100 Hz samples with jitter, a gap, out-of-order and extreme values
+    std::vector<tTimestamp> timestamps;
+    tTimestamp timestamp = ParseIsoTimestamp("2014-04-04T14:14:14.141414141Z");
+    for (int i = 0; i < 2500; i++)
+    {
+      timestamp += std::chrono::milliseconds(10) + std::chrono::microseconds((i * 7919) % 200 - 100);
+      timestamps.push_back(timestamp);
+    }
+    timestamps[1000] += std::chrono::hours(1);
+    timestamps[1001] -= std::chrono::seconds(1);
+    timestamps.push_back(tTimestamp::max());
+    timestamps.push_back(tTimestamp::min());
+    timestamps.push_back(tTimestamp());
+
+    std::vector<uint8_t> data;
+    tTimestampEncoder encoder(100);
+    encoder.Encode(timestamps.data(), 1234, data);
+    encoder.Encode(timestamps.data() + 1234, timestamps.size() - 1234, data);
+    std::vector<tTimestamp> decoded(timestamps.size() + 10);
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Only complete blocks should be written", static_cast<size_t>(2500), tTimestampDecoder(data.data(), data.size()).Decode(decoded.data(), decoded.size()));
+    encoder.Flush(data);
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Regular timestamps should be compressed", data.size() < timestamps.size() * 4);
+
+    tTimestampDecoder decoder(data.data(), data.size());
+    size_t count = 0, n = 0;
+    while ((n = decoder.Decode(&decoded[count], std::min<size_t>(77, decoded.size() - count))) > 0)
+    {
+      count += n;
+    }
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("All timestamps should be decoded", timestamps.size(), count);
+    for (size_t i = 0; i < timestamps.size(); i++)
+    {
+      RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Decoded timestamp should equal original", timestamps[i].time_since_epoch().count(), decoded[i].time_since_epoch().count());
+    }
+
+    // Seeking
+    for (size_t i : { 0, 1, 99, 100, 555, 999 })
+    {
+      decoder.Seek(timestamps[i] - std::chrono::nanoseconds(1));
+      RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Decoder should be positioned at first timestamp not before seeked one", static_cast<size_t>(1), decoder.Decode(&decoded[0], 1));
+      RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Decoder should be positioned at first timestamp not before seeked one", timestamps[i].time_since_epoch().count(), decoded[0].time_since_epoch().count());
+    }
+    decoder.Seek(timestamps[0] - std::chrono::hours(1));
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Seeking before start should start at first timestamp", timestamps.size(), decoder.Decode(decoded.data(), decoded.size()));
+    decoder.Rewind();
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Rewind should start at first timestamp", timestamps[0].time_since_epoch().count(), (decoder.Decode(decoded.data(), 1), decoded[0].time_since_epoch().count()));
+
+    // Corrupt data
+    for (size_t size : { data.size() - 1, static_cast<size_t>(10) })
+    {
+      tTimestampDecoder truncated(data.data(), size);
+      RRLIB_UNIT_TESTS_EXCEPTION(truncated.Decode(decoded.data(), decoded.size()), std::runtime_error);
+    }
+  }
+
+  void TestTimelineFile()
+  {
+    tTemporaryFile temporary_file;
+    const std::string& file_name = temporary_file.name;
+    tTimestamp start = ParseIsoTimestamp("2014-04-04T14:00:00Z");
+    auto record_time = [start](uint32_t i)
+    {
+      return start + std::chrono::milliseconds(i * 10) - std::chrono::milliseconds(i % 7 == 0 ? 25 : 0);  // some records out of order
+    };
+
+    // Write in two sessions (second one appends)
+    const uint32_t cRECORDS = 10000;
+    for (uint32_t session = 0; session < 2; session++)
+    {
+      tTimelineWriter writer(file_name, 4096);
+      for (uint32_t i = session * cRECORDS / 2; i < (session + 1) * cRECORDS / 2; i++)
+      {
+        char data[8] = { 0 };
+        memcpy(data, &i, sizeof(i));
+        writer.Append(record_time(i), data, sizeof(i) + i % 5);
+      }
+    }
+
+    tTimelineFile file(file_name);
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("All records should be in file", static_cast<size_t>(cRECORDS), file.GetRecordCount());
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("File should consist of multiple blocks", file.GetBlockCount() > 10);
+    for (uint32_t begin_index : { 0u, 1u, 4999u, 7777u, 9990u })
+    {
+      tTimestamp begin = start + std::chrono::milliseconds(begin_index * 10), end = begin + std::chrono::milliseconds(100);
+      std::vector<uint32_t> expected, found;
+      for (uint32_t i = 0; i < cRECORDS; i++)
+      {
+        if (record_time(i) >= begin && record_time(i) < end)
+        {
+          expected.push_back(i);
+        }
+      }
+      tTimelineRange range = file.Query(begin, end);
+      RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Only a small part of the file should be mapped", range.GetMappedSize() <= 4 * 4096);
+      for (const tTimelineRecord & record : range)
+      {
+        uint32_t i = 0;
+        memcpy(&i, record.data, sizeof(i));
+        RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Record should have been written with this timestamp", record_time(i).time_since_epoch().count(), record.timestamp.time_since_epoch().count());
+        RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Record should have been written with this size", static_cast<size_t>(sizeof(i) + i % 5), record.size);
+        found.push_back(i);
+      }
+      RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Query should return all records in time range", expected.size(), found.size());
+      RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Query should return all records in time range", expected == found);
+    }
+    tTimelineRange empty = file.Query(start - std::chrono::hours(1), start - std::chrono::minutes(1));
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Query outside of recorded time should be empty", empty.begin() == empty.end() && empty.GetMappedSize() == 0);
+
+    // Files without index cannot be opened - but can be repaired
+    std::ofstream(file_name, std::ios::app) << "garbage";
+    RRLIB_UNIT_TESTS_EXCEPTION(tTimelineFile invalid(file_name), std::runtime_error);
+    tTimelineWriter::Repair(file_name, 4096);
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Repaired file should contain all records", static_cast<size_t>(cRECORDS), tTimelineFile(file_name).GetRecordCount());
+
+    // Writer that was not closed (file ends with incomplete record): reopening rebuilds index
+    size_t records_end = 16;
+    for (uint32_t i = 0; i < cRECORDS; i++)
+    {
+      records_end += internal::TimelineRecordSize(sizeof(i) + i % 5);
+    }
+    std::string content;
+    {
+      std::ifstream input(file_name, std::ios::binary);
+      content.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+    }
+    std::ofstream(file_name, std::ios::binary | std::ios::trunc).write(content.data(), records_end + 12);
+    RRLIB_UNIT_TESTS_EXCEPTION(tTimelineFile invalid(file_name), std::runtime_error);
+    tTimelineWriter::Repair(file_name, 4096);
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Incomplete record should be removed", static_cast<size_t>(cRECORDS), tTimelineFile(file_name).GetRecordCount());
+
+    // Writer interrupted while writing index (file ends with index marker and incomplete index)
+    std::ofstream(file_name, std::ios::binary | std::ios::trunc).write(content.data(), records_end + sizeof(internal::tTimelineRecordHeader) + 20);
+    RRLIB_UNIT_TESTS_EXCEPTION(tTimelineFile invalid(file_name), std::runtime_error);
+    {
+      tTimelineWriter writer(file_name, 4096);
+      writer.Append(record_time(cRECORDS), &cRECORDS, sizeof(cRECORDS));
+    }
+    tTimelineFile recovered(file_name);
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Recovered file should contain all complete records and appended one", static_cast<size_t>(cRECORDS + 1), recovered.GetRecordCount());
+    size_t last_records = 0;
+    for (const tTimelineRecord & record : recovered.Query(record_time(cRECORDS - 10), record_time(cRECORDS) + std::chrono::milliseconds(1)))
+    {
+      RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Recovered records should be intact", record.size >= sizeof(uint32_t));
+      last_records++;
+    }
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Appended record should follow recovered records", last_records >= 10);
+  }
+
+  void TestTimestampIndex()
+  {
+    // Compare to std::lower_bound/upper_bound for different sizes (complete and incomplete trees) with duplicates - with and without gaps (no interpolation)
+    for (size_t test = 0; test < 18; test++)
+    {
+      const size_t cSIZES[] = { 0, 1, 2, 7, 8, 100, 1023, 1024, 1025 };
+      size_t size = cSIZES[test % 9];
+      bool gaps = test >= 9;
+      std::vector<tTimestamp> timestamps;
+      tTimestamp timestamp = ParseIsoTimestamp("2014-04-04T14:14:14Z");
+      for (size_t i = 0; i < size; i++)
+      {
+        timestamp += std::chrono::milliseconds(i % 5 == 0 ? 0 : 10 + i % 3) + std::chrono::milliseconds(gaps && i % 100 == 99 ? 10000 : 0);
+        timestamps.push_back(timestamp);
+      }
+      tTimestampIndex index(timestamps.data(), timestamps.size());
+      RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Index should contain all timestamps", size, index.GetSize());
+
+      std::vector<tTimestamp> probes;
+      for (int64_t offset = -20; offset < static_cast<int64_t>(size * 12 + (gaps ? size * 100 : 0) + 20); offset += 3)
+      {
+        probes.push_back(ParseIsoTimestamp("2014-04-04T14:14:14Z") + std::chrono::milliseconds(offset) + std::chrono::microseconds(offset % 2 ? 500 : 0));
+      }
+      std::vector<size_t> ceil(probes.size()), floor(probes.size()), nearest(probes.size());
+      index.Ceil(probes.data(), probes.size(), ceil.data());
+      index.Floor(probes.data(), probes.size(), floor.data());
+      index.Nearest(probes.data(), probes.size(), nearest.data());
+      for (size_t i = 0; i < probes.size(); i++)
+      {
+        const tTimestamp& probe = probes[i];
+        size_t expected_ceil = std::lower_bound(timestamps.begin(), timestamps.end(), probe) - timestamps.begin();
+        size_t expected_floor = std::upper_bound(timestamps.begin(), timestamps.end(), probe) - timestamps.begin();
+        expected_floor = expected_floor ? expected_floor - 1 : size;
+        size_t expected_nearest = expected_ceil;
+        if (expected_ceil == size || (expected_ceil > 0 && probe - timestamps[expected_ceil - 1] <= timestamps[expected_ceil] - probe))
+        {
+          expected_nearest = expected_ceil ? std::lower_bound(timestamps.begin(), timestamps.end(), timestamps[expected_ceil - 1]) - timestamps.begin() : size;
+        }
+        RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Ceil should be equivalent to std::lower_bound", expected_ceil, index.Ceil(probe));
+        RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Floor should return last timestamp not after probe", expected_floor, index.Floor(probe));
+        RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Nearest should return closest timestamp", expected_nearest, index.Nearest(probe));
+        RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Batch Ceil should yield same result", expected_ceil, ceil[i]);
+        RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Batch Floor should yield same result", expected_floor, floor[i]);
+        RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Batch Nearest should yield same result", expected_nearest, nearest[i]);
+      }
+
+      // Unsorted probes
+      std::reverse(probes.begin(), probes.end());
+      index.Nearest(probes.data(), probes.size(), nearest.data());
+      for (size_t i = 0; i < probes.size(); i++)
+      {
+        RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Batch Nearest should support unsorted probes", index.Nearest(probes[i]), nearest[i]);
+      }
+    }
+
+    std::vector<tTimestamp> unsorted = { tTimestamp(std::chrono::seconds(2)), tTimestamp(std::chrono::seconds(1)) };
+    RRLIB_UNIT_TESTS_EXCEPTION(tTimestampIndex(unsorted.data(), unsorted.size()), std::runtime_error);
+  }
+
+  void TestStreamMerging()
+  {
+    struct tSample
+    {
+      tTimestamp timestamp;
+      size_t stream, index;
+    };
+
+    // Streams with different rates and jitter (stream 2 is empty, stream 3 has equal timestamps as stream 0)
+    const size_t cSTREAMS = 5;
+    std::vector<std::vector<tSample>> recordings(cSTREAMS);
+    tTimestamp start = ParseIsoTimestamp("2014-04-04T14:14:14Z");
+    for (size_t stream = 0; stream < cSTREAMS; stream++)
+    {
+      if (stream == 2)
+      {
+        continue;
+      }
+      for (size_t i = 0; i < 200 * (stream + 1); i++)
+      {
+        tDuration offset = stream == 3 ? std::chrono::milliseconds(40 * (i / 4)) : std::chrono::microseconds((i * 40000 + (i * 7919) % 3000) / (stream + 1));
+        recordings[stream].push_back(tSample { start + offset, stream, i });
+      }
+    }
+
+    std::vector<tSample> expected;
+    std::vector<tStreamMerger<tSample>::tRangeSource> sources;
+    for (auto & recording : recordings)
+    {
+      expected.insert(expected.end(), recording.begin(), recording.end());
+      sources.emplace_back(recording.begin(), recording.end());
+    }
+    std::stable_sort(expected.begin(), expected.end(), [](const tSample & a, const tSample & b)
+    {
+      return a.timestamp < b.timestamp;
+    });
+    tStreamMerger<tSample> merger(std::move(sources));
+    tApproximateTimeMatcher<tSample> matcher(cSTREAMS - 1, 0, std::chrono::milliseconds(2));
+    std::vector<std::vector<size_t>> sets;
+    auto callback = [&sets](const std::vector<const tSample*>& set)
+    {
+      sets.emplace_back();
+      for (const tSample * sample : set)
+      {
+        sets.back().push_back(sample->index);
+      }
+    };
+    tSample sample;
+    size_t stream = 0, count = 0;
+    while (merger.Next(sample, stream))
+    {
+      RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Records should be merged in timestamp order (stable)", count < expected.size() && sample.stream == expected[count].stream && sample.index == expected[count].index);
+      RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Stream index should be reported", sample.stream, stream);
+      count++;
+      if (stream != 2)
+      {
+        matcher.Push(stream > 2 ? stream - 1 : stream, sample, callback);
+      }
+    }
+    matcher.Flush(callback);
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("All records should be merged", expected.size(), count);
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Merger should remain at end", !merger.Next(sample, stream));
+
+    // Compare pairing to brute force
+    std::vector<std::vector<size_t>> expected_sets;
+    for (const tSample & pivot : recordings[0])
+    {
+      std::vector<size_t> set = { pivot.index };
+      for (size_t other : { 1, 3, 4 })
+      {
+        const tSample* closest = nullptr;
+        for (const tSample & candidate : recordings[other])
+        {
+          tDuration difference = candidate.timestamp > pivot.timestamp ? candidate.timestamp - pivot.timestamp : pivot.timestamp - candidate.timestamp;
+          tDuration closest_difference = closest ? (closest->timestamp > pivot.timestamp ? closest->timestamp - pivot.timestamp : pivot.timestamp - closest->timestamp) : tDuration::max();
+          if (difference <= std::chrono::milliseconds(2) && difference < closest_difference)
+          {
+            closest = &candidate;
+          }
+        }
+        if (closest)
+        {
+          set.push_back(closest->index);
+        }
+      }
+      if (set.size() == cSTREAMS - 1)
+      {
+        expected_sets.push_back(set);
+      }
+    }
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Some sets should be incomplete", expected_sets.size() > 0 && expected_sets.size() < recordings[0].size());
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("All complete sets should be found", expected_sets.size(), sets.size());
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Sets should contain closest records", expected_sets == sets);
+  }
+
+  void TestReorderBuffer()
+  {
+    struct tMessage
+    {
+      tTimestamp timestamp;
+      size_t index;
+    };
+    tTimestamp start = ParseIsoTimestamp("2014-04-04T14:14:14Z");
+    std::vector<size_t> released;
+    auto callback = [&released](const tMessage & message)
+    {
+      released.push_back(message.index);
+    };
+
+    // Messages 0-5 every 10ms - arriving in order 1, 0, 3, 2, 5, 4
+    tReorderBuffer<tMessage> buffer(16, std::chrono::milliseconds(25));
+    for (size_t i : { 1, 0, 3, 2, 5, 4 })
+    {
+      buffer.Push(tMessage { start + std::chrono::milliseconds(10 * i), i }, callback);
+    }
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Nothing should be released before watermark", static_cast<size_t>(0), buffer.Release(start + std::chrono::milliseconds(20), callback));
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Messages before watermark should be released", static_cast<size_t>(3), buffer.Release(start + std::chrono::milliseconds(45), callback));
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Messages should be released in order", released == std::vector<size_t>({ 0, 1, 2 }));
+
+    // Late message with policy DROP
+    buffer.Push(tMessage { start + std::chrono::milliseconds(15), 6 }, callback);
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Late message should be counted", static_cast<size_t>(1), buffer.GetLateCount());
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Late message should be dropped", static_cast<size_t>(3), buffer.GetSize());
+    buffer.Push(tMessage { start + std::chrono::milliseconds(50), 7 }, callback);
+    buffer.Flush(callback);
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Equal timestamps should be released in push order", released == std::vector<size_t>({ 0, 1, 2, 3, 4, 5, 7 }));
+
+    // Late message with policy RELEASE and full buffer
+    released.clear();
+    tReorderBuffer<tMessage> small_buffer(2, std::chrono::seconds(1), tLateArrivalPolicy::RELEASE);
+    for (size_t i : { 2, 1, 3, 0, 4 })
+    {
+      small_buffer.Push(tMessage { start + std::chrono::milliseconds(10 * i), i }, callback);
+    }
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Smallest message should be released if buffer is full - late message immediately", released == std::vector<size_t>({ 1, 0, 2 }));
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Late message should be counted", static_cast<size_t>(1), small_buffer.GetLateCount());
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Buffer should be full", static_cast<size_t>(2), small_buffer.GetSize());
+
+    // Producer thread with jittered timestamps (watermark follows number of pushed messages)
+    const size_t cMESSAGES = 100000;
+    released.clear();
+    tConcurrentReorderBuffer<tMessage> concurrent_buffer(1024, std::chrono::microseconds(100));
+    std::atomic<size_t> pushed(0);
+    std::thread producer([&]()
+    {
+      for (size_t i = 0; i < cMESSAGES; i++)
+      {
+        size_t shuffled = i ^ ((i / 8 * 7919) % 8);  // permutation within groups of 8
+        tMessage message { start + std::chrono::microseconds(shuffled), shuffled };
+        while (!concurrent_buffer.Push(message))
+        {
+          std::this_thread::yield();
+        }
+        pushed.store(i + 1, std::memory_order_release);
+      }
+    });
+    while (pushed.load(std::memory_order_acquire) < cMESSAGES)
+    {
+      concurrent_buffer.Release(start + std::chrono::microseconds(pushed.load(std::memory_order_acquire)), callback);
+    }
+    producer.join();
+    concurrent_buffer.Flush(callback);
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("All messages should be released", cMESSAGES, released.size());
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Messages should be released in order", std::is_sorted(released.begin(), released.end()));
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("No message should be late", static_cast<size_t>(0), concurrent_buffer.GetLateCount());
+  }
+
+  void TestLatencyHistogram()
+  {
+    // Small values are exact - larger ones within 1%
+    tLatencySnapshot exact;
+    for (int i = 0; i < 256; i++)
+    {
+      exact.Record(std::chrono::nanoseconds(i));
+    }
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Median of small values should be exact", tDuration(127), exact.GetPercentile(50));
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Maximum should be exact", tDuration(255), exact.GetPercentile(100));
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Minimum should be exact", tDuration(0), exact.GetPercentile(0));
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Largest value should be in last bucket", static_cast<size_t>(internal::cLATENCY_BUCKET_COUNT - 1), internal::LatencyBucketIndex(~static_cast<uint64_t>(0)));
+
+    tLatencySnapshot expected;
+    tLatencyHistogram histogram;
+    const size_t cTHREADS = 4, cVALUES = 100000;
+    std::vector<std::thread> threads;
+    for (size_t thread = 0; thread < cTHREADS; thread++)
+    {
+      for (size_t i = 0; i < cVALUES; i++)
+      {
+        expected.Record(std::chrono::microseconds(thread * cVALUES + i + 1));
+      }
+      threads.emplace_back([&histogram, thread]()
+      {
+        for (size_t i = 0; i < cVALUES; i++)
+        {
+          histogram.Record(std::chrono::microseconds(thread * cVALUES + i + 1));
+        }
+      });
+    }
+    histogram.Record(std::chrono::microseconds(-5));
+    expected.Record(std::chrono::microseconds(-5));
+    for (auto & thread : threads)
+    {
+      thread.join();
+    }
+    tLatencySnapshot snapshot = histogram.GetSnapshot();
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("All durations should be counted", static_cast<uint64_t>(cTHREADS * cVALUES + 1), snapshot.GetCount());
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Negative durations should be recorded as zero", tDuration::zero(), snapshot.GetMin());
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Maximum should be exact", tDuration(std::chrono::microseconds(cTHREADS * cVALUES)), snapshot.GetMax());
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Mean should be exact", expected.GetMean(), snapshot.GetMean());
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Summary should equal that of single-threaded histogram", expected.ToString(), snapshot.ToString());
+    for (double percentile : { 1.0, 25.0, 50.0, 90.0, 99.0, 99.9, 99.99 })
+    {
+      double exact_value = std::ceil(percentile / 100 * (cTHREADS * cVALUES + 1)) - 1;
+      double value = std::chrono::duration_cast<std::chrono::duration<double, std::micro>>(snapshot.GetPercentile(percentile)).count();
+      RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Percentile should be accurate within 1%", value >= exact_value && value <= exact_value * 1.01);
+    }
+
+    // Merging
+    tLatencySnapshot merged;
+    merged.Merge(exact);
+    merged.Merge(snapshot);
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Merged count should be sum", static_cast<uint64_t>(cTHREADS * cVALUES + 257), merged.GetCount());
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Merged maximum should be maximum", snapshot.GetMax(), merged.GetMax());
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Small percentiles should come from small values", tDuration(127), merged.GetPercentile(0.032));
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Summary should contain percentiles", merged.ToString().find("p99.9: ") != std::string::npos);
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Empty snapshot should return zero", tDuration::zero(), tLatencySnapshot().GetPercentile(50));
+  }
+
+  void TestScopedTrace()
+  {
+    std::ostringstream discard;
+    WriteChromeTrace(discard);  // spans of other tests
+
+    {
+      tScopedTrace outer("Outer \"cycle\"");
+      for (int i = 0; i < 3; i++)
+      {
+        tScopedTrace inner("Inner", tTraceClock::APPLICATION_TIME);
+      }
+    }
+    SetTraceBufferSize(16);
+    std::thread thread([]()
+    {
+      SetTraceThreadName("Worker");
+      for (int i = 0; i < 100; i++)
+      {
+        tScopedTrace trace("Worker cycle");
+      }
+    });
+    thread.join();
+    SetTraceBufferSize(65536);
+
+    std::ostringstream stream;
+    size_t count = WriteChromeTrace(stream);
+    std::string trace = stream.str();
+#ifndef RRLIB_TIME_DISABLE_TRACING
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Spans should be exported (only the latest spans if buffer overflows)", static_cast<size_t>(4 + 16), count);
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Names should be escaped", trace.find("{\"name\":\"Outer \\\"cycle\\\"\",\"ph\":\"X\",\"pid\":1,") != std::string::npos);
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Spans in application time should have separate process", trace.find("{\"name\":\"Inner\",\"ph\":\"X\",\"pid\":2,") != std::string::npos);
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Thread names should be exported", trace.find("\"args\":{\"name\":\"Worker\"}") != std::string::npos);
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Dropped spans should be reported", trace.find("\"dropped_spans\":\"84\"") != std::string::npos);
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Trace should be JSON object", trace.front() == '{' && trace.find("}}\n") == trace.length() - 3);
+#else
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("No spans should be recorded if tracing is disabled", static_cast<size_t>(0), count);
+#endif
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Exported spans should be removed", static_cast<size_t>(0), WriteChromeTrace(discard));
+  }
+
+  void TestCycleCounter()
+  {
+    tCycleCapture capture(1000);
+    tTimestamp start = tBaseClock::now();
+    capture.Start();
+    for (int i = 0; i < 2000; i++)
+    {
+      capture.Capture();
+      if (i % 100 == 0)
+      {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    }
+    capture.Stop();
+    tTimestamp end = tBaseClock::now();
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Capture should stop when buffer is full", static_cast<size_t>(1000), capture.GetSize());
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Frequency should be determined", capture.GetCalibration().GetFrequency() > 1e6);
+    std::vector<tTimestamp> timestamps = capture.GetTimestamps();
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Timestamps should be sorted", std::is_sorted(timestamps.begin(), timestamps.end()));
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Timestamps should be within capture", timestamps.front() > start - std::chrono::microseconds(100) && timestamps.back() < end + std::chrono::microseconds(100));
+    tDuration sleeps = timestamps[901] - timestamps[1];
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Durations should be converted", sleeps >= std::chrono::milliseconds(9) && sleeps < std::chrono::milliseconds(500));
+
+    // Batch conversion should be identical to scalar one (also before start of capture)
+    const tCycleCalibration& calibration = capture.GetCalibration();
+    std::vector<uint64_t> cycles;
+    uint64_t random = 12345;
+    for (int i = 0; i < 1003; i++)
+    {
+      random = random * 6364136223846793005ULL + 1442695040888963407ULL;
+      cycles.push_back(capture.GetCycles()[0] + (random >> (20 + i % 30)) - (i % 3 == 0 ? (random >> (16 + i % 30)) : 0));
+    }
+    std::vector<tTimestamp> converted(cycles.size());
+    calibration.ToTimestamps(cycles.data(), cycles.size(), converted.data());
+    bool identical = true;
+    for (size_t i = 0; i < cycles.size(); i++)
+    {
+      identical &= converted[i] == calibration.ToTimestamp(cycles[i]);
+    }
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Batch conversion should be identical to scalar conversion", identical);
+    int64_t frequency = static_cast<int64_t>(calibration.GetFrequency());
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Duration of 'frequency' cycles should be one second", std::abs((calibration.ToDuration(frequency) - std::chrono::seconds(1)).count()) < 1000);
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Negative durations should be converted", -calibration.ToDuration(frequency), calibration.ToDuration(-frequency));
+  }
+
+  void TestRateMeter()
+  {
+    tTimestamp start = ParseIsoTimestamp("2014-04-04T14:14:14Z");
+    tRateMeter meter(std::chrono::seconds(1), start);
+    meter.Increment(100);
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("First rate should be average", 100.0, meter.GetRate(start + std::chrono::seconds(1)));
+    meter.Increment(200);
+    double expected = 100 * std::exp(-1.0) + 200 * (1 - std::exp(-1.0));
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Rate should be EWMA", std::abs(meter.GetRate(start + std::chrono::seconds(2)) - expected) < 1e-9);
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Rate should not change if time does not advance", std::abs(meter.GetRate(start + std::chrono::seconds(2)) - expected) < 1e-9);
+
+    // Constant rate of 50 events per second - read at irregular intervals
+    tTimestamp time = start + std::chrono::seconds(2);
+    for (int i = 0; i < 300; i++)
+    {
+      tDuration interval = std::chrono::milliseconds(20 * (1 + i % 7));
+      time += interval;
+      meter.Increment(std::chrono::duration_cast<std::chrono::milliseconds>(interval).count() / 20);
+      meter.GetRate(time);
+    }
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Rate should converge", std::abs(meter.GetRate(time) - 50) < 0.01);
+    meter.Increment(1000);
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Rate should be kept if time jumps back", std::abs(meter.GetRate(start) - 50) < 0.01);
+    meter.Reset(time);
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Rate should be zero after reset", 0.0, meter.GetRate(time));
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Count should be kept after reset", static_cast<uint64_t>(100 + 200 + 1197 + 1000), meter.GetCount());
+
+    // Concurrent counting
+    tRateMeter concurrent_meter;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++)
+    {
+      threads.emplace_back([&concurrent_meter]()
+      {
+        for (int j = 0; j < 100000; j++)
+        {
+          concurrent_meter.Increment();
+          if (j % 1000 == 0)
+          {
+            concurrent_meter.GetRate();
+          }
+        }
+      });
+    }
+    for (auto & thread : threads)
+    {
+      thread.join();
+    }
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("All events should be counted", static_cast<uint64_t>(400000), concurrent_meter.GetCount());
+  }
+
+  void TestTokenBucket()
+  {
+    tTimestamp start = ParseIsoTimestamp("2014-04-04T14:14:14Z");
+    tTokenBucket bucket(10, 5, true, start);
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Bucket should be full", 5.0, bucket.GetAvailableTokens(start));
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Multiple tokens should be acquired", bucket.TryAcquire(3, start));
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Tokens should not be acquired if too few are available", !bucket.TryAcquire(3, start));
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Remaining tokens should be acquired", bucket.TryAcquire(2, start));
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Time until available should be refill interval", tDuration(std::chrono::milliseconds(100)), bucket.GetTimeUntilAvailable(1, start));
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Time until available should be computed for multiple tokens", tDuration(std::chrono::milliseconds(250)), bucket.GetTimeUntilAvailable(3, start + std::chrono::milliseconds(50)));
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Tokens exceeding capacity are never available", tDuration::max(), bucket.GetTimeUntilAvailable(6, start));
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Tokens exceeding capacity should not be acquired", !bucket.TryAcquire(6, start + std::chrono::seconds(10)));
+    for (uint64_t tokens : { static_cast<uint64_t>(1) << 62, std::numeric_limits<uint64_t>::max() })  // cost would overflow
+    {
+      RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Huge token counts are never available", tDuration::max(), bucket.GetTimeUntilAvailable(tokens, start));
+      RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Huge token counts should not be acquired", !bucket.TryAcquire(tokens, start + std::chrono::seconds(10)));
+    }
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Token should not be available before refill", !bucket.TryAcquire(1, start + std::chrono::milliseconds(99)));
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Token should be available after refill", bucket.TryAcquire(1, start + std::chrono::milliseconds(100)));
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Refill should be limited by capacity", 5.0, bucket.GetAvailableTokens(start + std::chrono::seconds(10)));
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Time until available should be zero if tokens are available", tDuration::zero(), bucket.GetTimeUntilAvailable(5, start + std::chrono::seconds(10)));
+
+    tTokenBucket empty_bucket(1000, 100, false, start);
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Bucket should be empty", 0.0, empty_bucket.GetAvailableTokens(start));
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Capacity should be stored", static_cast<uint64_t>(100), empty_bucket.GetCapacity());
+
+    // Concurrent acquisition: exactly the refilled tokens are acquired
+    std::atomic<size_t> acquired(0);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++)
+    {
+      threads.emplace_back([&]()
+      {
+        for (int j = 0; j < 10000; j++)
+        {
+          if (empty_bucket.TryAcquire(1, start + std::chrono::microseconds(j * 10)))
+          {
+            acquired++;
+          }
+        }
+      });
+    }
+    for (auto & thread : threads)
+    {
+      thread.join();
+    }
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Refilled tokens should be acquired exactly once", static_cast<size_t>(99), acquired.load());
+  }
+
+  class tTestClock : public tCustomClock
+  {
+  public:
+    void Set(const tTimestamp& time)
+    {
+      SetApplicationTime(time);
+    }
+  };
+
+  /*! Waits (up to 5 seconds of system time) until counter has reached value */
+  static void WaitForCount(const std::atomic<size_t>& counter, size_t value)
+  {
+    for (int i = 0; i < 5000 && counter.load() < value; i++)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+
+  void TestWatchdog()
+  {
+    tTimestamp start = ParseIsoTimestamp("2014-04-04T14:14:14Z");
+    tTestClock clock;
+    SetTimeSource(&clock, start);
+    {
+      tWatchdog watchdog(std::chrono::milliseconds(1));
+      std::atomic<size_t> missed(0), heartbeat_missed(0), disabled_missed(0);
+      tTimestamp missed_deadline;
+      tWatchdog::tHandle handle = watchdog.Register([&](const tTimestamp & deadline)
+      {
+        missed_deadline = deadline;
+        missed++;
+      }, start + std::chrono::milliseconds(10));
+      tWatchdog::tHandle heartbeat_handle = watchdog.Register([&](const tTimestamp&)
+      {
+        heartbeat_missed++;
+      });
+      tWatchdog::tHandle disabled_handle = watchdog.Register([&](const tTimestamp&)
+      {
+        disabled_missed++;
+      });
+      RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Entries should be registered", static_cast<size_t>(3), watchdog.GetEntryCount());
+      heartbeat_handle.Heartbeat(std::chrono::milliseconds(30));
+      RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Heartbeat should set deadline relative to application time", start + std::chrono::milliseconds(30), heartbeat_handle.GetDeadline());
+
+      clock.Set(start + std::chrono::milliseconds(20));
+      WaitForCount(missed, 1);
+      RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Missed deadline should be reported once", static_cast<size_t>(1), missed.load());
+      RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Missed deadline should be passed to callback", start + std::chrono::milliseconds(10), missed_deadline);
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Missed deadline should not be reported again", static_cast<size_t>(1), missed.load());
+      RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Entry with heartbeat should not be reported", static_cast<size_t>(0), heartbeat_missed.load());
+      RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Disabled entry should not be reported", static_cast<size_t>(0), disabled_missed.load());
+
+      heartbeat_handle.SetDeadline(cNO_TIME);
+      handle.SetDeadline(start + std::chrono::milliseconds(40));
+      clock.Set(start + std::chrono::milliseconds(50));
+      WaitForCount(missed, 2);
+      RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("New deadline should be reported", static_cast<size_t>(2), missed.load());
+      RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Disabled heartbeat should not be reported", static_cast<size_t>(0), heartbeat_missed.load());
+
+      handle.SetDeadline(start + std::chrono::milliseconds(60));
+      handle.Unregister();
+      clock.Set(start + std::chrono::milliseconds(70));
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Unregistered entry should not be reported", static_cast<size_t>(2), missed.load());
+      RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Entry should be unregistered", static_cast<size_t>(2), watchdog.GetEntryCount());
+
+      // Many entries (half of them with heartbeats)
+      std::atomic<size_t> many_missed(0);
+      std::vector<tWatchdog::tHandle> handles;
+      for (size_t i = 0; i < 100000; i++)
+      {
+        handles.push_back(watchdog.Register([&](const tTimestamp&)
+        {
+          many_missed++;
+        }, start + std::chrono::milliseconds(100)));
+      }
+      RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Entries should be registered", static_cast<size_t>(100002), watchdog.GetEntryCount());
+      for (size_t i = 0; i < handles.size(); i += 2)
+      {
+        handles[i].SetDeadline(start + std::chrono::seconds(1));
+      }
+      clock.Set(start + std::chrono::milliseconds(200));
+      WaitForCount(many_missed, 50000);
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Entries without heartbeat should be reported", static_cast<size_t>(50000), many_missed.load());
+      handles.clear();
+      RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Entries should be unregistered", static_cast<size_t>(2), watchdog.GetEntryCount());
+
+      // Entries that expire at the same time and unregister each other in their callbacks
+      std::atomic<size_t> mutual_missed(0);
+      tWatchdog::tHandle mutual_handles[2];
+      for (size_t i = 0; i < 2; i++)
+      {
+        mutual_handles[i] = watchdog.Register([&, i](const tTimestamp&)
+        {
+          mutual_handles[1 - i].Unregister();
+          mutual_missed++;
+        }, start + std::chrono::milliseconds(300));
+      }
+      clock.Set(start + std::chrono::milliseconds(400));
+      WaitForCount(mutual_missed, 1);
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Callback of entry unregistered by another callback should not be called", static_cast<size_t>(1), mutual_missed.load());
+      RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Entry should be unregistered", static_cast<size_t>(3), watchdog.GetEntryCount());
+    }
+    SetTimeSource(nullptr, tTimestamp());
+  }
+
+  void TestTimeRecording()
+  {
+    tTemporaryFile temporary_file;
+    const std::string& file_name = temporary_file.name;
+    tTimestamp custom_start = ParseIsoTimestamp("2014-04-04T14:14:14Z");
+    std::vector<tTimestamp> now_results;
+    uint64_t event_count = 0;
+    {
+      tTimeRecorder recorder(file_name, std::chrono::milliseconds(1));
+      bool second_recorder_failed = false;
+      try
+      {
+        tTimeRecorder second_recorder(file_name + ".2");
+      }
+      catch (const std::runtime_error&)
+      {
+        second_recorder_failed = true;
+      }
+      RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Only one recorder should exist", second_recorder_failed);
+
+      for (int i = 0; i < 10; i++)
+      {
+        now_results.push_back(Now());
+      }
+      SetTimeStretching(2, 1);
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+      now_results.push_back(Now());
+      SetTimeStretching(1, 1);
+      tTestClock clock;
+      SetTimeSource(&clock, custom_start);
+      now_results.push_back(Now());
+      clock.Set(custom_start + std::chrono::seconds(1));
+      now_results.push_back(Now());
+      SetTimeSource(nullptr, tTimestamp());
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      std::thread thread([]()
+      {
+        for (int i = 0; i < 10000; i++)
+        {
+          Now();
+        }
+      });
+      thread.join();
+      now_results.push_back(Now());
+      recorder.Close();
+      event_count = recorder.GetEventCount();
+      RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("No events should be dropped", static_cast<uint64_t>(0), recorder.GetDroppedEventCount());
+    }
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("All events should be written", static_cast<uint64_t>(1 + 14 + 2 + 2 + 1 + 10000), event_count);
+
+    // Read recording
+    tTimeRecordingReader reader(file_name);
+    tTimeEvent event;
+    std::vector<tTimeEvent> events;
+    while (reader.Next(event))
+    {
+      events.push_back(event);
+    }
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("All events should be read", static_cast<size_t>(event_count), events.size());
+    size_t stretching_events = 0, source_events = 0, clock_events = 0;
+    for (size_t i = 0; i < events.size(); i++)
+    {
+      RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Events should be ordered by system time", i == 0 || events[i - 1].system_time <= events[i].system_time);
+      if (events[i].type == tTimeEventType::TIME_STRETCHING)
+      {
+        RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Time stretching factor should be recorded", stretching_events == 0 ? 2u : 1u, events[i].numerator);
+        RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Time stretching factor should be recorded", 1u, events[i].denominator);
+        stretching_events++;
+      }
+      else if (events[i].type == tTimeEventType::TIME_SOURCE)
+      {
+        RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Time source should be recorded", source_events == 0, events[i].custom_clock);
+        source_events++;
+      }
+      else if (events[i].type == tTimeEventType::APPLICATION_TIME)
+      {
+        RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Application time should be recorded", custom_start + std::chrono::seconds(1), events[i].application_time);
+        clock_events++;
+      }
+    }
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Time stretching should be recorded", static_cast<size_t>(2), stretching_events);
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Time source should be recorded", static_cast<size_t>(2), source_events);
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Custom clock should be recorded", static_cast<size_t>(1), clock_events);
+    for (const tTimestamp & result : now_results)
+    {
+      bool found = false;
+      for (const tTimeEvent & e : events)
+      {
+        found |= e.type == tTimeEventType::NOW && e.application_time == result;
+      }
+      RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Results of Now() should be recorded", found);
+    }
+
+    // Replay as fast as possible: Now() returns recorded values
+    {
+      tReplayClock replay_clock(file_name, tReplayPace::AS_FAST_AS_POSSIBLE);
+      size_t mismatches = 0;
+      size_t replayed = replay_clock.Replay([&](const tTimeEvent & e)
+      {
+        if (e.type == tTimeEventType::NOW && Now() != e.application_time)
+        {
+          mismatches++;
+        }
+      });
+      RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("All events should be replayed", static_cast<size_t>(event_count), replayed);
+      RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Now() should return recorded values", static_cast<size_t>(0), mismatches);
+      RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Replay clock should be time source", GetTimeMode() == tTimeMode::CUSTOM_CLOCK);
+    }
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Time source should be reset", GetTimeMode() == tTimeMode::STRETCHED_SYSTEM_TIME);
+
+    // Replay at recorded pace
+    {
+      tReplayClock replay_clock(file_name, tReplayPace::RECORDED);
+      tTimestamp start = tBaseClock::now();
+      replay_clock.Replay();
+      RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Replay should take recorded time", tBaseClock::now() - start >= events.back().system_time - events.front().system_time);
+    }
+  }
+
+  void TestVirtualClock()
+  {
+    tTimestamp start = ParseIsoTimestamp("2014-04-04T14:14:14Z");
+    tTimestamp system_start = tBaseClock::now();
+    {
+      tVirtualClock clock(start);
+      RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Clock should be time source", start, Now());
+
+      // Without workers, time advances immediately
+      clock.SleepFor(std::chrono::hours(1));
+      RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Time should advance by sleep duration", start + std::chrono::hours(1), Now());
+
+      // Two workers with different periods: wake-ups occur at exact multiples of periods - in order
+      tTimestamp begin = clock.GetTime();
+      std::mutex wake_ups_mutex;
+      std::vector<std::pair<tTimestamp, int>> wake_ups;
+      std::atomic<int> started(0);
+      auto periodic_worker = [&](int id, tDuration period, int cycles)
+      {
+        tVirtualClock::tWorker worker(clock);
+        started++;
+        for (int i = 0; i < cycles; i++)
+        {
+          clock.SleepFor(period);
+          std::lock_guard<std::mutex> lock(wake_ups_mutex);
+          wake_ups.emplace_back(Now(), id);
+        }
+      };
+      std::unique_ptr<tVirtualClock::tWorker> starter(new tVirtualClock::tWorker(clock));  // time must not advance before both workers are registered
+      std::thread thread1(periodic_worker, 1, std::chrono::milliseconds(10), 100);
+      std::thread thread2(periodic_worker, 2, std::chrono::milliseconds(25), 40);
+      while (started < 2)
+      {
+        std::this_thread::yield();
+      }
+      starter.reset();
+      thread1.join();
+      thread2.join();
+      RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("All cycles should be executed", static_cast<size_t>(140), wake_ups.size());
+      size_t count1 = 0, count2 = 0;
+      for (size_t i = 0; i < wake_ups.size(); i++)
+      {
+        size_t& count = wake_ups[i].second == 1 ? count1 : count2;
+        count++;
+        tDuration period = wake_ups[i].second == 1 ? std::chrono::milliseconds(10) : std::chrono::milliseconds(25);
+        RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Worker should wake up at exact time", begin + period * count, wake_ups[i].first);
+        RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Wake-ups should be ordered by time", i == 0 || wake_ups[i - 1].first <= wake_ups[i].first);
+      }
+      RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Time should advance to last wake-up", begin + std::chrono::seconds(1), clock.GetTime());
+
+      // Waiting for predicate
+      begin = clock.GetTime();
+      bool flag = false;
+      bool consumer_result = false, timeout_result = true;
+      tTimestamp consumer_time, timeout_time;
+      started = 0;
+      starter.reset(new tVirtualClock::tWorker(clock));
+      std::thread producer([&]()
+      {
+        tVirtualClock::tWorker worker(clock);
+        started++;
+        clock.SleepFor(std::chrono::milliseconds(50));
+        {
+          std::lock_guard<std::mutex> lock(wake_ups_mutex);
+          flag = true;
+        }
+        clock.Notify();
+      });
+      std::thread consumer([&]()
+      {
+        tVirtualClock::tWorker worker(clock);
+        started++;
+        timeout_result = clock.WaitUntil(begin + std::chrono::milliseconds(10), []() { return false; });
+        timeout_time = Now();
+        consumer_result = clock.WaitUntil(cNO_TIME, [&]()
+        {
+          std::lock_guard<std::mutex> lock(wake_ups_mutex);
+          return flag;
+        });
+        consumer_time = Now();
+      });
+      while (started < 2)
+      {
+        std::this_thread::yield();
+      }
+      starter.reset();
+      producer.join();
+      consumer.join();
+      RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Wait should time out", !timeout_result);
+      RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Wait should time out at deadline", begin + std::chrono::milliseconds(10), timeout_time);
+      RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Predicate should become true", consumer_result);
+      RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Notification should occur at producer's wake-up time", begin + std::chrono::milliseconds(50), consumer_time);
+
+      // Running worker prevents time from advancing
+      begin = clock.GetTime();
+      std::atomic<bool> sleeper_woke_up(false);
+      bool woke_up_while_running = true;
+      started = 0;
+      starter.reset(new tVirtualClock::tWorker(clock));
+      std::thread busy([&]()
+      {
+        tVirtualClock::tWorker worker(clock);
+        started++;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));  // e.g. computing
+        woke_up_while_running = sleeper_woke_up;
+        clock.SleepFor(std::chrono::seconds(2));
+      });
+      std::thread sleeper([&]()
+      {
+        tVirtualClock::tWorker worker(clock);
+        started++;
+        clock.SleepFor(std::chrono::seconds(1));
+        sleeper_woke_up = true;
+      });
+      while (started < 2)
+      {
+        std::this_thread::yield();
+      }
+      starter.reset();
+      busy.join();
+      sleeper.join();
+      RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Time should not advance while a worker is running", !woke_up_while_running);
+      RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Time should advance when all workers are blocked", begin + std::chrono::seconds(2), clock.GetTime());
+    }
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Time source should be reset", GetTimeMode() == tTimeMode::STRETCHED_SYSTEM_TIME);
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Simulated time should pass faster than system time", tBaseClock::now() - system_start < std::chrono::seconds(1));
+  }
+
+  void TestMonotonicTime()
+  {
+    // Stretched system time
+    tMonotonicTimestamp start = NowMonotonic();
+    tTimestamp start_wall_clock = Now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    tDuration elapsed = GetElapsedTime(start);
+    tDuration elapsed_wall_clock = Now() - start_wall_clock;
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Elapsed time should be measured", elapsed >= std::chrono::milliseconds(20));
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Elapsed time should match Now()", elapsed - elapsed_wall_clock < std::chrono::milliseconds(5) && elapsed_wall_clock - elapsed < std::chrono::milliseconds(5));
+
+    SetTimeStretching(2, 1);
+    start = NowMonotonic();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    elapsed = GetElapsedTime(start);
+    SetTimeStretching(1, 1);
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Time stretching should be applied", elapsed >= std::chrono::milliseconds(40));
+
+    tTimestamp system_start = tBaseClock::now();
+    SleepFor(std::chrono::milliseconds(30));
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Sleep should last specified duration", tBaseClock::now() - system_start >= std::chrono::milliseconds(30));
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Sleep should end at wake-up time", GetElapsedTime(start) >= std::chrono::milliseconds(30));
+
+    // Changing time stretching factor does not make monotonic time jump
+    start = NowMonotonic();
+    SetTimeStretching(3, 1);
+    elapsed = GetElapsedTime(start);
+    SetTimeStretching(1, 1);
+    tDuration elapsed_total = GetElapsedTime(start);
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Monotonic time should be continuous when time stretching is changed", elapsed >= tDuration::zero() && elapsed < std::chrono::milliseconds(5));
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Monotonic time should be continuous when time stretching is changed", elapsed_total >= elapsed && elapsed_total < std::chrono::milliseconds(10));
+
+    // Custom clock (monotonic time is continuous when time source is changed)
+    tTimestamp custom_start = ParseIsoTimestamp("2014-04-04T14:14:14Z");
+    tTestClock clock;
+    tMonotonicTimestamp before_switch = NowMonotonic();
+    SetTimeSource(&clock, custom_start);
+    start = NowMonotonic();
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Monotonic time should be continuous when custom clock is set", start >= before_switch && start - before_switch < std::chrono::milliseconds(5));
+    std::thread thread([&]()
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      clock.Set(custom_start + std::chrono::seconds(2));
+    });
+    SleepFor(std::chrono::milliseconds(1500));
+    thread.join();
+    RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Sleep should follow custom clock", tDuration(std::chrono::seconds(2)), GetElapsedTime(start));
+    tMonotonicTimestamp custom_end = NowMonotonic();
+    SetTimeSource(nullptr, tTimestamp());
+    elapsed = GetElapsedTime(custom_end);
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Monotonic time should be continuous when custom clock is reset", elapsed >= tDuration::zero() && elapsed < std::chrono::milliseconds(5));
+    system_start = tBaseClock::now();
+    SleepFor(std::chrono::milliseconds(10));
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Sleep should work after custom clock is reset", tBaseClock::now() - system_start >= std::chrono::milliseconds(10) && tBaseClock::now() - system_start < std::chrono::seconds(1));
+
+    // Workers of virtual clock sleep in the clock (otherwise, virtual time would not advance)
+    system_start = tBaseClock::now();
+    {
+      tVirtualClock virtual_clock(custom_start);
+      std::thread worker_thread([&]()
+      {
+        tVirtualClock::tWorker worker(virtual_clock);
+        SleepFor(std::chrono::hours(1));
+      });
+      worker_thread.join();
+      RRLIB_UNIT_TESTS_EQUALITY_MESSAGE("Virtual time should advance by sleep duration", custom_start + std::chrono::hours(1), virtual_clock.GetTime());
+    }
+    RRLIB_UNIT_TESTS_ASSERT_MESSAGE("Sleep in virtual time should not take system time", tBaseClock::now() - system_start < std::chrono::seconds(1));
+  }
 };
 
 RRLIB_UNIT_TESTS_REGISTER_SUITE(TestTime);
@@ -34,12 +34,15 @@
 //----------------------------------------------------------------------
 #include <mutex>
 #include <atomic>
+#include <thread>
 
 #if __linux__
 #include <time.h>
 #endif
 
+#include <algorithm>
 #include <cstring>
+#include <limits>
 #include <sstream>
 #include <stdexcept>
 
@@ -49,6 +52,11 @@
 #include "rrlib/time/tTimeStretchingListener.h"
 #include "rrlib/time/tCustomClock.h"
 #include "rrlib/time/tAtomicTimestamp.h"
+#include "rrlib/time/calendar.h"
+#include "rrlib/time/tIsoTimestampFormatter.h"
+#include "rrlib/time/rounding.h"
+#include "rrlib/time/formatting.h"
+#include "rrlib/time/tTimeRecorder.h"
 
 //----------------------------------------------------------------------
 // Debugging
@@ -107,33 +115,67 @@ union tParameterStoreHelper
 static_assert(sizeof(tParameterStoreHelper) == 16, "?!");
 
 /*! Parameter storage - two buffers to avoid live-locks */
-static std::atomic<uint64_t> time_stretching_parameters1(1LL << 32);
-static std::atomic<uint64_t> time_stretching_parameters2(1LL << 32);
-static std::atomic<uint64_t> time_stretching_parameters1_copy(1LL << 32);
-static std::atomic<uint64_t> time_stretching_parameters2_copy(1LL << 32);
-static const tTimestamp application_start = Now();
+struct tParameterStorage
+{
+  std::atomic<uint64_t> parameters1, parameters2, parameters1_copy, parameters2_copy;
+
+  constexpr tParameterStorage() : parameters1(1LL << 32), parameters2(1LL << 32), parameters1_copy(1LL << 32), parameters2_copy(1LL << 32) {}
+};
+
+/*!
+ * Parameters for system time - and for monotonic time (see NowMonotonic()).
+ * Monotonic parameters have the same time scaling factor - but their own time_diff, so that setting system time
+ * does not affect monotonic time - and so that monotonic time continues when switching back from a custom clock.
+ */
+static tParameterStorage time_stretching_parameters, monotonic_time_stretching_parameters;
+
+/*!
+ * \return Point in time that time stretching refers to (program start)
+ * (initialized on first use - so that it does not depend on the order of static initialization)
+ */
+static const tTimestamp& ApplicationStart()
+{
+  static const tTimestamp application_start = tBaseClock::now();
+  return application_start;
+}
+
+/*!
+ * \return Point in monotonic time that time stretching refers to (see ApplicationStart())
+ */
+static const tMonotonicTimestamp& MonotonicApplicationStart()
+{
+  static const tMonotonicTimestamp application_start = tMonotonicClock::now();
+  return application_start;
+}
 
 /*! Current time - in non-linear clock mode */
 static tAtomicTimestamp current_time;
 
+/*!
+ * Current monotonic time - in non-linear clock mode (time since epoch of tMonotonicClock stored in tTimestamp) -
+ * and offset to current_time (so that monotonic time is continuous when time source is changed; only accessed with time mutex locked)
+ */
+static tAtomicTimestamp current_monotonic_time;
+static tDuration custom_clock_monotonic_offset;
+
 /*! Current time source */
 static const tCustomClock* current_clock = NULL;
 
 /*! Load time stretching parameters from two valid atomic variables */
-static void LoadParameters(tTimeStretchingParameters& params)
+static void LoadParameters(tTimeStretchingParameters& params, const tParameterStorage& storage = time_stretching_parameters)
 {
   // (Live-)Lock-free loading of parameters
   tParameterStoreHelper helper;
   while (true)
   {
-    helper.longs[0] = time_stretching_parameters1.load();
-    helper.longs[1] = time_stretching_parameters2.load(std::memory_order_relaxed);
+    helper.longs[0] = storage.parameters1.load();
+    helper.longs[1] = storage.parameters2.load(std::memory_order_relaxed);
     if (helper.GetStamp() != -1)
     {
       break;
     }
-    helper.longs[0] = time_stretching_parameters1_copy.load();
-    helper.longs[1] = time_stretching_parameters2_copy.load();
+    helper.longs[0] = storage.parameters1_copy.load();
+    helper.longs[1] = storage.parameters2_copy.load();
     if (helper.GetStamp() != -1)
     {
       break;
@@ -146,21 +188,37 @@ static void LoadParameters(tTimeStretchingParameters& params)
 }
 
 /*! Store time stretching parameters to atomic variables */
-static void StoreParameters(const tTimeStretchingParameters& params)
+static void StoreParameters(const tTimeStretchingParameters& params, tParameterStorage& storage = time_stretching_parameters)
 {
   static int64_t counter = 0;
   tParameterStoreHelper helper;
   counter = (counter + 1) & cSTAMP_MASK;
   int64_t diff = params.time_diff.count();
-  helper.longs[0] = (counter << 52) | (static_cast<int64_t>(params.time_scaling_numerator) << 32) | (diff >> 32);
+  helper.longs[0] = (counter << 52) | (static_cast<int64_t>(params.time_scaling_numerator) << 32) | ((diff >> 32) & 0xFFFFFFFFLL);
   helper.longs[1] = (counter << 52) | (static_cast<int64_t>(params.time_scaling_denominator) << 32) | (diff & 0xFFFFFFFFLL);
-  time_stretching_parameters1.store(helper.longs[0]);
-  time_stretching_parameters2.store(helper.longs[1]);
-  time_stretching_parameters1_copy.store(helper.longs[0]);
-  time_stretching_parameters2_copy.store(helper.longs[1]);
+  storage.parameters1.store(helper.longs[0]);
+  storage.parameters2.store(helper.longs[1]);
+  storage.parameters1_copy.store(helper.longs[0]);
+  storage.parameters2_copy.store(helper.longs[1]);
 }
 
 
+/*!
+ * \param elapsed Time elapsed since application start (system time)
+ * \param storage Parameters to use
+ * \return Time elapsed since application start in "application time" (with time stretching applied)
+ */
+static inline tDuration StretchElapsedTime(const tDuration& elapsed, const tParameterStorage& storage)
+{
+  tTimeStretchingParameters params;
+  LoadParameters(params, storage);
+  std::chrono::nanoseconds tmp(elapsed - params.time_diff);
+  auto ticks = tmp.count();
+  ticks /= params.time_scaling_denominator; // we have nano-seconds here - so loss of precision is neglible even with denominators of 1 million - with multiplication first, there might be overflows (if our application runs for decades...)
+  ticks *= params.time_scaling_numerator;
+  return tDuration(ticks);
+}
+
 static tTimestamp ToApplicationTime(const tTimestamp& system_time)
 {
   switch (GetTimeMode())
@@ -170,21 +228,88 @@ static tTimestamp ToApplicationTime(const tTimestamp& system_time)
   case tTimeMode::CUSTOM_CLOCK:
     return current_time.Load();
   case tTimeMode::STRETCHED_SYSTEM_TIME:
-    tTimeStretchingParameters params;
-    LoadParameters(params);
-    std::chrono::nanoseconds tmp((system_time - application_start) - params.time_diff);
-    auto ticks = tmp.count();
-    ticks /= params.time_scaling_denominator; // we have nano-seconds here - so loss of precision is neglible even with denominators of 1 million - with multiplication first, there might be overflows (if our application runs for decades...)
-    ticks *= params.time_scaling_numerator;
-    return application_start + tDuration(ticks);
+    const tTimestamp& application_start = ApplicationStart();
+    return application_start + StretchElapsedTime(system_time - application_start, time_stretching_parameters);
   }
   return tTimestamp();
 }
 
+static tMonotonicTimestamp ToMonotonicApplicationTime(const tMonotonicTimestamp& monotonic_time)
+{
+  switch (GetTimeMode())
+  {
+  case tTimeMode::SYSTEM_TIME:
+    return monotonic_time;
+  case tTimeMode::CUSTOM_CLOCK:
+    return tMonotonicTimestamp(current_monotonic_time.Load().time_since_epoch());
+  case tTimeMode::STRETCHED_SYSTEM_TIME:
+    const tMonotonicTimestamp& application_start = MonotonicApplicationStart();
+    return application_start + StretchElapsedTime(monotonic_time - application_start, monotonic_time_stretching_parameters);
+  }
+  return tMonotonicTimestamp();
+}
+
+/*!
+ * Stores time stretching parameters for monotonic time - so that monotonic application time continues from its current value
+ * (time mutex must be locked)
+ *
+ * \param numerator Numerator of new time stretching factor
+ * \param denominator Denominator of new time stretching factor
+ * \param monotonic_time Current monotonic system time
+ * \param app_time Monotonic application time at this point in time
+ */
+static void StoreMonotonicParameters(unsigned int numerator, unsigned int denominator, const tMonotonicTimestamp& monotonic_time, const tMonotonicTimestamp& app_time)
+{
+  // Inverse of StretchElapsedTime() (divide first to avoid overflows)
+  const tMonotonicTimestamp& application_start = MonotonicApplicationStart();
+  int64_t app_elapsed = (app_time - application_start).count();
+  int64_t elapsed = app_elapsed / numerator * denominator + (app_elapsed % numerator) * denominator / numerator;
+  tTimeStretchingParameters params;
+  params.time_scaling_numerator = numerator;
+  params.time_scaling_denominator = denominator;
+  params.time_diff = (monotonic_time - application_start) - tDuration(elapsed);
+  StoreParameters(params, monotonic_time_stretching_parameters);
+}
+
 tTimestamp Now(bool precise)
 {
   // TODO: implement optimized retrieval of low precision time should this become a performance issue
-  return ToApplicationTime(tBaseClock::now());
+  tTimestamp system_time = tBaseClock::now();
+  tTimestamp result = ToApplicationTime(system_time);
+  if (internal::time_recording_active.load(std::memory_order_relaxed))
+  {
+    internal::RecordTimeEvent(tTimeEvent { tTimeEventType::NOW, system_time, result, 0, 0, false });
+  }
+  return result;
+}
+
+tMonotonicTimestamp NowMonotonic(bool)
+{
+  return ToMonotonicApplicationTime(tMonotonicClock::now());
+}
+
+void SleepUntil(const tMonotonicTimestamp& wake_up_time)
+{
+  while (true)
+  {
+    tDuration remaining = wake_up_time - NowMonotonic();
+    if (remaining <= tDuration::zero())
+    {
+      return;
+    }
+    const tCustomClock* clock = GetTimeMode() == tTimeMode::CUSTOM_CLOCK ? current_clock : NULL;
+    if (clock)
+    {
+      clock->BlockUntil(Now() + remaining);
+      continue;
+    }
+    tDuration sleep_duration = ToSystemDuration(remaining);
+    if (GetTimeMode() != tTimeMode::SYSTEM_TIME)
+    {
+      sleep_duration = std::min<tDuration>(sleep_duration, std::chrono::milliseconds(10));  // time stretching or custom clock may change while sleeping
+    }
+    std::this_thread::sleep_for(sleep_duration);
+  }
 }
 
 tTimeMode GetTimeMode()
@@ -197,10 +322,18 @@ void SetTimeSource(const tCustomClock* clock, const tTimestamp& initial_time)
   try
   {
     std::lock_guard<std::mutex> lock(internal::tTimeMutex::Instance());
+    if (internal::time_recording_active.load(std::memory_order_relaxed))
+    {
+      internal::RecordTimeEvent(tTimeEvent { tTimeEventType::TIME_SOURCE, tBaseClock::now(), initial_time, 0, 0, clock != NULL });
+    }
+    tMonotonicTimestamp monotonic_time = tMonotonicClock::now();
+    tMonotonicTimestamp monotonic_app_time = ToMonotonicApplicationTime(monotonic_time);
     if (clock)
     {
       current_clock = clock;
       current_time.Store(initial_time);
+      custom_clock_monotonic_offset = monotonic_app_time.time_since_epoch() - initial_time.time_since_epoch();
+      current_monotonic_time.Store(tTimestamp(monotonic_app_time.time_since_epoch()));
       if (mode.load() != (int)tTimeMode::CUSTOM_CLOCK)
       {
         mode.store((int)tTimeMode::CUSTOM_CLOCK);
@@ -212,6 +345,9 @@ void SetTimeSource(const tCustomClock* clock, const tTimestamp& initial_time)
     {
       if (mode.load() != (int)tTimeMode::STRETCHED_SYSTEM_TIME)
       {
+        tTimeStretchingParameters params;
+        LoadParameters(params);
+        StoreMonotonicParameters(params.time_scaling_numerator, params.time_scaling_denominator, monotonic_time, monotonic_app_time);
         mode.store((int)tTimeMode::STRETCHED_SYSTEM_TIME);
         tTimeStretchingListener::NotifyListeners(tTimeMode::STRETCHED_SYSTEM_TIME);
       }
@@ -237,6 +373,11 @@ void SetTimeStretching(unsigned int numerator, unsigned int denominator)
     assert(denominator != 0);
     tTimeStretchingParameters params;
     LoadParameters(params);
+    if (internal::time_recording_active.load(std::memory_order_relaxed))
+    {
+      tTimestamp system_time = tBaseClock::now();
+      internal::RecordTimeEvent(tTimeEvent { tTimeEventType::TIME_STRETCHING, system_time, ToApplicationTime(system_time), numerator, denominator, false });
+    }
     double new_factor = ((double)numerator) / ((double)denominator);
     double old_factor = ((double)params.time_scaling_numerator) / ((double)params.time_scaling_denominator);
     if (new_factor != old_factor)
@@ -248,6 +389,8 @@ void SetTimeStretching(unsigned int numerator, unsigned int denominator)
       params.time_scaling_numerator = numerator;
       params.time_scaling_denominator = denominator;
       StoreParameters(params);
+      tMonotonicTimestamp monotonic_time = tMonotonicClock::now();
+      StoreMonotonicParameters(numerator, denominator, monotonic_time, ToMonotonicApplicationTime(monotonic_time));
 
       if (mode.load() != (int)tTimeMode::STRETCHED_SYSTEM_TIME)
       {
@@ -282,225 +425,386 @@ tDuration ToSystemDuration(const tDuration& app_duration)
   return tDuration();
 }
 
-#ifdef RRLIB_TIME_PARSING_AVAILABLE
-tTimestamp ParseIsoTimestamp(const std::string& s)
+/*! Sets error (if not NULL) - always returns false */
+static inline bool SetParseError(tParseError* error, const char* description, size_t position)
 {
-  tm t;
-  memset(&t, 0, sizeof(t));
-  time_t tz = 0;
-  char charbuf[s.length() + 1];
-  strncpy(charbuf, s.c_str(), s.length() + 1);
-  char* c = strptime(charbuf, "%FT%T", &t);
-  std::chrono::nanoseconds rest(0);
-  if (c && *c == '.')
-  {
-    char nanos[32];
-    memset(nanos, '0', 9);
-    for (unsigned int i = 0; i < sizeof(nanos); i++)
-    {
-      c++;
-      if (!isdigit(*c))
-      {
-        break;
-      }
-      nanos[i] = *c;
-    }
-    nanos[9] = 0;
-    rest = std::chrono::nanoseconds(atoi(nanos));
+  if (error)
+  {
+    error->description = description;
+    error->position = position;
+  }
+  return false;
+}
+
+/*!
+ * Parses exactly 'digits' decimal digits starting at 'position'
+ * (advances 'position' on success)
+ */
+static inline bool ParseDigits(const char* string, size_t length, size_t& position, int digits, int& result)
+{
+  if (position + digits > length)
+  {
+    return false;
   }
-  char* colon = c ? strchr(c, ':') : NULL;
-  if (c && ((*c == '+') || (*c == '-')) && colon)
+  int value = 0;
+  for (int i = 0; i < digits; i++)
   {
-    // we could use global 'timezone' but this is not thread-safe
-    int sign = (*c == '-') ? -1 : 1;
-    *colon = 0;
-    tz = atoi(c) * -3600;
-    colon++;
-    if (*colon == '3')
+    unsigned int digit = static_cast<unsigned char>(string[position + i]) - '0';
+    if (digit > 9)
     {
-      tz += sign * -1800;
+      position += i;
+      return false;
     }
+    value = value * 10 + digit;
   }
-  time_t parsed = timegm(&t) + tz;
-  auto ts2 = std::chrono::system_clock::from_time_t(parsed);
-  return ts2 + std::chrono::duration_cast<tDuration>(rest);
+  position += digits;
+  result = value;
+  return true;
 }
-#endif
 
-#ifdef RRLIB_TIME_PARSING_AVAILABLE
-tTimestamp ParseNmeaTimestamp(const std::string& nmea_time, const std::string& nmea_date)
+/*! Checks whether character at 'position' is 'c' (advances 'position' on success) */
+static inline bool ParseSeparator(const char* string, size_t length, size_t& position, char c)
 {
-  tm t;
-  memset(&t, 0, sizeof(t));
-  char buffer[10];
-  memset(buffer, 0, sizeof(buffer));
-
-  // nmea_time = HHMMSS or HHMMSS.SSS
-  // nmea_date = DDMMYY
-  t.tm_mday = atoi(nmea_date.substr(0, 2).c_str());
-  t.tm_mon = atoi(nmea_date.substr(2, 2).c_str()) - 1; // nmea month = [1..12], tm_mon = [0..11]
-  t.tm_year = atoi(nmea_date.substr(4, 2).c_str()) + 100; // nmea year since 2000, UTC since 1900
-  t.tm_hour = atoi(nmea_time.substr(0, 2).c_str());
-  t.tm_min = atoi(nmea_time.substr(2, 2).c_str());
-  t.tm_sec = atoi(nmea_time.substr(4, 2).c_str());
-  std::chrono::milliseconds rest(0);
-  if (nmea_time.length() > 7)
+  if (position < length && string[position] == c)
   {
-    for (size_t i = 0; i < 3; i++)
-    {
-      buffer[i] = (nmea_time.length() > (i + 7)) ? nmea_time[i + 7] : '0';
-    }
-    buffer[3] = 0;
-    rest = std::chrono::milliseconds(atoi(buffer));
+    position++;
+    return true;
   }
-  auto ts = std::chrono::system_clock::from_time_t(timegm(&t));
-  return ts + std::chrono::duration_cast<tDuration>(rest);
+  return false;
 }
-#endif
 
-std::string ToIsoString(const tTimestamp& timestamp)
+/*! Number of seconds that can be represented by tTimestamp (in both directions from epoch) */
+static const int64_t cMAX_TIMESTAMP_SECONDS = std::chrono::duration_cast<std::chrono::seconds>(tDuration::max()).count() - 1;
+
+bool TryParseIsoTimestamp(const char* string, size_t length, tTimestamp& result, tParseError* error)
 {
-  char buf[256], time_zone[12], sub_seconds[20];
-  time_t tt = std::chrono::system_clock::to_time_t(timestamp);
-  auto timestamp2 = std::chrono::system_clock::from_time_t(tt);
-  std::chrono::nanoseconds rest = timestamp - timestamp2;
-  if (rest.count() < 0)
+  size_t position = 0;
+  size_t field_start = 0;
+  int year = 0, month = 0, day = 0, hour = 0, minute = 0, second = 0;
+
+  // Date
+  if (!ParseDigits(string, length, position, 4, year))
+  {
+    return SetParseError(error, "Expected four-digit year", position);
+  }
+  if (!ParseSeparator(string, length, position, '-'))
+  {
+    return SetParseError(error, "Expected '-' after year", position);
+  }
+  field_start = position;
+  if (!ParseDigits(string, length, position, 2, month))
+  {
+    return SetParseError(error, "Expected two-digit month", position);
+  }
+  if (month < 1 || month > 12)
+  {
+    return SetParseError(error, "Month out of range", field_start);
+  }
+  if (!ParseSeparator(string, length, position, '-'))
+  {
+    return SetParseError(error, "Expected '-' after month", position);
+  }
+  field_start = position;
+  if (!ParseDigits(string, length, position, 2, day))
+  {
+    return SetParseError(error, "Expected two-digit day", position);
+  }
+  if (day < 1 || day > static_cast<int>(DaysInMonth(year, month)))
+  {
+    return SetParseError(error, "Day out of range", field_start);
+  }
+
+  // Time
+  if (position >= length || (string[position] != 'T' && string[position] != 't' && string[position] != ' '))
+  {
+    return SetParseError(error, "Expected 'T' after date", position);
+  }
+  position++;
+  field_start = position;
+  if (!ParseDigits(string, length, position, 2, hour))
+  {
+    return SetParseError(error, "Expected two-digit hour", position);
+  }
+  if (hour > 23)
+  {
+    return SetParseError(error, "Hour out of range", field_start);
+  }
+  if (!ParseSeparator(string, length, position, ':'))
+  {
+    return SetParseError(error, "Expected ':' after hour", position);
+  }
+  field_start = position;
+  if (!ParseDigits(string, length, position, 2, minute))
+  {
+    return SetParseError(error, "Expected two-digit minute", position);
+  }
+  if (minute > 59)
+  {
+    return SetParseError(error, "Minute out of range", field_start);
+  }
+  if (!ParseSeparator(string, length, position, ':'))
+  {
+    return SetParseError(error, "Expected ':' after minute", position);
+  }
+  field_start = position;
+  if (!ParseDigits(string, length, position, 2, second))
+  {
+    return SetParseError(error, "Expected two-digit second", position);
+  }
+  if (second > 60) // 60 is a leap second
   {
-    rest += std::chrono::seconds(1);
-    tt--;
-    assert(rest.count() > 0);
+    return SetParseError(error, "Second out of range", field_start);
   }
-  int  ns = rest.count();
 
-  tm tmp;
-  memset(&tmp, 0, sizeof(tmp));
-  strftime(buf, 256, "%FT%T", localtime_r(&tt, &tmp));
-  strftime(time_zone, 12, "%z", localtime_r(&tt, &tmp));
-  if (strlen(time_zone) > 3)
+  // Fractional seconds
+  int64_t nanoseconds = 0;
+  if (ParseSeparator(string, length, position, '.'))
   {
-    memmove(&time_zone[4], &time_zone[3], strlen(time_zone) - 2);
-    time_zone[3] = ':';
+    field_start = position;
+    int64_t scale = 100000000;
+    for (; position < length && static_cast<unsigned int>(static_cast<unsigned char>(string[position]) - '0') <= 9; position++)
+    {
+      nanoseconds += (string[position] - '0') * scale;
+      scale /= 10;
+    }
+    if (position == field_start)
+    {
+      return SetParseError(error, "Expected digits after '.'", position);
+    }
   }
 
-  sub_seconds[0] = 0;
-  if (ns != 0)
+  // Time zone
+  int offset_seconds = 0;
+  if (position < length)
   {
-    if (ns % 1000000 == 0)
+    char c = string[position];
+    if (c == 'Z' || c == 'z')
     {
-      sprintf(sub_seconds, ".%03d", ns / 1000000);
+      position++;
     }
-    else if (ns % 1000 == 0)
+    else if (c == '+' || c == '-')
     {
-      sprintf(sub_seconds, ".%06d", ns / 1000);
+      position++;
+      int offset_hours = 0, offset_minutes = 0;
+      field_start = position;
+      if (!ParseDigits(string, length, position, 2, offset_hours))
+      {
+        return SetParseError(error, "Expected two-digit time zone hours", position);
+      }
+      if (offset_hours > 23)
+      {
+        return SetParseError(error, "Time zone hours out of range", field_start);
+      }
+      if (position < length)
+      {
+        ParseSeparator(string, length, position, ':');
+        field_start = position;
+        if (!ParseDigits(string, length, position, 2, offset_minutes))
+        {
+          return SetParseError(error, "Expected two-digit time zone minutes", position);
+        }
+        if (offset_minutes > 59)
+        {
+          return SetParseError(error, "Time zone minutes out of range", field_start);
+        }
+      }
+      offset_seconds = (c == '-' ? -1 : 1) * (offset_hours * 3600 + offset_minutes * 60);
     }
     else
     {
-      sprintf(sub_seconds, ".%09d", ns);
+      return SetParseError(error, "Expected time zone designator ('Z', '+' or '-')", position);
     }
   }
-  return std::string(buf) + sub_seconds + time_zone;
+  if (position != length)
+  {
+    return SetParseError(error, "Unexpected characters after timestamp", position);
+  }
+
+  int64_t seconds = DaysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second - offset_seconds;
+  if (seconds >= cMAX_TIMESTAMP_SECONDS || seconds < -cMAX_TIMESTAMP_SECONDS)
+  {
+    return SetParseError(error, "Timestamp out of range", 0);
+  }
+  result = tTimestamp(std::chrono::duration_cast<tDuration>(std::chrono::nanoseconds(seconds * 1000000000 + nanoseconds)));
+  return true;
 }
 
-#ifdef RRLIB_TIME_PARSING_AVAILABLE
-tDuration ParseIsoDuration(const std::string& s)
+tTimestamp ParseIsoTimestamp(const char* string, size_t length)
 {
-  tm t;
-  memset(&t, 0, sizeof(t));
-  t.tm_year = 70;
-  t.tm_mday = 1;
-
-  if (s.length() == 0 || s[0] != 'P')
+  tTimestamp result;
+  tParseError error;
+  if (!TryParseIsoTimestamp(string, length, result, &error))
   {
-    throw std::runtime_error(std::string("Duration string does not start with P: ") + s);
+    throw std::runtime_error(std::string("Invalid timestamp string '") + std::string(string, length) + "': " + error.description + " (at position " + std::to_string(error.position) + ")");
   }
-  char cs[s.length() + 1];
-  strncpy(cs, s.c_str(), s.length() + 1);
-  size_t len = s.length();
-  std::chrono::nanoseconds rest(0);
+  return result;
+}
 
-  // start with fractional seconds
-  if (cs[len - 1] == 'S')
-  {
-    char* sec_start = &cs[len - 2];
-    for (; isdigit(*sec_start); sec_start--);
-    if (*sec_start == '.')
-    {
-      char nanos[20];
-      memset(nanos, '0', 9);
-      nanos[9] = 0;
-      strncpy(nanos, sec_start + 1, std::min<size_t>(9, &cs[len - 1] - (sec_start + 1)));
-      rest = std::chrono::nanoseconds(atoi(nanos));
+std::string ToIsoString(const tTimestamp& timestamp)
+{
+  return tIsoTimestampFormatter::ThreadLocalInstance().Format(timestamp);
+}
 
-      // cut off fractional seconds from string
-      sec_start[0] = 'S';
-      sec_start[1] = 0;
-    }
+/*! Maximum number of years and months (as years) in duration strings - tDuration covers around 292 years */
+static const int64_t cMAX_DURATION_YEARS = 290;
+
+bool TryParseIsoDuration(const char* string, size_t length, tDuration& result, tParseError* error)
+{
+  if (length == 0 || string[0] != 'P')
+  {
+    return SetParseError(error, "Duration string does not start with 'P'", 0);
   }
 
-  // parse the rest
+  size_t position = 1;
   bool time = false;
-  char* c = &cs[1];
-  while (*c)
+  int last_rank = 0;  // rank of last designator - to check order (Y=1, M=2, W=3, D=4, H=5, M=6, S=7)
+  int64_t years = 0, months = 0, nanoseconds = 0;
+  while (position < length)
   {
-    if (isdigit(*c))
+    if (string[position] == 'T')
     {
-      int num = atoi(c);
-      for (; c && isdigit(*c); c++);
-      if (!c)
+      if (time)
       {
-        throw std::runtime_error(std::string("Invalid duration string: ") + s);
+        return SetParseError(error, "Duplicate 'T'", position);
       }
-      switch (*c)
+      time = true;
+      position++;
+      continue;
+    }
+
+    // Number
+    size_t number_start = position;
+    int64_t value = 0;
+    for (; position < length && static_cast<unsigned int>(static_cast<unsigned char>(string[position]) - '0') <= 9; position++)
+    {
+      if (position - number_start >= 15)
       {
-      case 'Y':
-        t.tm_year = 70 + num;
-        break;
-      case 'M':
-        if (!time)
-        {
-          t.tm_mon = num;
-        }
-        else
-        {
-          t.tm_min = num;
-        }
-        break;
-      case 'D':
-        t.tm_mday = num + 1;
-        break;
-      case 'H':
-        if (!time)
-        {
-          throw std::runtime_error(std::string("Invalid duration string: ") + s);
-        }
-        t.tm_hour = num;
-        break;
-      case 'S':
-        if (!time)
-        {
-          throw std::runtime_error(std::string("Invalid duration string: ") + s);
-        }
-        t.tm_sec = num;
-        break;
-      default:
-        throw std::runtime_error(std::string("Invalid duration string: ") + s);
+        return SetParseError(error, "Number too large", number_start);
       }
+      value = value * 10 + (string[position] - '0');
     }
-    else if (*c == 'T')
+    if (position == number_start)
     {
-      time = true;
+      return SetParseError(error, "Expected number", position);
+    }
+    int64_t fraction = 0;
+    size_t fraction_start = 0;
+    if (position < length && (string[position] == '.' || string[position] == ','))
+    {
+      position++;
+      fraction_start = position;
+      int64_t scale = 100000000;
+      for (; position < length && static_cast<unsigned int>(static_cast<unsigned char>(string[position]) - '0') <= 9; position++)
+      {
+        fraction += (string[position] - '0') * scale;
+        scale /= 10;
+      }
+      if (position == fraction_start)
+      {
+        return SetParseError(error, "Expected digits after decimal sign", position);
+      }
+    }
+
+    // Designator
+    if (position >= length)
+    {
+      return SetParseError(error, "Expected designator", position);
+    }
+    char designator = string[position];
+    int rank = 0;
+    int64_t unit = 0;
+    switch (designator)
+    {
+    case 'Y':
+      rank = time ? -1 : 1;
+      break;
+    case 'M':
+      rank = time ? 6 : 2;
+      unit = 60000000000LL;
+      break;
+    case 'W':
+      rank = time ? -1 : 3;
+      unit = 7 * 86400000000000LL;
+      break;
+    case 'D':
+      rank = time ? -1 : 4;
+      unit = 86400000000000LL;
+      break;
+    case 'H':
+      rank = time ? 5 : -2;
+      unit = 3600000000000LL;
+      break;
+    case 'S':
+      rank = time ? 7 : -2;
+      unit = 1000000000LL;
+      break;
+    default:
+      return SetParseError(error, "Invalid designator", position);
+    }
+    if (rank == -1)
+    {
+      return SetParseError(error, "Date designator in time part", position);
+    }
+    if (rank == -2)
+    {
+      return SetParseError(error, "Time designator without preceding 'T'", position);
+    }
+    if (rank <= last_rank)
+    {
+      return SetParseError(error, "Designator repeated or in wrong order", position);
+    }
+    if (fraction_start && designator != 'S')
+    {
+      return SetParseError(error, "Only seconds may have a fraction", fraction_start);
+    }
+    last_rank = rank;
+
+    if (rank == 1)
+    {
+      years = value;
+    }
+    else if (rank == 2)
+    {
+      months = value;
     }
     else
     {
-      throw std::runtime_error(std::string("Invalid duration string: ") + s);
+      if (value > std::numeric_limits<int64_t>::max() / unit || value * unit > std::numeric_limits<int64_t>::max() - nanoseconds - fraction)
+      {
+        return SetParseError(error, "Duration out of range", number_start);
+      }
+      nanoseconds += value * unit + fraction;
     }
-    c++;
+    position++;
   }
 
-  time_t parsed = timegm(&t);
-  return std::chrono::seconds(parsed) + std::chrono::duration_cast<tDuration>(rest);
+  if (years || months)
+  {
+    if (years + months / 12 > cMAX_DURATION_YEARS)
+    {
+      return SetParseError(error, "Duration out of range", 1);
+    }
+    int64_t calendar_nanoseconds = DaysFromCivil(1970 + years + months / 12, static_cast<unsigned int>(months % 12) + 1, 1) * 86400000000000LL;
+    if (nanoseconds > std::numeric_limits<int64_t>::max() - calendar_nanoseconds)
+    {
+      return SetParseError(error, "Duration out of range", 1);
+    }
+    nanoseconds += calendar_nanoseconds;
+  }
+  result = std::chrono::duration_cast<tDuration>(std::chrono::nanoseconds(nanoseconds));
+  return true;
+}
+
+tDuration ParseIsoDuration(const char* string, size_t length)
+{
+  tDuration result;
+  tParseError error;
+  if (!TryParseIsoDuration(string, length, result, &error))
+  {
+    throw std::runtime_error(std::string("Invalid duration string '") + std::string(string, length) + "': " + error.description + " (at position " + std::to_string(error.position) + ")");
+  }
+  return result;
 }
-#endif
 
 std::string ToIsoString(const tDuration& duration)
 {
@@ -563,62 +867,19 @@ std::string ToIsoString(const tDuration& duration)
 
 std::string ToString(std::chrono::nanoseconds ns)
 {
-  if (ns.count() == 0)
-  {
-    return "0 ms";
-  }
-  const char* sign = "";
-  if (ns.count() < 0)
-  {
-    sign = "-";
-    ns = -ns;
-  }
-
-  std::chrono::milliseconds ms = std::chrono::duration_cast<std::chrono::milliseconds>(ns);
-  std::chrono::nanoseconds rest = ns - ms;
-  char buf[1000];
-  if (rest.count() != 0 || ms.count() != 0)
-  {
-    if (rest.count() % 1000 == 0)
-    {
-      sprintf(buf, "%s%lld.%03lld ms", sign, static_cast<long long int>(ms.count()), static_cast<long long int>(rest.count() / 1000));
-      return buf;
-    }
-    sprintf(buf, "%s%lld.%06lld ms", sign, static_cast<long long int>(ms.count()), static_cast<long long int>(rest.count()));
-    return buf;
-  }
-  std::chrono::minutes mins = std::chrono::duration_cast<std::chrono::minutes>(ns);
-  rest = ns - mins;
-  if (rest.count() != 0)
-  {
-    sprintf(buf, "%s%lld s", sign, static_cast<long long int>(std::chrono::duration_cast<std::chrono::seconds>(ns).count()));
-    return buf;
-  }
-  std::chrono::hours hours = std::chrono::duration_cast<std::chrono::hours>(ns);
-  rest = ns - hours;
-  if (rest.count() != 0)
-  {
-    int c = std::chrono::duration_cast<std::chrono::minutes>(ns).count();
-    sprintf(buf, "%s%d minute%s", sign, c, c > 1 ? "s" : "");
-    return buf;
-  }
-  int c = std::chrono::duration_cast<std::chrono::hours>(ns).count();
-  sprintf(buf, "%s%d hour%s", sign, c, c > 1 ? "s" : "");
-  return buf;
+  char buffer[cMAX_DURATION_STRING_LENGTH + 1];
+  return std::string(buffer, ToString(ns, buffer));
 }
 
-#if __linux__
 tTimestamp GetLastFullHour(const tTimestamp &timestamp)
 {
-  std::time_t input_time = std::chrono::system_clock::to_time_t(timestamp);
-  tm full_hour_time = {0};
-  gmtime_r(&input_time, &full_hour_time);
-  full_hour_time.tm_sec = 0;
-  full_hour_time.tm_min = 0;
-  std::time_t output_time = timegm(&full_hour_time);
-  return std::chrono::system_clock::from_time_t(output_time);
+  return Floor(timestamp, tCalendarUnit::HOUR);
+}
+
+void tCustomClock::BlockUntil(const rrlib::time::tTimestamp& wake_up_time) const
+{
+  std::this_thread::sleep_for(std::min<tDuration>(wake_up_time - Now(), std::chrono::milliseconds(10)));
 }
-#endif
 
 bool tCustomClock::IsCurrentTimeSource() const
 {
@@ -633,6 +894,11 @@ void tCustomClock::SetApplicationTime(const rrlib::time::tTimestamp& new_time)
     if (this == current_clock && mode.load() == (int)tTimeMode::CUSTOM_CLOCK)
     {
       current_time.Store(new_time);
+      current_monotonic_time.Store(new_time + custom_clock_monotonic_offset);
+      if (internal::time_recording_active.load(std::memory_order_relaxed))
+      {
+        internal::RecordTimeEvent(tTimeEvent { tTimeEventType::APPLICATION_TIME, tBaseClock::now(), new_time, 0, 0, false });
+      }
       tTimeStretchingListener::NotifyListeners(new_time);
     }
   }
@@ -38,6 +38,7 @@
 //----------------------------------------------------------------------
 #include <chrono>
 #include <mutex>
+#include <string>
 
 #include "rrlib/design_patterns/singleton.h"
 
@@ -80,6 +81,20 @@ typedef tBaseClock::time_point tTimestamp;
  */
 typedef tBaseClock::duration tDuration;
 
+/*!
+ * Monotonic clock (CLOCK_MONOTONIC on Linux).
+ * Unlike tBaseClock (which is std::chrono::system_clock with libstdc++), it is not affected
+ * when system time is set (e.g. stepped by NTP) - and should therefore be used for measuring intervals.
+ */
+typedef std::chrono::steady_clock tMonotonicClock;
+
+//! Monotonic time stamp type
+/*!
+ * Time stamp for measuring intervals (e.g. latencies and timeouts).
+ * It is only meaningful relative to other monotonic time stamps of the same process - never as calendar time.
+ */
+typedef std::chrono::time_point<tMonotonicClock, tDuration> tMonotonicTimestamp;
+
 /*!
  * Special time stamp to indicate "no time" or "not set" or "never" (e.g. for a deadline)
  */
@@ -108,6 +123,8 @@ tTimeMode GetTimeMode();
  * It can, however, also be simulated time (time stretching when simulating etc.).
  * In order for time stretching to work in whole applications, libraries and application components
  * that do not explicitly require system time should obtain time from this function.
+ * For measuring intervals (e.g. latencies and timeouts), NowMonotonic() should be used - as results of
+ * this function jump when system time is set.
  *
  * Note, that obtaining precise high resolution system time can be a rather expensive system call.
  * (a benchmark that did only this could merely obtain around 150K time stamps per second (a few years ago on a Core Duo Notebook processor)).
@@ -119,6 +136,48 @@ tTimeMode GetTimeMode();
  */
 tTimestamp Now(bool precise = true);
 
+/*!
+ * Returns "application time" based on the monotonic clock.
+ * Time stretching is applied as in Now(). So differences of returned time stamps equal differences of Now() results -
+ * unless system time is set while measuring (which only affects Now()).
+ * If a custom clock is the time source, returned time advances with the clock's time.
+ * Monotonic application time is continuous when time source or time stretching factor is changed
+ * (so its time since epoch generally differs from Now()).
+ * Costs the same as Now().
+ *
+ * \param precise See Now()
+ */
+tMonotonicTimestamp NowMonotonic(bool precise = true);
+
+/*!
+ * \param start Start of interval (obtained from NowMonotonic())
+ * \return "Application time" elapsed since start
+ */
+inline tDuration GetElapsedTime(const tMonotonicTimestamp& start)
+{
+  return NowMonotonic() - start;
+}
+
+/*!
+ * Blocks calling thread until monotonic "application time" has reached wake-up time.
+ * Follows changes of time stretching and custom clocks (in these modes, the thread checks time at least every 10 ms of system time).
+ * With a custom clock as time source, the thread blocks in the clock's tCustomClock::BlockUntil()
+ * (e.g. a worker of a tVirtualClock blocks in the clock, so that virtual time can advance).
+ *
+ * \param wake_up_time Wake-up time (obtained from NowMonotonic())
+ */
+void SleepUntil(const tMonotonicTimestamp& wake_up_time);
+
+/*!
+ * Blocks calling thread for specified duration of "application time" (see SleepUntil())
+ *
+ * \param app_duration Duration in "application time"
+ */
+inline void SleepFor(const tDuration& app_duration)
+{
+  SleepUntil(NowMonotonic() + app_duration);
+}
+
 /*!
  * Sets specified non-linear clock as active time source for "application time".
  * Time mode is set to CUSTOM_CLOCK.
@@ -152,46 +211,112 @@ void SetTimeStretching(unsigned int numerator, unsigned int denominator);
  */
 tDuration ToSystemDuration(const tDuration& app_duration);
 
-#ifdef RRLIB_TIME_PARSING_AVAILABLE
 /*!
- * Parses timestamp in ISO 8601 string representation
+ * Describes why a string could not be parsed
+ * (filled by the non-throwing parsing functions - without allocating memory)
+ */
+struct tParseError
+{
+  /*! Description of error (static string) */
+  const char* description;
+
+  /*! Position of offending character in parsed string */
+  size_t position;
+};
+
+/*!
+ * Parses timestamp in ISO 8601 string representation.
+ * Supports the RFC 3339 profile: "YYYY-MM-DDTHH:MM:SS[.fraction](Z|+HH:MM|-HH:MM)".
+ * Additionally, 't' or ' ' are accepted as date/time separator, 'z' as UTC designator
+ * and "+HHMM" or "+HH" as time zone offsets. Timestamps without time zone are interpreted as UTC.
+ * Digits of fractional seconds beyond nanoseconds are ignored.
  *
- * \param s Timestamp as ISO 8601 string
+ * \param string Timestamp as ISO 8601 string (does not need to be zero-terminated)
+ * \param length Length of string
+ * \param result Parsed timestamp is written to this variable (if parsing succeeds)
+ * \param error If not NULL, the reason is written to this variable if parsing fails
+ * \return True if string could be parsed
+ */
+bool TryParseIsoTimestamp(const char* string, size_t length, tTimestamp& result, tParseError* error = NULL);
+
+/*!
+ * Parses timestamp in ISO 8601 string representation (see TryParseIsoTimestamp for supported format)
+ * (throws exception if string cannot be parsed)
+ *
+ * \param string Timestamp as ISO 8601 string (does not need to be zero-terminated)
+ * \param length Length of string
  * \return Timestamp
  */
-tTimestamp ParseIsoTimestamp(const std::string& s);
-#endif
+tTimestamp ParseIsoTimestamp(const char* string, size_t length);
 
+/*!
+ * Parses timestamp in ISO 8601 string representation (see TryParseIsoTimestamp for supported format)
+ * (throws exception if string cannot be parsed)
+ *
+ * \param s Timestamp as ISO 8601 string
+ * \return Timestamp
+ */
+inline tTimestamp ParseIsoTimestamp(const std::string& s)
+{
+  return ParseIsoTimestamp(s.c_str(), s.length());
+}
 
-#ifdef RRLIB_TIME_PARSING_AVAILABLE
 /*!
  * Parses GPS timestamp in NMEA-0183 GPRMC representation
  *
  * \param nmea_time GPS time according to NMEA-0183 GPRMC representation (HHMMSS{.SSS})
  * \param nmea_date GPS date according to NMEA-0183 GPRMC representation (DDMMYY)
  * \return Timestamp
+ * \throws std::runtime_error if time or date are invalid
+ *
+ * (for extracting timestamps from a stream of NMEA-0183 sentences, see tNmeaParser)
  */
 tTimestamp ParseNmeaTimestamp(const std::string& nmea_time, const std::string& nmea_date);
-#endif
 
 /*!
  * Turns Timestamp into string representation following ISO 8601 (or W3C XML Schema 1.0 specification)
+ * (uses the calling thread's tIsoTimestampFormatter - which caches date and time zone of the last second formatted)
  *
  * \param timestamp Timestamp to convert
  * \return ISO 8601 representation of timestamp
  */
 std::string ToIsoString(const tTimestamp& timestamp);
 
-#ifdef RRLIB_TIME_PARSING_AVAILABLE
 /*!
- * Parses duration in ISO 8601 string representation
+ * Parses duration in ISO 8601 string representation ("PnYnMnWnDTnHnMnS" - e.g. "P1Y35D" or "PT2.5S").
+ * Designators must appear in this order - each at most once. Only seconds may have a fraction.
+ * Years and months are counted from 1970-01-01 (consistent with ToIsoString).
+ * See literals.h for a variant that is evaluated at compile time.
+ *
+ * \param string Duration as ISO 8601 string (does not need to be zero-terminated)
+ * \param length Length of string
+ * \param result Parsed duration is written to this variable (if parsing succeeds)
+ * \param error If not NULL, the reason is written to this variable if parsing fails
+ * \return True if string could be parsed
+ */
+bool TryParseIsoDuration(const char* string, size_t length, tDuration& result, tParseError* error = NULL);
+
+/*!
+ * Parses duration in ISO 8601 string representation (see TryParseIsoDuration for supported format)
+ * (throws exception if string cannot be parsed)
+ *
+ * \param string Duration as ISO 8601 string (does not need to be zero-terminated)
+ * \param length Length of string
+ * \return Duration
+ */
+tDuration ParseIsoDuration(const char* string, size_t length);
+
+/*!
+ * Parses duration in ISO 8601 string representation (see TryParseIsoDuration for supported format)
  * (throws exception if string cannot be parsed)
  *
  * \param s Duration as ISO 8601 string
  * \return Duration
  */
-tDuration ParseIsoDuration(const std::string& s);
-#endif
+inline tDuration ParseIsoDuration(const std::string& s)
+{
+  return ParseIsoDuration(s.c_str(), s.length());
+}
 
 /*!
  * Turns Duration into string representation following ISO 8601 (or W3C XML Schema 1.0 specification)
@@ -203,21 +328,21 @@ std::string ToIsoString(const tDuration& duration);
 
 /*!
  * Turns duration into a simple string (number + unit)
+ * (formatting.h contains variants that write to buffers or streams - and a parser for this representation)
  *
  * \param duration Duration to convert
  * \return Simple string representation of duration
  */
 std::string ToString(std::chrono::nanoseconds ns);
 
-#if __linux__
 /*!
  * Extracts the last full hour from a given timestamp
+ * (equivalent to Floor(timestamp, tCalendarUnit::HOUR) - see rounding.h for other units)
  *
  * \param timestamp Timestamp to convert
  * \return timestamp of the last full hour
  */
 tTimestamp GetLastFullHour(const tTimestamp& timestamp);
-#endif
 
 namespace internal
 {
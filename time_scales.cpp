@@ -0,0 +1,371 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    rrlib/time/time_scales.cpp
+ *
+ * \author  agent
+ *
+ * \date    2026-10-18
+ *
+ */
+//----------------------------------------------------------------------
+#include "rrlib/time/time_scales.h"
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Debugging
+//----------------------------------------------------------------------
+#include <cassert>
+
+//----------------------------------------------------------------------
+// Namespace usage
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace time
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+namespace
+{
+
+/*! Maximum number of entries in leap second table */
+enum { cMAX_LEAP_SECOND_TABLE_SIZE = 128 };
+
+/*!
+ * Leap second table (immutable once published)
+ * All values are in nanoseconds.
+ */
+struct tLeapSecondTable
+{
+  /*! Number of entries */
+  size_t size;
+
+  /*! UTC (POSIX) time from which offset[i] applies */
+  int64_t utc[cMAX_LEAP_SECOND_TABLE_SIZE];
+
+  /*! TAI time from which offset[i] applies */
+  int64_t tai[cMAX_LEAP_SECOND_TABLE_SIZE];
+
+  /*! TAI - UTC */
+  int64_t offset[cMAX_LEAP_SECOND_TABLE_SIZE];
+
+  tLeapSecondTable() : size(0) {}
+
+  /*! Adds entry (entries must be added in chronological order) */
+  void Add(int64_t utc_seconds, int64_t offset_seconds)
+  {
+    assert(size < cMAX_LEAP_SECOND_TABLE_SIZE);
+    utc[size] = utc_seconds * cNANOSECONDS_PER_SECOND;
+    offset[size] = offset_seconds * cNANOSECONDS_PER_SECOND;
+    tai[size] = utc[size] + (size ? offset[size - 1] : offset[size]);
+    size++;
+  }
+
+  static const int64_t cNANOSECONDS_PER_SECOND = 1000000000;
+};
+
+/*!
+ * Looks up offset in leap second table.
+ * Remembers the interval of the last lookup - so that lookups for consecutive values need no search.
+ */
+class tOffsetLookup
+{
+public:
+
+  /*!
+   * \param table Leap second table
+   * \param keys Either table.utc or table.tai
+   */
+  tOffsetLookup(const tLeapSecondTable& table, const int64_t* keys) :
+    table(table),
+    keys(keys),
+    begin(0),
+    end(0),
+    offset(0)
+  {}
+
+  /*!
+   * \param value Value in time scale of keys (nanoseconds)
+   * \return TAI - UTC at this value (nanoseconds)
+   */
+  int64_t Get(int64_t value)
+  {
+    if (value >= begin && value < end)
+    {
+      return offset;
+    }
+
+    // Most values are after the last leap second
+    size_t index = value >= keys[table.size - 1] ? table.size : std::upper_bound(keys, keys + table.size, value) - keys;
+    begin = index == 0 ? std::numeric_limits<int64_t>::min() : keys[index - 1];
+    end = index == table.size ? std::numeric_limits<int64_t>::max() : keys[index];
+    offset = table.offset[index == 0 ? 0 : index - 1];
+    return offset;
+  }
+
+private:
+
+  const tLeapSecondTable& table;
+  const int64_t* keys;
+
+  /*! Cached result: offset is valid for values in [begin, end) */
+  int64_t begin, end, offset;
+};
+
+}
+
+//----------------------------------------------------------------------
+// Const values
+//----------------------------------------------------------------------
+
+const char* const cDEFAULT_LEAP_SECONDS_LIST = "/usr/share/zoneinfo/leap-seconds.list";
+
+/*! Leap seconds until library release (start of UTC month and TAI - UTC from then on) */
+static const struct
+{
+  int year;
+  unsigned int month;
+  int offset;
+} cLEAP_SECONDS[] =
+{
+  { 1972, 1, 10 }, { 1972, 7, 11 }, { 1973, 1, 12 }, { 1974, 1, 13 }, { 1975, 1, 14 }, { 1976, 1, 15 }, { 1977, 1, 16 },
+  { 1978, 1, 17 }, { 1979, 1, 18 }, { 1980, 1, 19 }, { 1981, 7, 20 }, { 1982, 7, 21 }, { 1983, 7, 22 }, { 1985, 7, 23 },
+  { 1988, 1, 24 }, { 1990, 1, 25 }, { 1991, 1, 26 }, { 1992, 7, 27 }, { 1993, 7, 28 }, { 1994, 7, 29 }, { 1996, 1, 30 },
+  { 1997, 7, 31 }, { 1999, 1, 32 }, { 2006, 1, 33 }, { 2009, 1, 34 }, { 2012, 7, 35 }, { 2015, 7, 36 }, { 2017, 1, 37 }
+};
+
+/*! TAI - GPS time */
+static const int64_t cGPS_TAI_OFFSET = 19 * tLeapSecondTable::cNANOSECONDS_PER_SECOND;
+
+/*! Length of GPS week */
+static const int64_t cNANOSECONDS_PER_WEEK = 7 * 86400 * tLeapSecondTable::cNANOSECONDS_PER_SECOND;
+
+/*! Seconds between NTP epoch (1900-01-01, used in leap-seconds.list) and 1970-01-01 */
+static const int64_t cNTP_EPOCH_OFFSET = -DaysFromCivil(1900, 1, 1) * 86400;
+
+//----------------------------------------------------------------------
+// Implementation
+//----------------------------------------------------------------------
+
+/*! Currently used table - if set via LoadLeapSecondTable() */
+static std::atomic<const tLeapSecondTable*> loaded_table(nullptr);
+
+static const tLeapSecondTable& CompiledInTable()
+{
+  static const tLeapSecondTable table = []()
+  {
+    tLeapSecondTable result;
+    for (auto & entry : cLEAP_SECONDS)
+    {
+      result.Add(DaysFromCivil(entry.year, entry.month, 1) * 86400, entry.offset);
+    }
+    return result;
+  }();
+  return table;
+}
+
+static const tLeapSecondTable& CurrentTable()
+{
+  const tLeapSecondTable* table = loaded_table.load(std::memory_order_acquire);
+  return table ? *table : CompiledInTable();
+}
+
+/*! GPS time (nanoseconds since GPS epoch) -> tGpsTime */
+static tGpsTime ToGpsTime(int64_t nanoseconds)
+{
+  int64_t week = nanoseconds / cNANOSECONDS_PER_WEEK;
+  int64_t time_of_week = nanoseconds % cNANOSECONDS_PER_WEEK;
+  if (time_of_week < 0)
+  {
+    week--;
+    time_of_week += cNANOSECONDS_PER_WEEK;
+  }
+  return tGpsTime { week, std::chrono::duration_cast<tDuration>(std::chrono::nanoseconds(time_of_week)) };
+}
+
+/*! tGpsTime -> TAI (nanoseconds) */
+static int64_t GpsToTaiNanoseconds(const tGpsTime& gps)
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(cGPS_EPOCH.time_since_epoch()).count() + cGPS_TAI_OFFSET +
+         gps.week * cNANOSECONDS_PER_WEEK + std::chrono::duration_cast<std::chrono::nanoseconds>(gps.time_of_week).count();
+}
+
+static inline int64_t ToNanoseconds(const tTimestamp& timestamp)
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(timestamp.time_since_epoch()).count();
+}
+
+static inline tTimestamp ToTimestamp(int64_t nanoseconds)
+{
+  return tTimestamp(std::chrono::duration_cast<tDuration>(std::chrono::nanoseconds(nanoseconds)));
+}
+
+tDuration GetTaiOffset(const tTimestamp& utc)
+{
+  const tLeapSecondTable& table = CurrentTable();
+  return std::chrono::duration_cast<tDuration>(std::chrono::nanoseconds(tOffsetLookup(table, table.utc).Get(ToNanoseconds(utc))));
+}
+
+tTimestamp UtcToTai(const tTimestamp& utc)
+{
+  tTimestamp result;
+  UtcToTai(&utc, 1, &result);
+  return result;
+}
+
+tTimestamp TaiToUtc(const tTimestamp& tai)
+{
+  tTimestamp result;
+  TaiToUtc(&tai, 1, &result);
+  return result;
+}
+
+tGpsTime UtcToGps(const tTimestamp& utc)
+{
+  tGpsTime result;
+  UtcToGps(&utc, 1, &result);
+  return result;
+}
+
+tTimestamp GpsToUtc(const tGpsTime& gps)
+{
+  tTimestamp result;
+  GpsToUtc(&gps, 1, &result);
+  return result;
+}
+
+void UtcToTai(const tTimestamp* input, size_t count, tTimestamp* output)
+{
+  const tLeapSecondTable& table = CurrentTable();
+  tOffsetLookup lookup(table, table.utc);
+  for (size_t i = 0; i < count; i++)
+  {
+    int64_t utc = ToNanoseconds(input[i]);
+    output[i] = ToTimestamp(utc + lookup.Get(utc));
+  }
+}
+
+void TaiToUtc(const tTimestamp* input, size_t count, tTimestamp* output)
+{
+  const tLeapSecondTable& table = CurrentTable();
+  tOffsetLookup lookup(table, table.tai);
+  for (size_t i = 0; i < count; i++)
+  {
+    int64_t tai = ToNanoseconds(input[i]);
+    output[i] = ToTimestamp(tai - lookup.Get(tai));
+  }
+}
+
+void UtcToGps(const tTimestamp* input, size_t count, tGpsTime* output)
+{
+  const tLeapSecondTable& table = CurrentTable();
+  tOffsetLookup lookup(table, table.utc);
+  const int64_t gps_epoch_tai = ToNanoseconds(cGPS_EPOCH) + cGPS_TAI_OFFSET;
+  for (size_t i = 0; i < count; i++)
+  {
+    int64_t utc = ToNanoseconds(input[i]);
+    output[i] = ToGpsTime(utc + lookup.Get(utc) - gps_epoch_tai);
+  }
+}
+
+void GpsToUtc(const tGpsTime* input, size_t count, tTimestamp* output)
+{
+  const tLeapSecondTable& table = CurrentTable();
+  tOffsetLookup lookup(table, table.tai);
+  for (size_t i = 0; i < count; i++)
+  {
+    int64_t tai = GpsToTaiNanoseconds(input[i]);
+    output[i] = ToTimestamp(tai - lookup.Get(tai));
+  }
+}
+
+void LoadLeapSecondTable(const std::string& file_name)
+{
+  std::ifstream file(file_name);
+  if (!file)
+  {
+    throw std::runtime_error("Could not open leap second table '" + file_name + "'");
+  }
+
+  std::unique_ptr<tLeapSecondTable> table(new tLeapSecondTable());
+  std::string line;
+  while (std::getline(file, line))
+  {
+    // Format: <NTP seconds> <TAI - UTC> [# comment] (lines starting with '#' are comments)
+    if (line.find_first_not_of(" \t\r") == std::string::npos || line[0] == '#')
+    {
+      continue;
+    }
+    std::istringstream stream(line);
+    int64_t ntp_seconds = 0, offset = 0;
+    if (!(stream >> ntp_seconds >> offset))
+    {
+      throw std::runtime_error("Invalid line in leap second table '" + file_name + "': " + line);
+    }
+    int64_t utc_seconds = ntp_seconds - cNTP_EPOCH_OFFSET;
+    if (table->size == cMAX_LEAP_SECOND_TABLE_SIZE || (table->size && utc_seconds * tLeapSecondTable::cNANOSECONDS_PER_SECOND <= table->utc[table->size - 1]))
+    {
+      throw std::runtime_error("Invalid leap second table '" + file_name + "': entries must be sorted (at most 128)");
+    }
+    table->Add(utc_seconds, offset);
+  }
+  if (table->size == 0)
+  {
+    throw std::runtime_error("Leap second table '" + file_name + "' contains no entries");
+  }
+
+  // Replaced tables are kept, as other threads may still be using them
+  static std::mutex mutex;
+  static std::vector<std::unique_ptr<tLeapSecondTable>> tables;
+  std::lock_guard<std::mutex> lock(mutex);
+  tables.push_back(std::move(table));
+  loaded_table.store(tables.back().get(), std::memory_order_release);
+}
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
@@ -0,0 +1,146 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    rrlib/time/time_scales.h
+ *
+ * \author  agent
+ *
+ * \date    2026-10-18
+ *
+ * \brief   Contains conversions between UTC, TAI and GPS time
+ *
+ * tTimestamp values are UTC (POSIX time - leap seconds are not counted).
+ * GNSS receivers and PTP clocks, however, count continuously in GPS time or TAI.
+ * The functions in this file convert between these time scales.
+ *
+ * TAI is represented as tTimestamp counting SI seconds since 1970-01-01T00:00:00 TAI.
+ * GPS time is represented as week number and time of week (GPS epoch is 1980-01-06T00:00:00 UTC; GPS time = TAI - 19s).
+ *
+ * Conversions use a table of leap seconds that is compiled into the library.
+ * It can be replaced with a more recent one from a leap-seconds.list file (as published by IERS and shipped with tzdata).
+ * Before 1972 (start of the table), TAI - UTC is assumed to be 10 seconds.
+ */
+//----------------------------------------------------------------------
+#ifndef __rrlib__time__time_scales_h__
+#define __rrlib__time__time_scales_h__
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <string>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+#include "rrlib/time/time.h"
+#include "rrlib/time/calendar.h"
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace time
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+/*!
+ * GPS time as provided by GNSS receivers
+ */
+struct tGpsTime
+{
+  /*! Number of weeks since GPS epoch (not truncated to 10 or 13 bits) */
+  int64_t week;
+
+  /*! Time since start of week (Sunday 00:00:00 GPS time) */
+  tDuration time_of_week;
+};
+
+/*! GPS epoch (1980-01-06T00:00:00 UTC) */
+constexpr tTimestamp cGPS_EPOCH = tTimestamp(std::chrono::seconds(DaysFromCivil(1980, 1, 6) * 86400));
+
+/*! Default location of leap-seconds.list on Linux systems (installed with tzdata) */
+extern const char* const cDEFAULT_LEAP_SECONDS_LIST;
+
+/*!
+ * \param utc UTC timestamp
+ * \return TAI - UTC at specified time (number of leap seconds + 10s)
+ */
+tDuration GetTaiOffset(const tTimestamp& utc);
+
+/*!
+ * \param utc UTC timestamp
+ * \return TAI timestamp
+ */
+tTimestamp UtcToTai(const tTimestamp& utc);
+
+/*!
+ * \param tai TAI timestamp
+ * \return UTC timestamp (during a leap second, the last second of the day is repeated - as in POSIX clocks)
+ */
+tTimestamp TaiToUtc(const tTimestamp& tai);
+
+/*!
+ * \param utc UTC timestamp
+ * \return GPS time
+ */
+tGpsTime UtcToGps(const tTimestamp& utc);
+
+/*!
+ * \param gps GPS time (time of week may exceed one week or be negative)
+ * \return UTC timestamp (during a leap second, the last second of the day is repeated - as in POSIX clocks)
+ */
+tTimestamp GpsToUtc(const tGpsTime& gps);
+
+/*!
+ * Batch variants of the functions above for converting recorded streams.
+ * Table lookup is skipped for consecutive values within the same leap second interval
+ * (so converting sorted data costs only two comparisons per element).
+ *
+ * \param input Values to convert
+ * \param count Number of values
+ * \param output Array that converted values are written to (must have 'count' elements - may be identical to 'input')
+ */
+void UtcToTai(const tTimestamp* input, size_t count, tTimestamp* output);
+void TaiToUtc(const tTimestamp* input, size_t count, tTimestamp* output);
+void UtcToGps(const tTimestamp* input, size_t count, tGpsTime* output);
+void GpsToUtc(const tGpsTime* input, size_t count, tTimestamp* output);
+
+/*!
+ * Replaces the leap second table with the one from a leap-seconds.list file.
+ * Can be called at any time - concurrent conversions are lock-free and use either the old or the new table.
+ *
+ * \param file_name Name of leap-seconds.list file
+ * \throws std::runtime_error if file cannot be read or does not contain a valid table
+ */
+void LoadLeapSecondTable(const std::string& file_name = cDEFAULT_LEAP_SECONDS_LIST);
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
+
+
+#endif
@@ -0,0 +1,133 @@
+//
+// You received this file as part of RRLib
+// Robotics Research Library
+//
+// Copyright (C) Finroc GbR (finroc.org)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+//----------------------------------------------------------------------
+/*!\file    rrlib/time/varint.h
+ *
+ * \author  agent
+ *
+ * \date    2026-10-18
+ *
+ * \brief   Contains zig-zag and varint coding of 64 bit values (internal - used by tTimestampCodec and tTimeRecorder)
+ *
+ * Varints store 7 bits per byte (least significant group first) - with the highest bit set in all but the last byte.
+ * Zig-zag coding maps signed differences to unsigned values (0, -1, 1, -2, ... to 0, 1, 2, 3, ...), so that small
+ * differences result in short varints.
+ * Differences are computed with unsigned (wrapping) arithmetic by the callers - so that any sequence of values
+ * can be encoded without overflow.
+ */
+//----------------------------------------------------------------------
+#ifndef __rrlib__time__varint_h__
+#define __rrlib__time__varint_h__
+
+//----------------------------------------------------------------------
+// External includes (system with <>, local with "")
+//----------------------------------------------------------------------
+#include <cstddef>
+#include <cstdint>
+
+//----------------------------------------------------------------------
+// Internal includes with ""
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+// Namespace declaration
+//----------------------------------------------------------------------
+namespace rrlib
+{
+namespace time
+{
+
+//----------------------------------------------------------------------
+// Forward declarations / typedefs / enums
+//----------------------------------------------------------------------
+
+namespace internal
+{
+
+/*! Maximum size of a varint-encoded 64 bit value */
+static const size_t cMAX_VARINT_SIZE = 10;
+
+inline uint64_t ZigZagEncode(uint64_t value)
+{
+  return (value << 1) ^ (0 - (value >> 63));
+}
+
+inline uint64_t ZigZagDecode(uint64_t value)
+{
+  return (value >> 1) ^ (0 - (value & 1));
+}
+
+/*!
+ * Writes varint to buffer
+ *
+ * \param buffer Buffer (at least cMAX_VARINT_SIZE bytes must be available)
+ * \param value Value to write
+ * \return Position after written varint
+ */
+inline uint8_t* WriteVarint(uint8_t* buffer, uint64_t value)
+{
+  while (value >= 0x80)
+  {
+    *(buffer++) = static_cast<uint8_t>(value | 0x80);
+    value >>= 7;
+  }
+  *(buffer++) = static_cast<uint8_t>(value);
+  return buffer;
+}
+
+/*!
+ * Reads varint from buffer
+ *
+ * \param position Position to read from (is advanced to after the varint)
+ * \param end End of buffer
+ * \param value Decoded value
+ * \return False if varint is truncated by end of buffer - or longer than cMAX_VARINT_SIZE bytes
+ */
+inline bool ReadVarint(const uint8_t*& position, const uint8_t* end, uint64_t& value)
+{
+  if (position < end && *position < 0x80)
+  {
+    value = *(position++);
+    return true;
+  }
+  value = 0;
+  for (int shift = 0; shift < 64 && position < end; shift += 7)
+  {
+    uint8_t byte = *(position++);
+    value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+    if (!(byte & 0x80))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+}
+
+//----------------------------------------------------------------------
+// End of namespace declaration
+//----------------------------------------------------------------------
+}
+}
+
+
+#endif